@@ -5,12 +5,11 @@
 #include "ES_Types.h"
 #include "ES_Events.h"
 
+// switching the XBee link from XBEE_DEFAULT_BAUD to XBEE_BAUD (UART.h)
+typedef enum { LinkAtDefault, AskedAtDefault, AskedAtLinkBaud, LinkAtLinkBaud } LinkState_t;
 
 bool InitComm_Service ( uint8_t Priority );
 bool PostComm_Service( ES_Event ThisEvent );
 ES_Event RunComm_Service( ES_Event ThisEvent );
 
-/***getter***/
-uint8_t* GetDataPacket_Tx (void);
-
 #endif 
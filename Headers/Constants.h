@@ -45,6 +45,8 @@
 #define API_IDENTIFIER_Rx         0x81
 #define API_IDENTIFIER_Tx_Result  0x89
 #define API_IDENTIFIER_Reset			0x8A
+#define API_IDENTIFIER_AT         0x08
+#define API_IDENTIFIER_AT_Result  0x88
 #define START_DELIMITER 					0x7E
 #define OPTIONS										0x00
 
@@ -73,6 +75,8 @@
 #define API_IDENT_BYTE_INDEX_RX   0
 #define FRAME_ID_BYTE_INDEX_RX		1
 #define TX_STATUS_BYTE_INDEX			2
+#define AT_COMMAND_BYTE_INDEX_RX  2
+#define AT_STATUS_BYTE_INDEX_RX   4
 
 #define SOURCE_ADDRESS_MSB_INDEX  1
 #define SOURCE_ADDRESS_LSB_INDEX  2
@@ -111,6 +115,7 @@
 #define INTER_MESSAGE_TIME				300	// FARMER transmits a packet every 300 ms 
 #define LOST_COMM_TIME						3*ONE_SEC // DOG+FARMER unpair if no message received after 1 second
 #define WAG_TIME									ONE_SEC
+#define LINK_TIME									200	// for the XBee to answer an AT command
 
 //Interrupts
 #define PRIORITY_0 								0
@@ -5,13 +5,17 @@
 #include "ES_Types.h"
 #include "ES_Events.h"
 
-typedef enum {Waiting2Pair, Paired_Waiting4Key, Paired  } DOGState_t ;
+// Connected is the superstate of the two paired states, so GetDOGState
+// never returns it
+typedef enum {Waiting2Pair, Paired_Waiting4Key, Paired, Connected } DOGState_t ;
 
 
 bool InitDOG_SM ( uint8_t Priority );
 bool PostDOG_SM( ES_Event ThisEvent );
 ES_Event RunDOG_SM( ES_Event ThisEvent );
-uint8_t GetHeader(void);
+void DOG_QueueOverflow( uint8_t WhichService, ES_Event ThisEvent );
+uint8_t GetHeader(const uint8_t* pPacket);
+void DecryptCommand(uint8_t* pPacket);
 void ResetEncryptionKeyIndex(void);
 void TransmitResetEncryption(void);
 
@@ -0,0 +1,32 @@
+/****************************************************************************
+ 
+  Header file for the Events & Services dispatch benchmarks
+  based on the Gen 2 Events and Services Framework
+
+ ****************************************************************************/
+
+#ifndef ES_Bench_H
+#define ES_Bench_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+
+// Public Function Prototypes
+
+bool InitBenchService ( uint8_t Priority );
+ES_Event RunBenchService( ES_Event ThisEvent );
+
+// the response function for all of the timers in the benchmark build
+bool PostBenchTimer( ES_Event ThisEvent );
+
+// the event checkers for the benchmark build: one called every time round,
+// one every BENCH_CHECK_PERIOD ticks, one only when the Timer5A interrupt
+// has armed it and one when armed but no more often than every
+// BENCH_ARMED_CHECK_PERIOD ticks. None of them ever finds an event
+bool Check4BenchEvents(void);
+bool Check4BenchPeriodic(void);
+bool Check4BenchArmed(void);
+bool Check4BenchArmedPeriodic(void);
+
+#endif /* ES_Bench_H */
+
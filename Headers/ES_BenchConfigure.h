@@ -0,0 +1,212 @@
+/****************************************************************************
+ Module
+     ES_BenchConfigure.h
+ Description
+     Framework configuration for the dispatch benchmarks in ES_Bench.c.
+     ES_Configure.h pulls this in instead of the DOG configuration when
+     ES_BENCH is defined.
+ Notes
+     Every service runs RunBenchService. The number of services and the
+     queue size can be overridden from the command line with
+     BENCH_NUM_SERVICES and BENCH_QUEUE_SIZE, BENCH_SPSC switches all of
+     them to the lock-free SPSC queue and BENCH_PREEMPTIVE turns on
+     ES_PREEMPTIVE.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               added the armed periodic event checker
+ 10/17/26               added the periodic and armed event checkers
+ 10/17/26               added the events of the state machine benchmarks
+ 10/17/26               EVENT_CHECK_LIST entries are ES_CHECKER
+ 10/17/26               the services and timers are listed in
+                        ES_SERVICE_LIST & ES_TIMER_LIST, for up to 32
+                        services
+ 10/17/26               added BENCH_PREEMPTIVE
+ 10/17/26               added the ES_POOLn settings, removed ES_BUFFER_SIZE
+ 10/17/26               added ES_NUM_BUFFERS & ES_BUFFER_SIZE
+ 10/17/26               all 64 timers post to PostBenchTimer
+ 10/17/26               added BENCH_SPSC
+ 10/17/26               started coding
+*****************************************************************************/
+
+#ifndef BENCH_CONFIGURE_H
+#define BENCH_CONFIGURE_H
+
+/****************************************************************************/
+#define MAX_NUM_SERVICES 32
+
+#ifndef BENCH_NUM_SERVICES
+#define BENCH_NUM_SERVICES 32
+#endif
+
+// big enough to hold the deepest burst that the benchmarks post
+#ifndef BENCH_QUEUE_SIZE
+#define BENCH_QUEUE_SIZE 16
+#endif
+
+// with BENCH_PREEMPTIVE defined the services preempt each other
+#ifdef BENCH_PREEMPTIVE
+#define ES_PREEMPTIVE
+#endif
+
+/****************************************************************************/
+// the benchmarks do not use the pools or the packet buffers, but the
+// framework needs them
+#define ES_NUM_POOLS 1
+#define ES_POOL0_BLOCK_SIZE 16
+#define ES_POOL0_NUM_BLOCKS 4
+#define ES_NUM_BUFFERS 4
+
+/****************************************************************************/
+// all of the services are the same benchmark service. BENCH_SERVICES_n lists
+// the first n of them, and ES_SERVICE_LIST the first BENCH_NUM_SERVICES
+// (which has to be a plain number for that). With BENCH_SPSC defined every
+// service uses the lock-free SPSC queue
+#ifdef BENCH_SPSC
+#define BENCH_QUEUE_SPSC true
+#else
+#define BENCH_QUEUE_SPSC false
+#endif
+#define BENCH_SERVICE(S, Name) \
+  S( Name, InitBenchService, RunBenchService, BENCH_QUEUE_SIZE, \
+     BENCH_QUEUE_SPSC, 0 )
+#define BENCH_SERVICES_1(S) BENCH_SERVICE(S, Bench0)
+#define BENCH_SERVICES_2(S) BENCH_SERVICES_1(S) BENCH_SERVICE(S, Bench1)
+#define BENCH_SERVICES_3(S) BENCH_SERVICES_2(S) BENCH_SERVICE(S, Bench2)
+#define BENCH_SERVICES_4(S) BENCH_SERVICES_3(S) BENCH_SERVICE(S, Bench3)
+#define BENCH_SERVICES_5(S) BENCH_SERVICES_4(S) BENCH_SERVICE(S, Bench4)
+#define BENCH_SERVICES_6(S) BENCH_SERVICES_5(S) BENCH_SERVICE(S, Bench5)
+#define BENCH_SERVICES_7(S) BENCH_SERVICES_6(S) BENCH_SERVICE(S, Bench6)
+#define BENCH_SERVICES_8(S) BENCH_SERVICES_7(S) BENCH_SERVICE(S, Bench7)
+#define BENCH_SERVICES_9(S) BENCH_SERVICES_8(S) BENCH_SERVICE(S, Bench8)
+#define BENCH_SERVICES_10(S) BENCH_SERVICES_9(S) BENCH_SERVICE(S, Bench9)
+#define BENCH_SERVICES_11(S) BENCH_SERVICES_10(S) BENCH_SERVICE(S, Bench10)
+#define BENCH_SERVICES_12(S) BENCH_SERVICES_11(S) BENCH_SERVICE(S, Bench11)
+#define BENCH_SERVICES_13(S) BENCH_SERVICES_12(S) BENCH_SERVICE(S, Bench12)
+#define BENCH_SERVICES_14(S) BENCH_SERVICES_13(S) BENCH_SERVICE(S, Bench13)
+#define BENCH_SERVICES_15(S) BENCH_SERVICES_14(S) BENCH_SERVICE(S, Bench14)
+#define BENCH_SERVICES_16(S) BENCH_SERVICES_15(S) BENCH_SERVICE(S, Bench15)
+#define BENCH_SERVICES_17(S) BENCH_SERVICES_16(S) BENCH_SERVICE(S, Bench16)
+#define BENCH_SERVICES_18(S) BENCH_SERVICES_17(S) BENCH_SERVICE(S, Bench17)
+#define BENCH_SERVICES_19(S) BENCH_SERVICES_18(S) BENCH_SERVICE(S, Bench18)
+#define BENCH_SERVICES_20(S) BENCH_SERVICES_19(S) BENCH_SERVICE(S, Bench19)
+#define BENCH_SERVICES_21(S) BENCH_SERVICES_20(S) BENCH_SERVICE(S, Bench20)
+#define BENCH_SERVICES_22(S) BENCH_SERVICES_21(S) BENCH_SERVICE(S, Bench21)
+#define BENCH_SERVICES_23(S) BENCH_SERVICES_22(S) BENCH_SERVICE(S, Bench22)
+#define BENCH_SERVICES_24(S) BENCH_SERVICES_23(S) BENCH_SERVICE(S, Bench23)
+#define BENCH_SERVICES_25(S) BENCH_SERVICES_24(S) BENCH_SERVICE(S, Bench24)
+#define BENCH_SERVICES_26(S) BENCH_SERVICES_25(S) BENCH_SERVICE(S, Bench25)
+#define BENCH_SERVICES_27(S) BENCH_SERVICES_26(S) BENCH_SERVICE(S, Bench26)
+#define BENCH_SERVICES_28(S) BENCH_SERVICES_27(S) BENCH_SERVICE(S, Bench27)
+#define BENCH_SERVICES_29(S) BENCH_SERVICES_28(S) BENCH_SERVICE(S, Bench28)
+#define BENCH_SERVICES_30(S) BENCH_SERVICES_29(S) BENCH_SERVICE(S, Bench29)
+#define BENCH_SERVICES_31(S) BENCH_SERVICES_30(S) BENCH_SERVICE(S, Bench30)
+#define BENCH_SERVICES_32(S) BENCH_SERVICES_31(S) BENCH_SERVICE(S, Bench31)
+#define BENCH_SERVICES(n) BENCH_SERVICES_N(n)
+#define BENCH_SERVICES_N(n) BENCH_SERVICES_##n
+#define ES_SERVICE_LIST(ES_SERVICE) \
+  BENCH_SERVICES(BENCH_NUM_SERVICES)(ES_SERVICE)
+
+/****************************************************************************/
+// Name/define the events of interest
+// Universal events occupy the lowest entries, followed by user-defined events
+typedef enum {  ES_NO_EVENT = 0,
+                ES_ERROR,  /* used to indicate an error from the service */
+                ES_INIT,   /* used to transition from initial pseudo-state */
+                ES_TIMEOUT, /* signals that the timer has expired */
+                ES_SHORT_TIMEOUT, /* signals that a short timer has expired */
+                /* User-defined events start here */
+                ES_BENCH_EVENT, /* the event that the benchmarks post */
+                /* the state machine benchmarks, after DOG_SM */
+                ES_BENCH_PAIR, ES_BENCH_KEY, ES_BENCH_CMD, ES_BENCH_UNPAIR
+} ES_EventTyp_t ;
+
+/****************************************************************************/
+// no distribution lists in the benchmark build
+#define NUM_DIST_LISTS 0
+
+/****************************************************************************/
+// This are the name of the Event checking funcion header file. 
+#define EVENT_CHECK_HEADER "ES_Bench.h"
+
+/****************************************************************************/
+// This is the list of event checking functions: one called every time
+// round, one that is rate limited, one armed by the Timer5A interrupt and
+// one that is both, for the event checker benchmark
+#define BENCH_CHECK_PERIOD 5
+#define BENCH_ARMED_CHECK_PERIOD 2
+#define EVENT_CHECK_LIST(ES_CHECKER) \
+  ES_CHECKER( Check4BenchEvents, 0, false ) \
+  ES_CHECKER( Check4BenchPeriodic, BENCH_CHECK_PERIOD, false ) \
+  ES_CHECKER( Check4BenchArmed, 0, true ) \
+  ES_CHECKER( Check4BenchArmedPeriodic, BENCH_ARMED_CHECK_PERIOD, true )
+
+/****************************************************************************/
+// every timer is wired to PostBenchTimer for the timer benchmarks
+#define ES_TIMER_LIST(ES_TIMER) \
+  ES_TIMER( BENCH_TIMER0, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER1, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER2, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER3, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER4, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER5, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER6, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER7, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER8, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER9, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER10, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER11, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER12, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER13, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER14, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER15, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER16, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER17, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER18, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER19, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER20, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER21, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER22, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER23, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER24, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER25, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER26, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER27, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER28, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER29, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER30, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER31, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER32, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER33, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER34, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER35, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER36, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER37, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER38, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER39, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER40, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER41, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER42, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER43, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER44, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER45, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER46, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER47, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER48, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER49, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER50, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER51, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER52, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER53, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER54, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER55, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER56, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER57, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER58, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER59, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER60, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER61, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER62, PostBenchTimer ) \
+  ES_TIMER( BENCH_TIMER63, PostBenchTimer )
+
+#endif /* BENCH_CONFIGURE_H */
@@ -0,0 +1,34 @@
+/****************************************************************************
+ Module
+     ES_Buffer.h
+ Description
+     header file for the reference counted packet buffers of the Events &
+     Services Framework
+ Notes
+     An event carries a buffer by handle in its Buffer field. There are
+     ES_NUM_BUFFERS handles (ES_Configure.h), and the memory of each buffer
+     comes from the ES_Pool pools.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                ES_BufAlloc takes the size needed
+ 10/17/26                started coding
+*****************************************************************************/
+#ifndef ES_Buffer_H
+#define ES_Buffer_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+/* prototypes for public functions */
+
+void ES_InitBuffers( void );
+ES_BufHandle_t ES_BufAlloc( uint16_t Size );
+bool ES_BufRetain( ES_BufHandle_t Buffer );
+void ES_BufRelease( ES_BufHandle_t Buffer );
+uint8_t * ES_BufData( ES_BufHandle_t Buffer );
+uint8_t ES_BufNumFree( void );
+
+#endif /* ES_Buffer_H */
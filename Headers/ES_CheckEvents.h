@@ -9,6 +9,9 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                added ES_CheckersPending
+ 10/17/26                added the checker numbers, ES_ArmEventChecker and
+                         ES_GetTicksToNextCheck
  08/05/13 15:19 jec      modifications to suit new portable type definitions
  01/15/12 12:00 jec      new header for local types
  10/16/11 17:17 jec      started coding
@@ -17,13 +20,23 @@
 #ifndef ES_CheckEvents_H
 #define ES_CheckEvents_H
 
+#include "ES_Configure.h"
 #include "ES_Types.h"
 
 typedef bool CheckFunc( void );
 
 typedef CheckFunc (*pCheckFunc);
 
+// the checker numbers, CHECK_Function after EVENT_CHECK_LIST (ES_Configure.h)
+#define ES_CHECKER_NUMBER(Function, PeriodTicks, Armed) CHECK_##Function,
+typedef enum { EVENT_CHECK_LIST(ES_CHECKER_NUMBER)
+               ES_NUM_CHECKERS
+} ES_CheckerNum_t;
+
 bool ES_CheckUserEvents( void );
+void ES_ArmEventChecker( uint8_t WhichChecker );
+bool ES_CheckersPending( void );
+uint32_t ES_GetTicksToNextCheck( void );
 
 
 #endif  // ES_CheckEvents_H
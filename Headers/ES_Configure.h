@@ -9,6 +9,29 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26               added ES_OVERFLOW_POLICIES and ES_OVERFLOW_HANDLER
+ 10/17/26               EVENT_CHECK_LIST gives each checker a period and
+                        whether it has to be armed
+ 10/17/26               the distribution lists name services, for the
+                        ES_DIST_MASKn bit masks
+ 10/17/26               added ES_TRACE_INPUTS
+ 10/17/26               added ES_TRACE_SIZE, ES_TRACE_DRAIN and
+                        ES_TRACE_POINTS
+ 10/17/26               the services and timers are now listed in
+                        ES_SERVICE_LIST & ES_TIMER_LIST, which NUM_SERVICES
+                        and the timer numbers are taken from, and
+                        MAX_NUM_SERVICES is now 32
+ 10/17/26               added the run function budgets (ES_RUN_BUDGETS,
+                        SERV_x_BUDGET_US) and ES_WATCHDOG_MS
+ 10/17/26               added the ES_PREEMPTIVE switch
+ 10/17/26               added ES_QUEUE_POLICIES
+ 10/17/26               added the ES_POOLn settings, removed ES_BUFFER_SIZE
+ 10/17/26               added ES_NUM_BUFFERS & ES_BUFFER_SIZE
+ 10/17/26               added the ES_TICKLESS switch
+ 10/17/26               noted that the Ready variable is now 32 bits
+ 10/17/26               documented SERV_x_QUEUE_SPSC
+ 10/17/26               added the ES_SERVICE_STATS switch
+ 10/17/26               select ES_BenchConfigure.h when building ES_BENCH
   10/11/15 18:00 jec      added new event type ES_SHORT_TIMEOUT
   10/21/13 20:54 jec      lots of added entries to bring the number of timers
                          and services up to 16 each
@@ -21,232 +44,141 @@
 #ifndef CONFIGURE_H
 #define CONFIGURE_H
 
-/****************************************************************************/
-// The maximum number of services sets an upper bound on the number of 
-// services that the framework will handle. Reasonable values are 8 and 16
-// corresponding to an 8-bit(uint8_t) and 16-bit(uint16_t) Ready variable size
-#define MAX_NUM_SERVICES 16
-
-/****************************************************************************/
-// This macro determines that nuber of services that are *actually* used in
-// a particular application. It will vary in value from 1 to MAX_NUM_SERVICES
-#define NUM_SERVICES 8
-
-/****************************************************************************/
-// These are the definitions for Service 0, the lowest priority service.
-// Every Events and Services application must have a Service 0. Further 
-// services are added in numeric sequence (1,2,3,...) with increasing 
-// priorities
-// the header file with the public function prototypes
-#define SERV_0_HEADER "IMU_Service.h"
-// the name of the Init function
-#define SERV_0_INIT InitIMU_Service
-// the name of the run function
-#define SERV_0_RUN RunIMU_Service
-// How big should this services Queue be?
-#define SERV_0_QUEUE_SIZE 5
+// the dispatch benchmarks (ES_Bench.c) bring their own service table
+#ifdef ES_BENCH
+#include "ES_BenchConfigure.h"
+#else
 
 /****************************************************************************/
-// The following sections are used to define the parameters for each of the
-// services. You only need to fill out as many as the number of services 
-// defined by NUM_SERVICES
-/****************************************************************************/
-// These are the definitions for Service 1
-#if NUM_SERVICES > 1
-// the header file with the public function prototypes
-#define SERV_1_HEADER "Receive_SM.h"
-// the name of the Init function
-#define SERV_1_INIT InitReceive_SM
-// the name of the run function
-#define SERV_1_RUN RunReceive_SM
-// How big should this services Queue be?
-#define SERV_1_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 2
-#if NUM_SERVICES > 2
-// the header file with the public function prototypes
-#define SERV_2_HEADER "Comm_Service.h"
-// the name of the Init function
-#define SERV_2_INIT InitComm_Service
-// the name of the run function
-#define SERV_2_RUN RunComm_Service
-// How big should this services Queue be?
-#define SERV_2_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 3
-#if NUM_SERVICES > 3
-// the header file with the public function prototypes
-
-#define SERV_3_HEADER "Transmit_SM.h"
-// the name of the Init function
-#define SERV_3_INIT InitTransmit_SM
-// the name of the run function
-#define SERV_3_RUN RunTransmit_SM
-
-// How big should this services Queue be?
-#define SERV_3_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 4
-#if NUM_SERVICES > 4
-// the header file with the public function prototypes
-#define SERV_4_HEADER "DOG_SM.h"
-// the name of the Init function
-#define SERV_4_INIT InitDOG_SM
-// the name of the run function
-#define SERV_4_RUN RunDOG_SM
-// How big should this services Queue be?
-#define SERV_4_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 5
-#if NUM_SERVICES > 5
-// the header file with the public function prototypes
-#define SERV_5_HEADER "MapKeys.h"
-// the name of the Init function
-#define SERV_5_INIT InitMapKeys
-// the name of the run function
-#define SERV_5_RUN RunMapKeys
-// How big should this services Queue be?
-#define SERV_5_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 6
-#if NUM_SERVICES > 6
-// the header file with the public function prototypes
-#define SERV_6_HEADER "LiftFan_Service.h"
-// the name of the Init function
-#define SERV_6_INIT InitLiftFan_Service
-// the name of the run function
-#define SERV_6_RUN RunLiftFan_Service
-// How big should this services Queue be?
-#define SERV_6_QUEUE_SIZE 3
-#endif
+// The maximum number of services sets an upper bound on the number of 
+// services that the framework will handle. The Ready variable is 32 bits
+// (uint32_t), so up to 32 services are possible
+#define MAX_NUM_SERVICES 32
 
 /****************************************************************************/
-// These are the definitions for Service 7
-#if NUM_SERVICES > 7
-// the header file with the public function prototypes
-#define SERV_7_HEADER "DogTail_Service.h"
-// the name of the Init function
-#define SERV_7_INIT InitDogTail_Service
-// the name of the run function
-#define SERV_7_RUN RunDogTail_Service
-// How big should this services Queue be?
-#define SERV_7_QUEUE_SIZE 3
-#endif
+// With ES_SERVICE_STATS defined the framework keeps, for each service, the
+// dispatch count, min/avg/max run function time, queue high water mark and
+// number of rejected posts (see ES_Framework.h). Comment it out to remove
+// all of that code and data.
+#define ES_SERVICE_STATS
 
 /****************************************************************************/
-// These are the definitions for Service 8
-#if NUM_SERVICES > 8
-// the header file with the public function prototypes
-#define SERV_8_HEADER "TestHarnessService8.h"
-// the name of the Init function
-#define SERV_8_INIT InitTestHarnessService8
-// the name of the run function
-#define SERV_8_RUN RunTestHarnessService8
-// How big should this services Queue be?
-#define SERV_8_QUEUE_SIZE 3
-#endif
+// With ES_RUN_BUDGETS defined, each run function's time (measured for
+// ES_SERVICE_STATS, which it needs) is checked against the budget for its
+// service, BudgetUS in ES_SERVICE_LIST. A run that goes over is counted
+// as an overrun in the service statistics, along with the type of the event
+// that it was handling. Services without a budget are not checked: MapKeys
+// has none, as it prints the statistics tables.
+// ES_WATCHDOG_MS, if defined, starts the hardware watchdog, which is fed
+// before each run function and when ES_Run is idle, so that a run function
+// that keeps the CPU for longer than that resets the MCU. ES_OVERRUN_LIMIT,
+// if defined as well, is the number of overruns in a row after which a
+// service is treated as stuck and the watchdog is no longer fed. They are
+// left off while the services still printf at debug speed.
+#define ES_RUN_BUDGETS
+//#define ES_WATCHDOG_MS 250
+//#define ES_OVERRUN_LIMIT 20
 
 /****************************************************************************/
-// These are the definitions for Service 9
-#if NUM_SERVICES > 9
-// the header file with the public function prototypes
-#define SERV_9_HEADER "TestHarnessService9.h"
-// the name of the Init function
-#define SERV_9_INIT InitTestHarnessService9
-// the name of the run function
-#define SERV_9_RUN RunTestHarnessService9
-// How big should this services Queue be?
-#define SERV_9_QUEUE_SIZE 3
-#endif
+// With ES_TICKLESS defined, ES_Run puts the CPU to sleep (WFI) whenever every
+// queue is empty and the event checkers found nothing, and instead of
+// interrupting every tick SysTick is stretched out to the next timer
+// deadline, or to when the next periodic event checker is due
+// (EVENT_CHECK_LIST). ES_TICKLESS_MAX_TICKS bounds each sleep as well.
+#define ES_TICKLESS
+#define ES_TICKLESS_MAX_TICKS 50
 
 /****************************************************************************/
-// These are the definitions for Service 10
-#if NUM_SERVICES > 10
-// the header file with the public function prototypes
-#define SERV_10_HEADER "TestHarnessService10.h"
-// the name of the Init function
-#define SERV_10_INIT InitTestHarnessService10
-// the name of the run function
-#define SERV_10_RUN RunTestHarnessService10
-// How big should this services Queue be?
-#define SERV_10_QUEUE_SIZE 3
-#endif
+// With ES_PREEMPTIVE defined, a post to a service of higher priority than the
+// one whose run function is running gets that service run straight away
+// (from PendSV, see ES_Preempt in ES_Framework.c) instead of when the current
+// run function returns. Run functions still run to completion, all on the one
+// stack (which then has to hold a run function for each level of preemption),
+// but anything that a service shares with a service of lower priority (or
+// with the printf console) has to be protected with EnterCritical and
+// ExitCritical. The DOG services were written for cooperative scheduling and
+// do not do that, so it is left off.
+//#define ES_PREEMPTIVE
 
 /****************************************************************************/
-// These are the definitions for Service 11
-#if NUM_SERVICES > 11
-// the header file with the public function prototypes
-#define SERV_11_HEADER "TestHarnessService11.h"
-// the name of the Init function
-#define SERV_11_INIT InitTestHarnessService11
-// the name of the run function
-#define SERV_11_RUN RunTestHarnessService11
-// How big should this services Queue be?
-#define SERV_11_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 12
-#if NUM_SERVICES > 12
-// the header file with the public function prototypes
-#define SERV_12_HEADER "TestHarnessService12.h"
-// the name of the Init function
-#define SERV_12_INIT InitTestHarnessService12
-// the name of the run function
-#define SERV_12_RUN RunTestHarnessService12
-// How big should this services Queue be?
-#define SERV_12_QUEUE_SIZE 3
-#endif
+// With ES_TRACE_SIZE defined the framework keeps a binary trace (ES_Trace.c)
+// of the last ES_TRACE_SIZE (a power of 2) posts, run function starts and
+// ends, interrupt responses, timer expiries and trace points, 8 bytes each.
+// The 'T' key sends it to the console for Host/TraceDecoder.c. With
+// ES_TRACE_DRAIN defined as well, ES_Run sends the records as they are made,
+// whenever it is idle, and stays awake until they are out. That mixes
+// binary frames into the console output, so it is left off.
+// ES_TRACE_INPUTS turns the trace into a recording of what the interrupts
+// brought in (the bytes UART4 received, SSI1 EOTs, ticks and short timer
+// time-outs) from start up on, for HostSim to replay (DOG_REPLAY, see
+// Host/HostSim.c). Nothing else is recorded and nothing is overwritten: once
+// the ring is full the rest are counted as lost, so use it with
+// ES_TRACE_DRAIN and a console fast enough to keep up.
+// ES_TRACE_POINTS names the application's trace points (ES_TracePoint), one
+// ES_TRACE_POINT( Name ) each:
+//   TRACE_DOG_STATE  DOG_SM's state on each event
+//   TRACE_API_IDENT  the API identifier of each XBee frame received
+//   TRACE_RX_DROPPED the length of a received XBee frame that there was no
+//                    packet buffer for
+#define ES_TRACE_SIZE 128
+//#define ES_TRACE_DRAIN
+//#define ES_TRACE_INPUTS
+#define ES_TRACE_POINTS(ES_TRACE_POINT) \
+  ES_TRACE_POINT( TRACE_DOG_STATE ) \
+  ES_TRACE_POINT( TRACE_API_IDENT ) \
+  ES_TRACE_POINT( TRACE_RX_DROPPED )
 
 /****************************************************************************/
-// These are the definitions for Service 13
-#if NUM_SERVICES > 13
-// the header file with the public function prototypes
-#define SERV_13_HEADER "TestHarnessService13.h"
-// the name of the Init function
-#define SERV_13_INIT InitTestHarnessService13
-// the name of the run function
-#define SERV_13_RUN RunTestHarnessService13
-// How big should this services Queue be?
-#define SERV_13_QUEUE_SIZE 3
-#endif
+// The fixed block memory pools (ES_Pool.c). There are ES_NUM_POOLS (1 to 4)
+// pools, pool n has ES_POOLn_NUM_BLOCKS blocks of ES_POOLn_BLOCK_SIZE bytes,
+// and the block sizes must go up from one pool to the next. A request takes
+// a block from the smallest pool that can hold it. Set the number of blocks
+// from the high water marks that ES_PoolPrintStats reports.
+// Pool 0 holds the short XBee frames: the ACK and reset frames we send, and
+// the pair requests and transmit status frames we receive. Pool 1 holds the
+// rest, up to MAX_PACKET_LENGTH (Constants.h)
+#define ES_NUM_POOLS 2
+#define ES_POOL0_BLOCK_SIZE 16
+#define ES_POOL0_NUM_BLOCKS 6
+#define ES_POOL1_BLOCK_SIZE 48
+#define ES_POOL1_NUM_BLOCKS 4
 
 /****************************************************************************/
-// These are the definitions for Service 14
-#if NUM_SERVICES > 14
-// the header file with the public function prototypes
-#define SERV_14_HEADER "TestHarnessService14.h"
-// the name of the Init function
-#define SERV_14_INIT InitTestHarnessService14
-// the name of the run function
-#define SERV_14_RUN RunTestHarnessService14
-// How big should this services Queue be?
-#define SERV_14_QUEUE_SIZE 3
-#endif
+// The number of packet buffers that events can carry (ES_Buffer.c). The
+// memory of each buffer comes from the pools, so this only needs to cover
+// the buffers of all sizes that can be in use at the same time
+#define ES_NUM_BUFFERS 8
 
 /****************************************************************************/
-// These are the definitions for Service 15
-#if NUM_SERVICES > 15
-// the header file with the public function prototypes
-#define SERV_15_HEADER "TestHarnessService15.h"
-// the name of the Init function
-#define SERV_15_INIT InitTestHarnessService15
-// the name of the run function
-#define SERV_15_RUN RunTestHarnessService15
-// How big should this services Queue be?
-#define SERV_15_QUEUE_SIZE 3
-#endif
-
+// The services, one ES_SERVICE entry each, in priority order: the first is
+// service 0, the lowest priority, which every Events and Services
+// application must have. NUM_SERVICES is the number of entries, up to
+// MAX_NUM_SERVICES. The headers with the services' prototypes go in
+// ES_ServiceHeaders.h.
+//   ES_SERVICE( Name, InitFunc, RunFunc, QueueSize, SPSC, BudgetUS )
+// Name      makes the service's number (its priority) SERV_Name, for
+//           ES_QUEUE_POLICIES and anything else that needs it
+// QueueSize how many events its queue holds. Size the queues from the
+//           statistics with Host/QueueSizer.c: a queue that is too small
+//           drops events and one that is too big wastes RAM
+// SPSC      true for the lock-free single producer/single consumer queue
+//           (ES_EnQueueSPSC in ES_Queue.c). QueueSize must then be a power
+//           of 2 (up to 128), all of the service's events must come from a
+//           single source (one ISR, or only task level code) and it cannot
+//           take LIFO posts (ES_DeferRecall). None of the DOG services
+//           qualify yet: each one is posted to from both an ISR and task
+//           level, e.g. IMU_Service from SPI_ISR and from IMU_TIMER.
+// BudgetUS  the longest its run function should take, in uS, or 0 for no
+//           budget (ES_RUN_BUDGETS)
+#define ES_SERVICE_LIST(ES_SERVICE) \
+  ES_SERVICE( IMU_Service,     InitIMU_Service,     RunIMU_Service,     5, false,  200 ) \
+  ES_SERVICE( Receive_SM,      InitReceive_SM,      RunReceive_SM,      3, false,  100 ) \
+  ES_SERVICE( Comm_Service,    InitComm_Service,    RunComm_Service,    3, false,  500 ) \
+  ES_SERVICE( Transmit_SM,     InitTransmit_SM,     RunTransmit_SM,     3, false,  100 ) \
+  ES_SERVICE( DOG_SM,          InitDOG_SM,          RunDOG_SM,          3, false, 1000 ) \
+  ES_SERVICE( MapKeys,         InitMapKeys,         RunMapKeys,         3, false,    0 ) \
+  ES_SERVICE( LiftFan_Service, InitLiftFan_Service, RunLiftFan_Service, 3, false,  200 ) \
+  ES_SERVICE( DogTail_Service, InitDogTail_Service, RunDogTail_Service, 3, false,  200 )
 
 /****************************************************************************/
 // Name/define the events of interest
@@ -266,7 +198,9 @@ typedef enum {  ES_NO_EVENT = 0,
 								ES_NEW_CMD_RECEIVED, ES_ENCRYPTION_COUNTER_INCORRECT, 
 								ES_CONSTRUCT_DATAPACKET, ES_UNPAIR,
 								//Transmit_SM
-								ES_START_XMIT, ES_BYTE_SENT,
+								ES_START_XMIT, ES_BYTE_SENT, ES_FRAME_SENT,
+								//Comm_Service
+								ES_SET_XBEE_BAUD,
 								// Hover
 								ES_HOVER_ON, ES_HOVER_OFF,
 								ES_STOP_WAGGING, ES_START_WAGGING,
@@ -275,33 +209,74 @@ typedef enum {  ES_NO_EVENT = 0,
 } ES_EventTyp_t ;
 
 /****************************************************************************/
-// These are the definitions for the Distribution lists. Each definition
-// should be a comma separated list of post functions to indicate which
-// services are on that distribution list.
+// Queue policies for particular events posted to particular services, as
+// { service (SERV_Name), event type, policy } entries (see ES_EnQueuePolicy in
+// ES_Queue.c). Events that are not listed just go on the end of the queue.
+// Only services with ordinary (not SPSC) queues can have policies. Comment
+// ES_QUEUE_POLICIES out to remove the code.
+// DOG_SM only needs the latest command, the IMU can't have more than one
+// SPI transfer in flight, and a timeout that is already waiting says all
+// there is to say. In a burst of received frames the oldest received frame
+// is dropped instead of the newest (a dropped frame puts the encryption key
+// out of step whichever one it is). Only a frame is ever dropped for a
+// frame, so Comm_Service's other events (ES_CONSTRUCT_DATAPACKET,
+// ES_SET_XBEE_BAUD, LINK_TIMER timeouts) are never pushed out by them
+#define ES_QUEUE_POLICIES \
+  { SERV_IMU_Service,     ES_EOT,                 ES_QUEUE_MERGE }, \
+  { SERV_IMU_Service,     ES_TIMEOUT,             ES_QUEUE_MERGE }, \
+  { SERV_Comm_Service,    ES_DATAPACKET_RECEIVED, ES_QUEUE_DROP_OLDEST }, \
+  { SERV_DOG_SM,          ES_NEW_CMD_RECEIVED,    ES_QUEUE_LATEST }, \
+  { SERV_DOG_SM,          ES_TIMEOUT,             ES_QUEUE_MERGE }, \
+  { SERV_DogTail_Service, ES_TIMEOUT,             ES_QUEUE_MERGE }
+
+/****************************************************************************/
+// What a post does when it finds a service's queue full, one ES_OVERFLOW
+// entry for each service that is not to just reject it:
+//   ES_OVERFLOW( Name, Policy )
+// ES_OVERFLOW_REJECT      the post fails and the queue is left as it is
+// ES_OVERFLOW_DROP_OLDEST the oldest event is pushed out to make room (not
+//                         for SPSC queues)
+// ES_OVERFLOW_ESCALATE    the post fails and ES_OVERFLOW_HANDLER is called
+//                         with the service number and the event, from
+//                         whatever posted it, often an interrupt response
+// The service statistics count each (RejectedPosts, Overwritten,
+// Escalated). Comment ES_OVERFLOW_POLICIES out to remove the code.
+// Most posts (UART_ISR, SPI_ISR, the timers) can't do anything about a
+// failure, so a timeout lost by DOG_SM, LOST_COMM_TIMER above all, goes to
+// DOG_QueueOverflow, which lands the craft and retries the timeout.
+#define ES_OVERFLOW_POLICIES(ES_OVERFLOW) \
+  ES_OVERFLOW( DOG_SM, ES_OVERFLOW_ESCALATE )
+#define ES_OVERFLOW_HANDLER DOG_QueueOverflow
+
+/****************************************************************************/
+// These are the definitions for the Distribution lists. Each one lists the
+// services on it, by their names in ES_SERVICE_LIST, one
+// ES_SUBSCRIBER( Name ) each. ES_PostList.h turns each list into a bit mask
+// of the services (ES_DIST_MASKn) at compile time.
 #define NUM_DIST_LISTS 1
 #if NUM_DIST_LISTS > 0 
-#define DIST_LIST0 PostIMU_Service
+#define DIST_LIST0(ES_SUBSCRIBER) ES_SUBSCRIBER( IMU_Service )
 #endif
 #if NUM_DIST_LISTS > 1 
-#define DIST_LIST1 PostTestHarnessService1, PostTestHarnessService1
+#define DIST_LIST1(ES_SUBSCRIBER) ES_SUBSCRIBER( TestHarnessService1 )
 #endif
 #if NUM_DIST_LISTS > 2 
-#define DIST_LIST2 PostTemplateFSM
+#define DIST_LIST2(ES_SUBSCRIBER) ES_SUBSCRIBER( TemplateFSM )
 #endif
 #if NUM_DIST_LISTS > 3 
-#define DIST_LIST3 PostTemplateFSM
+#define DIST_LIST3(ES_SUBSCRIBER) ES_SUBSCRIBER( TemplateFSM )
 #endif
 #if NUM_DIST_LISTS > 4 
-#define DIST_LIST4 PostTemplateFSM
+#define DIST_LIST4(ES_SUBSCRIBER) ES_SUBSCRIBER( TemplateFSM )
 #endif
 #if NUM_DIST_LISTS > 5 
-#define DIST_LIST5 PostTemplateFSM
+#define DIST_LIST5(ES_SUBSCRIBER) ES_SUBSCRIBER( TemplateFSM )
 #endif
 #if NUM_DIST_LISTS > 6 
-#define DIST_LIST6 PostTemplateFSM
+#define DIST_LIST6(ES_SUBSCRIBER) ES_SUBSCRIBER( TemplateFSM )
 #endif
 #if NUM_DIST_LISTS > 7 
-#define DIST_LIST7 PostTemplateFSM
+#define DIST_LIST7(ES_SUBSCRIBER) ES_SUBSCRIBER( TemplateFSM )
 #endif
 
 /****************************************************************************/
@@ -309,46 +284,34 @@ typedef enum {  ES_NO_EVENT = 0,
 #define EVENT_CHECK_HEADER "EventCheckers.h"
 
 /****************************************************************************/
-// This is the list of event checking functions 
-#define EVENT_CHECK_LIST Check4Keystroke
+// The event checking functions, one ES_CHECKER entry each:
+//   ES_CHECKER( Function, PeriodTicks, Armed )
+// ES_CheckUserEvents calls a checker no more often than once every
+// PeriodTicks ticks (0 for every time the queues are empty) and, if Armed is
+// true, only after ES_ArmEventChecker( CHECK_Function ) has been called,
+// normally from the interrupt response that brings in what it looks for.
+// With ES_TICKLESS the periodic checkers also limit how long the idle sleeps,
+// so the keyboard is checked every 50 ticks, as often as the longest sleep
+// (ES_TICKLESS_MAX_TICKS) already woke the CPU.
+#define EVENT_CHECK_LIST(ES_CHECKER) \
+  ES_CHECKER( Check4Keystroke, 50, false )
 
 /****************************************************************************/
-// These are the definitions for the post functions to be executed when the
-// corresponding timer expires. All 16 must be defined. If you are not using
-// a timer, then you should use TIMER_UNUSED
-// Unlike services, any combination of timers may be used and there is no
-// priority in servicing them
-#define TIMER_UNUSED ((pPostFunc)0)
-#define TIMER0_RESP_FUNC PostReceive_SM
-#define TIMER1_RESP_FUNC PostDOG_SM
-#define TIMER2_RESP_FUNC PostTransmit_SM
-#define TIMER3_RESP_FUNC PostDOG_SM
-#define TIMER4_RESP_FUNC PostDogTail_Service
-#define TIMER5_RESP_FUNC PostIMU_Service
-#define TIMER6_RESP_FUNC TIMER_UNUSED
-#define TIMER7_RESP_FUNC TIMER_UNUSED
-#define TIMER8_RESP_FUNC TIMER_UNUSED
-#define TIMER9_RESP_FUNC TIMER_UNUSED
-#define TIMER10_RESP_FUNC TIMER_UNUSED
-#define TIMER11_RESP_FUNC TIMER_UNUSED
-#define TIMER12_RESP_FUNC TIMER_UNUSED
-#define TIMER13_RESP_FUNC TIMER_UNUSED
-#define TIMER14_RESP_FUNC TIMER_UNUSED
-#define TIMER15_RESP_FUNC TIMER_UNUSED
-
-/****************************************************************************/
-// Give the timer numbers symbolc names to make it easier to move them
-// to different timers if the need arises. Keep these definitions close to the
-// definitions for the response functions to make it easier to check that
-// the timer number matches where the timer event will be routed
-// These symbolic names should be changed to be relevant to your application 
-
-#define RECEIVE_TIMER 0
-#define GameTimer 1
-#define TRANSMIT_TIMER 2
-#define LOST_COMM_TIMER 3
-#define WAG_TIMER	4
-#define IMU_TIMER 5
+// The timers, one ES_TIMER entry each. A timer's number, counting from 0 in
+// the order listed, is given the name in its entry, and its ES_TIMEOUT
+// events go to the post function in its entry. Timers that are not listed
+// (up to ES_NUM_TIMERS) are unused, and as with services there is no
+// priority in servicing them.
+//   ES_TIMER( Name, RespFunc )
+#define ES_TIMER_LIST(ES_TIMER) \
+  ES_TIMER( RECEIVE_TIMER,   PostReceive_SM ) \
+  ES_TIMER( GameTimer,       PostDOG_SM ) \
+  ES_TIMER( TRANSMIT_TIMER,  PostTransmit_SM ) \
+  ES_TIMER( LOST_COMM_TIMER, PostDOG_SM ) \
+  ES_TIMER( WAG_TIMER,       PostDogTail_Service ) \
+  ES_TIMER( IMU_TIMER,       PostIMU_Service ) \
+  ES_TIMER( LINK_TIMER,      PostComm_Service )
 
+#endif /* ES_BENCH */
 
 #endif /* CONFIGURE_H */
@@ -8,6 +8,7 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                added the Buffer handle
  08/05/13 15:19 jec      modifications to suit new portable type definitions
  01/15/12 11:46 jec      moved event enum to config file, changed prefixes to ES
  10/23/11 22:01 jec      customized for Remote Lock problem
@@ -20,8 +21,13 @@
 
 #include "ES_Types.h"
 
+// handle of a packet buffer from ES_Buffer.c
+typedef uint8_t ES_BufHandle_t;
+#define ES_NO_BUFFER 0
+
 typedef struct ES_Event_t {
     ES_EventTyp_t EventType;    // what kind of event?
+    ES_BufHandle_t Buffer;      // packet buffer that goes with it, if any
     uint16_t   EventParam;      // parameter value for use w/ this event
 }ES_Event;
 
@@ -8,6 +8,21 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                added ES_OverflowPolicy_t, and Overwritten and
+                         Escalated to ES_ServiceStats_t
+ 10/17/26                added ES_Multicast
+ 10/17/26                added ES_PostBatch, ES_PostMulti and
+                         ES_BeginPostBatch/ES_EndPostBatch
+ 10/17/26                include ES_Trace.h
+ 10/17/26                added Needed to ES_ServiceStats_t
+ 10/17/26                the service numbers & NUM_SERVICES come from
+                         ES_SERVICE_LIST
+ 10/17/26                added the budget and overruns to ES_ServiceStats_t
+ 10/17/26                added ES_Preempt (ES_PREEMPTIVE)
+ 10/17/26                added Coalesced to ES_ServiceStats_t
+ 10/17/26                include ES_Pool.h
+ 10/17/26                added ES_PostWithBuffer
+ 10/17/26                added the service statistics (ES_SERVICE_STATS)
  11/02/13 17:06 jec      added ES_PostToServiceLIFO prototype
  08/05/13 15:00 jec      added #include for ES_Port.h to get portability stuff
  10/17/06 07:41 jec      started coding
@@ -23,6 +38,17 @@
 #include "ES_PostList.h"
 #include "ES_Events.h"
 #include "ES_Timers.h"
+#include "ES_Pool.h"
+#include "ES_Buffer.h"
+#include "ES_Trace.h"
+
+// the service numbers (priorities), named SERV_Name after ES_SERVICE_LIST
+// (ES_Configure.h), and the number of services
+#define ES_SERVICE_NUMBER(Name, InitFunc, RunFunc, QueueSize, SPSC, BudgetUS) \
+  SERV_##Name,
+typedef enum { ES_SERVICE_LIST(ES_SERVICE_NUMBER)
+               NUM_SERVICES
+} ES_ServiceNum_t;
 
 typedef enum {
               Success = 0,
@@ -33,10 +59,74 @@ typedef enum {
               FailedInit
 } ES_Return_t;
 
+// what a post does when it finds a service's queue full, set for each
+// service in ES_OVERFLOW_POLICIES (ES_Configure.h)
+typedef enum {
+              ES_OVERFLOW_REJECT = 0,  // the post fails, the default
+              ES_OVERFLOW_DROP_OLDEST, // the oldest event is pushed out
+              ES_OVERFLOW_ESCALATE     // the post fails and is reported to
+                                       // ES_OVERFLOW_HANDLER
+} ES_OverflowPolicy_t;
+
 ES_Return_t ES_Initialize( TimerRate_t NewRate  );
 ES_Return_t ES_Run( void );
 bool ES_PostAll( ES_Event ThisEvent );
 bool ES_PostToService( uint8_t WhichService, ES_Event ThisEvent);
 bool ES_PostToServiceLIFO( uint8_t WhichService, ES_Event TheEvent);
+bool ES_PostWithBuffer( pPostFunc PostFunc, ES_Event ThisEvent,
+                        ES_BufHandle_t Buffer );
+
+// posts that go in together: interrupts stay off from the first to the last
+// and the services are marked ready all at once at the end. A batch can be
+// built from any post functions between ES_BeginPostBatch and
+// ES_EndPostBatch, passing the value the first returned to the second
+typedef struct {
+  uint8_t WhichService;
+  ES_Event Event;
+} ES_PostEntry_t;
+
+bool ES_PostBatch( const ES_PostEntry_t *pPosts, uint8_t NumPosts );
+bool ES_PostMulti( uint32_t Services, ES_Event ThisEvent );
+uint32_t ES_Multicast( uint32_t Services, ES_Event ThisEvent );
+uint32_t ES_BeginPostBatch( void );
+void ES_EndPostBatch( uint32_t SavedPRIMASK );
+
+#ifdef ES_PREEMPTIVE
+// runs the services that are ready and of higher priority than the one that
+// is running. Only for the PendSV code in ES_Port.c, with interrupts off
+void ES_Preempt( void );
+#endif
+
+#ifdef ES_SERVICE_STATS
+// per service statistics, kept by ES_Run and the post functions when
+// ES_SERVICE_STATS is defined in ES_Configure.h. Times are in CPU cycles
+typedef struct {
+  uint32_t Dispatches;    // events handed to the run function
+  uint32_t MinRunTime;    // run function execution times
+  uint32_t AvgRunTime;
+  uint32_t MaxRunTime;
+  uint32_t RejectedPosts; // posts that found the queue full and failed
+  uint32_t Coalesced;     // events merged, replaced or pushed out by a
+                          // queue policy (ES_QUEUE_POLICIES)
+  uint32_t Budget;        // BudgetUS (ES_SERVICE_LIST) in CPU cycles, 0
+                          // for none
+                          // (ES_RUN_BUDGETS)
+  uint32_t Overruns;      // run function times over the budget
+  ES_EventTyp_t OverrunEvent; // the event of the latest overrun
+  uint8_t HighWater;      // most events ever waiting in the queue
+  uint8_t Needed;         // the queue size that would have taken every
+                          // post, more than QueueSize if any were rejected
+  uint8_t QueueSize;
+  uint32_t Overwritten;   // events pushed out of the full queue
+                          // (ES_OVERFLOW_DROP_OLDEST)
+  uint32_t Escalated;     // of the RejectedPosts, those reported to
+                          // ES_OVERFLOW_HANDLER (ES_OVERFLOW_ESCALATE)
+} ES_ServiceStats_t;
+
+bool ES_GetServiceStats( uint8_t WhichService, ES_ServiceStats_t *pStats );
+void ES_ResetServiceStats( void );
+void ES_PrintServiceStats( void );
+void ES_DumpServiceStats( void );
+#endif
 
 #endif   // ES_Framework_H
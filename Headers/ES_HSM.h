@@ -0,0 +1,71 @@
+/****************************************************************************
+ Module
+     ES_HSM.h
+ Description
+     header file for the table driven hierarchical state machines of the
+     Events & Services Framework
+ Notes
+     A machine is a set of const ES_HSMState_t, each with its superstate
+     (pParent), the substate to go on into when it is entered (pInitial),
+     its entry and exit actions and its table of transitions. An event is
+     looked up in the table of the current state, then in those of its
+     superstates, so a transition that several states share is written
+     once in their superstate. See ES_HSM.c for the order in which the
+     actions run, and DOG_SM.c for an example.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                started coding
+*****************************************************************************/
+#ifndef ES_HSM_H
+#define ES_HSM_H
+
+#include <stddef.h>
+#include "ES_Configure.h"
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+// the deepest that states can be nested, counting the outermost as 1.
+// Entering a state nested any deeper stops the machine (see ES_HSM.c)
+#define ES_HSM_MAX_DEPTH 8
+
+typedef bool ES_HSMGuard_t( ES_Event ThisEvent );
+typedef void ES_HSMAction_t( ES_Event ThisEvent );
+typedef void ES_HSMEntryExit_t( void );
+
+typedef struct ES_HSMState_t ES_HSMState_t;
+
+// one row of a state's transition table. The first row whose EventType
+// matches and whose Guard (if any) returns true is taken
+typedef struct {
+  ES_EventTyp_t EventType;
+  ES_HSMGuard_t *Guard;         // NULL for none
+  ES_HSMAction_t *Action;       // NULL for none
+  const ES_HSMState_t *pTarget; // NULL for an internal transition, which
+                                // runs Action without leaving the state
+} ES_HSMTransition_t;
+
+struct ES_HSMState_t {
+  const ES_HSMState_t *pParent;   // the superstate, NULL at the top
+  const ES_HSMState_t *pInitial;  // the substate entered after this one,
+                                  // NULL for a leaf state
+  ES_HSMEntryExit_t *Entry;       // NULL for none
+  ES_HSMEntryExit_t *Exit;        // NULL for none
+  const ES_HSMTransition_t *pTransitions;
+  uint8_t NumTransitions;
+  uint8_t Id;                     // the application's number for the state
+};
+
+// a running machine: the leaf state that it is in, NULL until it starts
+typedef struct {
+  const ES_HSMState_t *pCurrent;
+} ES_HSM_t;
+
+/* prototypes for public functions */
+
+void ES_HSMStart( ES_HSM_t *pMachine, const ES_HSMState_t *pState );
+bool ES_HSMDispatch( ES_HSM_t *pMachine, ES_Event ThisEvent );
+bool ES_HSMIsIn( const ES_HSM_t *pMachine, const ES_HSMState_t *pState );
+
+#endif /* ES_HSM_H */
@@ -17,6 +17,7 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                added ES_GetMSBitSet32
  10/20/13 21:19 jec      got rid of BitNum2ClrMask and replaced with #define
                          replaced Byte2MSBNum with function ES_GetMSBSet
                          replaced Byte2MSBNum array with Nybble2MSBNum
@@ -24,6 +25,7 @@
  01/15/12 13:03 jec      started coding
 *****************************************************************************/
 #include "ES_Types.h"
+#include "ES_Port.h"
 /*
   Since we moved up to 16 timers & services, this table got too big to justify
   having a separate table for the clear and set masks, so just #define the
@@ -61,3 +63,22 @@ extern uint8_t const Nybble2MSBitNum[15];
    J. Edward Carryer, 10/20/13, 17:03
 ****************************************************************************/
 uint8_t ES_GetMSBitSet( uint16_t Val2Check);
+
+/****************************************************************************
+ Function
+   ES_GetMSBitSet32
+ Parameters
+   uint32_t  Val2Check The number to find the MSB in, must not be 0
+ Returns
+   bit number of the MSB that is set in Val2Check
+ Description
+   find the MSB that is set in Val2Check and returns that bit number
+ Notes
+   a single CLZ instruction where ES_Port.h provides ES_CLZ, otherwise a
+   function built on ES_GetMSBitSet
+****************************************************************************/
+#ifdef ES_CLZ
+#define ES_GetMSBitSet32(Val2Check) ((uint8_t)(31 - ES_CLZ(Val2Check)))
+#else
+uint8_t ES_GetMSBitSet32( uint32_t Val2Check);
+#endif
@@ -0,0 +1,40 @@
+/****************************************************************************
+ Module
+     ES_Pool.h
+ Description
+     header file for the fixed block memory pools of the Events & Services
+     Framework
+ Notes
+     The pools (block size classes) are set up in ES_Configure.h with
+     ES_NUM_POOLS and ES_POOLn_BLOCK_SIZE / ES_POOLn_NUM_BLOCKS.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                started coding
+*****************************************************************************/
+#ifndef ES_Pool_H
+#define ES_Pool_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+
+// the occupancy of one pool, see ES_PoolGetStats
+typedef struct {
+  uint16_t BlockSize;    // bytes per block
+  uint16_t NumBlocks;
+  uint16_t NumFree;      // blocks not allocated right now
+  uint16_t HighWater;    // most blocks ever allocated at the same time
+  uint16_t Failures;     // allocations that found the pool empty
+} ES_PoolStats_t;
+
+/* prototypes for public functions */
+
+void ES_PoolInit( void );
+void * ES_PoolAlloc( uint16_t Size );
+bool ES_PoolFree( void *pBlock );
+bool ES_PoolGetStats( uint8_t WhichPool, ES_PoolStats_t *pStats );
+void ES_PoolResetStats( void );
+void ES_PoolPrintStats( void );
+
+#endif /* ES_Pool_H */
@@ -9,6 +9,12 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26               added ES_CYCLES_PER_US and the watchdog functions
+ 10/17/26               added _HW_PreemptInit and _HW_PendSV
+ 10/17/26               added ES_WaitForInterrupt and _HW_Sleep
+ 10/17/26               added ES_CLZ and ES_AtomicSetBit/ES_AtomicClrBit
+ 10/17/26               added ES_MemoryBarrier for the SPSC queue
+ 10/17/26               added the cycle counter functions
  10/14/15 21:50 jec     added prototype for ES_Timer_GetTime
  01/18/15 13:24 jec     clean up and adapt to use TI driver lib functions
                         for implementing EnterCritical & ExitCritical
@@ -65,6 +71,61 @@ void CPUsetPRIMASK(uint32_t newPRIMASK);
 #define EnterCritical()	{ _PRIMASK_temp = CPUgetPRIMASK_cpsid(); }
 #define ExitCritical() { CPUsetPRIMASK(_PRIMASK_temp); }
 
+// ES_MemoryBarrier keeps the compiler (and the CPU) from moving memory
+// accesses across it. The lock-free SPSC queue uses it to order writing an
+// entry and publishing it
+#if defined(host)
+#define ES_MemoryBarrier()  __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#elif defined(rvmdk) || defined(__ARMCC_VERSION)
+#define ES_MemoryBarrier()  __dmb(0xF)
+#elif defined(ccs)
+#define ES_MemoryBarrier()  __asm(" dmb")
+#else
+#define ES_MemoryBarrier()  __asm volatile ("dmb" ::: "memory")
+#endif
+
+// ES_CLZ counts the leading zeros in a (non-zero) uint32_t using the
+// Cortex-M4 CLZ instruction. Where the compiler has no way to get at it,
+// ES_CLZ stays undefined and ES_GetMSBitSet32 falls back to the lookup
+// tables. Define ES_NO_CLZ to force the fallback
+#if !defined(ES_NO_CLZ)
+#if defined(rvmdk) || defined(__ARMCC_VERSION)
+#define ES_CLZ(x)   __clz(x)
+#elif defined(ccs)
+#define ES_CLZ(x)   _norm(x)
+#elif defined(__GNUC__)
+#define ES_CLZ(x)   __builtin_clz(x)
+#endif
+#endif
+
+// ES_AtomicSetBit & ES_AtomicClrBit change one bit of a uint32_t in RAM in a
+// way that an interrupt cannot split. On the Cortex-M4 they are a single
+// store to the bit-band alias of the bit, so no critical region is needed
+#if defined(host)
+#define ES_AtomicSetBit(pWord, Bit) \
+    ((void)__atomic_fetch_or((pWord), (uint32_t)1 << (Bit), __ATOMIC_RELAXED))
+#define ES_AtomicClrBit(pWord, Bit) \
+    ((void)__atomic_fetch_and((pWord), ~((uint32_t)1 << (Bit)), __ATOMIC_RELAXED))
+#else
+#define ES_BITBAND_SRAM(pWord, Bit) \
+    (*(volatile uint32_t *)(0x22000000UL + \
+       (((uint32_t)(pWord) - 0x20000000UL) << 5) + ((uint32_t)(Bit) << 2)))
+#define ES_AtomicSetBit(pWord, Bit) (ES_BITBAND_SRAM((pWord), (Bit)) = 1)
+#define ES_AtomicClrBit(pWord, Bit) (ES_BITBAND_SRAM((pWord), (Bit)) = 0)
+#endif
+
+// ES_WaitForInterrupt sleeps (WFI) until an interrupt is pending. It wakes
+// even with interrupts disabled, in which case the interrupt is taken once
+// they are enabled again
+#if defined(host)
+#define ES_WaitForInterrupt()  HostSim_WaitForInterrupt()
+#elif defined(rvmdk) || defined(__ARMCC_VERSION)
+#define ES_WaitForInterrupt()  __wfi()
+#elif defined(ccs)
+#define ES_WaitForInterrupt()  __asm(" wfi")
+#else
+#define ES_WaitForInterrupt()  __asm volatile ("wfi" ::: "memory")
+#endif
 
 /* Rate constants for programming the SysTick Period to generate tick interrupts.
    These assume an 40MHz configuration, they are the values to be used to program
@@ -88,6 +149,9 @@ typedef enum {	ES_Timer_RATE_OFF  	=   (0),
 				ES_Timer_RATE_32mS	= 1280000-1
 } TimerRate_t;
 
+// CPU cycles (as counted by _HW_GetCycleCount) per microsecond at 40MHz
+#define ES_CYCLES_PER_US 40
+
 // map the generic functions for testing the serial port to actual functions 
 // for this platform. If the C compiler does not provide functions to test
 // and retrieve serial characters, you should write them in ES_Port.c
@@ -98,6 +162,14 @@ typedef enum {	ES_Timer_RATE_OFF  	=   (0),
 void _HW_Timer_Init(TimerRate_t Rate);
 bool _HW_Process_Pending_Ints( void );
 uint16_t _HW_GetTickCount(void);
+uint16_t _HW_GetPendingTicks(void);
+void _HW_CycleCounter_Init(void);
+uint32_t _HW_GetCycleCount(void);
+void _HW_Sleep(void);
+void _HW_PreemptInit(void);
+void _HW_PendSV(void);
+void _HW_Watchdog_Init(uint32_t Milliseconds);
+void _HW_Watchdog_Feed(void);
 void ConsoleInit(void);
 // and the one Framework function that we define here
 uint16_t ES_Timer_GetTime(void);
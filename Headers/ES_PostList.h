@@ -5,10 +5,16 @@
      header file for use with the module to post events to lists of state
      machines
  Notes
+     Each distribution list (DIST_LISTn in ES_Configure.h) becomes a bit
+     mask of the services on it, ES_DIST_MASKn, with bit n for service n as
+     in ES_Multicast (ES_Framework.h). ES_PostListnn posts to the services
+     in it; ES_Multicast( ES_DIST_MASKn, Event ) does the same and says
+     which of them dropped the event.
 
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                added the ES_DIST_MASKn bit masks
  08/05/13 15:19 jec      modifications to suit new portable type definitions
  01/15/12 11:57 jec      modified includes to match Events & Services
  10/16/11 12:28 jec      started coding
@@ -16,6 +22,7 @@
 #ifndef ES_PostList_H
 #define ES_PostList_H
 
+#include "ES_Configure.h"
 #include "ES_Types.h"
 #include "ES_Events.h"
 
@@ -23,6 +30,33 @@ typedef bool PostFunc_t( ES_Event );
 
 typedef PostFunc_t (*pPostFunc);
 
+// the services on each distribution list. SERV_Name is in ES_Framework.h
+#define ES_SUBSCRIBER_BIT(Name) (1UL << SERV_##Name) |
+#if NUM_DIST_LISTS > 0
+#define ES_DIST_MASK0 ((uint32_t)(DIST_LIST0(ES_SUBSCRIBER_BIT) 0))
+#endif
+#if NUM_DIST_LISTS > 1
+#define ES_DIST_MASK1 ((uint32_t)(DIST_LIST1(ES_SUBSCRIBER_BIT) 0))
+#endif
+#if NUM_DIST_LISTS > 2
+#define ES_DIST_MASK2 ((uint32_t)(DIST_LIST2(ES_SUBSCRIBER_BIT) 0))
+#endif
+#if NUM_DIST_LISTS > 3
+#define ES_DIST_MASK3 ((uint32_t)(DIST_LIST3(ES_SUBSCRIBER_BIT) 0))
+#endif
+#if NUM_DIST_LISTS > 4
+#define ES_DIST_MASK4 ((uint32_t)(DIST_LIST4(ES_SUBSCRIBER_BIT) 0))
+#endif
+#if NUM_DIST_LISTS > 5
+#define ES_DIST_MASK5 ((uint32_t)(DIST_LIST5(ES_SUBSCRIBER_BIT) 0))
+#endif
+#if NUM_DIST_LISTS > 6
+#define ES_DIST_MASK6 ((uint32_t)(DIST_LIST6(ES_SUBSCRIBER_BIT) 0))
+#endif
+#if NUM_DIST_LISTS > 7
+#define ES_DIST_MASK7 ((uint32_t)(DIST_LIST7(ES_SUBSCRIBER_BIT) 0))
+#endif
+
 bool ES_PostList00( ES_Event);
 bool ES_PostList01( ES_Event);
 bool ES_PostList02( ES_Event);
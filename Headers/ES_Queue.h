@@ -9,6 +9,10 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                added ES_QUEUE_DROP_HEAD
+ 10/17/26                added ES_QueuePolicy_t and ES_EnQueuePolicy
+ 10/17/26                added the SPSC queue prototypes
+ 10/17/26                added ES_QueueNumEntries prototype
  08/05/13 15:19 jec      modifications to suit new portable type definitions
  01/15/12 09:36 jec      converted to use new types from ES_Types.h
  10/17/11 07:49 jec      new header to match the rest of the framework
@@ -20,6 +24,15 @@
 #include "ES_Types.h"
 #include "ES_Events.h"
 
+// what ES_EnQueuePolicy does with an event (see ES_Queue.c)
+typedef enum {  ES_QUEUE_FIFO = 0,    // add it to the end, fail if full
+                ES_QUEUE_LATEST,      // overwrite a queued one of its type
+                ES_QUEUE_MERGE,       // drop it if the same one is queued
+                ES_QUEUE_DROP_OLDEST, // if full, push out the oldest entry
+                                      // of its type
+                ES_QUEUE_DROP_HEAD    // if full, push out the oldest entry
+} ES_QueuePolicy_t;
+
 /* prototypes for public functions */
 
 uint8_t ES_InitQueue( ES_Event * pBlock, uint8_t BlockSize );
@@ -28,6 +41,16 @@ bool ES_EnQueueLIFO( ES_Event * pBlock, ES_Event Event2Add );
 uint8_t ES_DeQueue( ES_Event * pBlock, ES_Event * pReturnEvent );
 //void EF_FlushQueue( unsigned char * pBlock );
 bool ES_IsQueueEmpty( ES_Event * pBlock );
+uint8_t ES_QueueNumEntries( ES_Event * pBlock );
+bool ES_EnQueuePolicy( ES_Event * pBlock, ES_Event Event2Add,
+                       ES_QueuePolicy_t Policy, ES_Event * pDisplaced );
+
+/* the lock-free single producer/single consumer queue */
+uint8_t ES_InitSPSCQueue( ES_Event * pBlock, uint8_t BlockSize );
+bool ES_EnQueueSPSC( ES_Event * pBlock, ES_Event Event2Add );
+uint8_t ES_DeQueueSPSC( ES_Event * pBlock, ES_Event * pReturnEvent );
+bool ES_IsSPSCQueueEmpty( ES_Event * pBlock );
+uint8_t ES_SPSCQueueNumEntries( ES_Event * pBlock );
 
 #endif /*ES_Queue_H */
 
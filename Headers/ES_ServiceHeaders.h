@@ -4,72 +4,29 @@
  Description
      This file serves to keep the clutter down in ES_Framework.h
  Notes
+     Include here the header of every service in ES_SERVICE_LIST and of
+     every timer response function in ES_TIMER_LIST (ES_Configure.h), so
+     that the framework gets the prototypes that the services were compiled
+     against.
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                the headers are listed here instead of as
+                         SERV_x_HEADER in ES_Configure.h
  01/15/12 10:35 jec      started coding
 *****************************************************************************/
 
 #include "ES_Configure.h"
 
-#include SERV_0_HEADER
-
-#if NUM_SERVICES > 1
-#include SERV_1_HEADER
-#endif
-
-#if NUM_SERVICES > 2
-#include SERV_2_HEADER
-#endif
-
-#if NUM_SERVICES > 3
-#include SERV_3_HEADER
-#endif
-
-#if NUM_SERVICES > 4
-#include SERV_4_HEADER
-#endif
-
-#if NUM_SERVICES > 5
-#include SERV_5_HEADER
-#endif
-
-#if NUM_SERVICES > 6
-#include SERV_6_HEADER
-#endif
-
-#if NUM_SERVICES > 7
-#include SERV_7_HEADER
-#endif
-
-#if NUM_SERVICES > 8
-#include SERV_8_HEADER
-#endif
-
-#if NUM_SERVICES > 9
-#include SERV_9_HEADER
-#endif
-
-#if NUM_SERVICES > 10
-#include SERV_10_HEADER
-#endif
-
-#if NUM_SERVICES > 11
-#include SERV_11_HEADER
-#endif
-
-#if NUM_SERVICES > 12
-#include SERV_12_HEADER
-#endif
-
-#if NUM_SERVICES > 13
-#include SERV_13_HEADER
-#endif
-
-#if NUM_SERVICES > 14
-#include SERV_14_HEADER
-#endif
-
-#if NUM_SERVICES > 15
-#include SERV_15_HEADER
+#ifdef ES_BENCH
+#include "ES_Bench.h"
+#else
+#include "IMU_Service.h"
+#include "Receive_SM.h"
+#include "Comm_Service.h"
+#include "Transmit_SM.h"
+#include "DOG_SM.h"
+#include "MapKeys.h"
+#include "LiftFan_Service.h"
+#include "DogTail_Service.h"
 #endif
@@ -14,6 +14,9 @@
  History
  When           Who	What/Why
  -------------- ---	--------
+ 10/17/26        the timer numbers come from ES_TIMER_LIST
+ 10/17/26        added ES_Timer_GetTicksToNextTimeout
+ 10/17/26        64 timers & 32 bit times
  10/13/15 20:48 jec  removed prototype for IsTimerActive, I had removed the code
                      a couple of years ago
  08/13/13 12:03 jec  added prototype for ES_Timer_Tick_Resp as part of 
@@ -31,10 +34,23 @@
 #ifndef ES_Timers_H
 #define ES_Timers_H
 
+#include "ES_Configure.h"
 #include "ES_Port.h"
 #include "ES_Types.h"
 
 
+// the number of timers, the highest timer number is one less than this
+#define ES_NUM_TIMERS 64
+
+// the timer numbers, named in ES_TIMER_LIST (ES_Configure.h)
+#define ES_TIMER_NUMBER(Name, RespFunc) Name,
+typedef enum { ES_TIMER_LIST(ES_TIMER_NUMBER)
+               ES_NUM_LISTED_TIMERS
+} ES_TimerNum_t;
+
+// the longest time that a timer can be set to, in ticks
+#define ES_TIMER_MAX_TIME 0x7FFFFFFFUL
+
 typedef enum { ES_Timer_ERR           = -1,
                ES_Timer_ACTIVE        =  1,
                ES_Timer_OK            =  0,
@@ -43,11 +59,12 @@ typedef enum { ES_Timer_ERR           = -1,
 
 void             ES_Timer_Init(TimerRate_t Rate);
 void             ES_Timer_Tick_Resp(void);
-ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint16_t NewTime);
-ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime);
+ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime);
+ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime);
 ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num);
 ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num);
 uint16_t         ES_Timer_GetTime(void);
+uint32_t         ES_Timer_GetTicksToNextTimeout(void);
 
 #endif   /* ES_Timers_H */
 /*------------------------------ End of file ------------------------------*/
@@ -0,0 +1,79 @@
+/****************************************************************************
+ Module
+     ES_Trace.h
+ Description
+     header file for the binary event trace of the Events & Services
+     Framework
+ Notes
+     The trace is on when ES_TRACE_SIZE is defined in ES_Configure.h. Without
+     it ES_TRACE and the macros built on it compile to nothing, so trace
+     points can be left in the code.
+     The application's own trace points are named in ES_TRACE_POINTS
+     (ES_Configure.h) and recorded with ES_TracePoint.
+     With ES_TRACE_INPUTS defined only ES_TraceISR and ES_TraceInput record
+     anything, which is what HostSim needs to replay a run.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                added ES_TRACE_INPUT and ES_TRACE_INPUTS
+ 10/17/26                started coding
+*****************************************************************************/
+#ifndef ES_Trace_H
+#define ES_Trace_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+
+// what a trace record is about, and what its Id and Data are
+typedef enum {
+  ES_TRACE_POST = 1, // Id: service, Data: event (ES_TRACE_EVENT)
+  ES_TRACE_REJECT,   // Id: service, Data: event, the queue was full
+  ES_TRACE_BEGIN,    // Id: service, Data: event, the run function starts
+  ES_TRACE_END,      // Id: service, Data: type of the event it returned
+  ES_TRACE_ISR,      // Id: interrupt number (hw_ints.h), Data: 0
+  ES_TRACE_TIMER,    // Id: timer that expired, Data: 0
+  ES_TRACE_POINT,    // Id: ES_TRACE_POINTS entry, Data: whatever it records
+  ES_TRACE_LOST,     // Id: 0, Data: records overwritten before they went out
+  ES_TRACE_INPUT     // Id: interrupt number, Data: the byte it brought in
+} ES_TraceKind_t;
+
+// the numbers of the application's trace points
+#ifdef ES_TRACE_POINTS
+#define ES_TRACE_POINT_NUMBER(Name) Name,
+typedef enum {
+  ES_TRACE_POINTS(ES_TRACE_POINT_NUMBER)
+  ES_NUM_TRACE_POINTS
+} ES_TracePointNum_t;
+#endif
+
+// the Data of a post or dispatch record: the event type in the low byte and
+// the low byte of its parameter in the high byte
+#define ES_TRACE_EVENT(Event) \
+  ((uint16_t)(((Event).EventType & 0xFF) | (((Event).EventParam & 0xFF) << 8)))
+
+#if defined(ES_TRACE_SIZE) && !defined(ES_TRACE_INPUTS)
+#define ES_TRACE(Kind, Id, Data) ES_TraceRecord( (Kind), (Id), (Data) )
+#else
+#define ES_TRACE(Kind, Id, Data) ((void)0)
+#endif
+
+// first thing in an interrupt response, with its number from hw_ints.h, and
+// each byte that an interrupt response takes in from outside
+#ifdef ES_TRACE_SIZE
+#define ES_TraceISR(Interrupt)   ES_TraceRecord( ES_TRACE_ISR, (Interrupt), 0 )
+#define ES_TraceInput(Interrupt, Byte) \
+  ES_TraceRecord( ES_TRACE_INPUT, (Interrupt), (Byte) )
+#else
+#define ES_TraceISR(Interrupt)   ((void)0)
+#define ES_TraceInput(Interrupt, Byte) ((void)0)
+#endif
+#define ES_TracePoint(Point, Data) ES_TRACE( ES_TRACE_POINT, (Point), (Data) )
+
+/* prototypes for public functions */
+
+void ES_TraceRecord( ES_TraceKind_t Kind, uint8_t Id, uint16_t Data );
+bool ES_TraceDrain( void );
+void ES_TraceDump( void );
+
+#endif /* ES_Trace_H */
@@ -7,6 +7,7 @@
 typedef enum { InitTransmit, Idle, SendingData } TransmitState_t ;
 
 bool IsLastByte(void);
+bool RefillTxFIFO(void);
 
 bool InitTransmit_SM ( uint8_t Priority );
 bool PostTransmit_SM( ES_Event ThisEvent );
@@ -1,15 +1,39 @@
 #ifndef UART_H
 #define UART_H
 
-// Public Function Prototypes
+// With UART_WHOLE_FRAME_TX Transmit_SM hands UART4 a frame at a time: the
+// ISR tops the TX FIFO up each time it empties and ES_FRAME_SENT is posted
+// once the last byte is out, instead of ES_BYTE_SENT being posted (and
+// TRANSMIT_TIMER restarted) for every byte. Comment it out, or define
+// UART_BYTE_TX, for the byte at a time transmitter
+#ifndef UART_BYTE_TX
+#define UART_WHOLE_FRAME_TX
+#endif
+
+// the rate that the XBee starts up at, and the rate that Comm_Service
+// switches the link to at start up (XBEE_DEFAULT_BAUD to stay at it).
+// Standard rates are set with the XBee's BD code, others as the rate itself
+#define XBEE_DEFAULT_BAUD 9600
+#ifndef XBEE_BAUD
+#define XBEE_BAUD 115200
+#endif
 
-typedef enum { Wait4Start, Wait4MSBLength, Wait4LSBLength, ReceivingData } UARTReceiveState_t ;
+// the XBee's API mode (its AP parameter), XBEE_API_UNESCAPED (1) or
+// XBEE_API_ESCAPED (2, XBeeParser.h). Escaped frames are only sent by the
+// whole frame transmitter (UART_WHOLE_FRAME_TX)
+#ifndef XBEE_API_MODE
+#define XBEE_API_MODE 1
+#endif
+
+// Public Function Prototypes
 
 void InitUART(void);
 void UART_ISR(void);
+void UART_SetBaud(uint32_t Baud);
+uint32_t UART_GetBaud(void);
+uint32_t UART_BytesToMS(uint16_t NumBytes);
 uint8_t GetAPIIdentifier(void);
 
-uint8_t* GetDataPacket (void);
 void SetUARTState(void);
 
 #endif 
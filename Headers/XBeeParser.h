@@ -0,0 +1,80 @@
+/****************************************************************************
+ Module
+     XBeeParser.h
+ Description
+     header file for the XBee API frame parser
+ Notes
+     Each parser is an XBeeParser_t that the caller owns, so there can be as
+     many as there are links, and nothing is shared between them.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                started coding
+*****************************************************************************/
+#ifndef XBeeParser_H
+#define XBeeParser_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// the XBee's API modes (its AP parameter)
+#define XBEE_API_UNESCAPED 1
+#define XBEE_API_ESCAPED 2
+
+// the bytes that are special on the wire, and what escaped bytes are XORed
+// with (API mode 2)
+#define XBEE_START_DELIMITER 0x7E
+#define XBEE_ESCAPE 0x7D
+#define XBEE_XON 0x11
+#define XBEE_XOFF 0x13
+#define XBEE_ESCAPE_XOR 0x20
+
+typedef enum
+{
+  XBeeWait4Start,
+  XBeeWait4MSBLength,
+  XBeeWait4LSBLength,
+  XBeeReceivingData,
+  XBeeWait4Checksum
+} XBeeParserState_t;
+
+// what XBeeParser_Byte found with the byte that it was given
+typedef enum
+{
+  XBEE_PARSE_BUSY,          // nothing to report
+  XBEE_PARSE_LENGTH,        // the length is in, the caller may now give the
+                            // frame a buffer of its own (XBeeParser_SetBuffer)
+  XBEE_PARSE_FRAME,         // a frame with a good checksum is in the buffer
+  XBEE_PARSE_BAD_CHECKSUM,  // the frame was dropped
+  XBEE_PARSE_TOO_LONG,      // the frame didn't fit the buffer and was skipped
+  XBEE_PARSE_RESYNC         // a start delimiter cut the frame short (API mode
+                            // 2 only), the byte started the next frame
+} XBeeParseResult_t;
+
+typedef struct
+{
+  XBeeParserState_t State;
+  uint8_t Mode;             // XBEE_API_UNESCAPED or XBEE_API_ESCAPED
+  bool Escaped;             // the last byte was XBEE_ESCAPE
+  uint16_t Length;          // of the frame data, (MSB << 8) | LSB
+  uint16_t Index;           // into the frame data
+  uint8_t Sum;              // of the frame data so far
+  uint8_t *pBuffer;
+  uint16_t BufferSize;
+  uint8_t *pFrame;          // pBuffer if the frame fits it, NULL if not
+} XBeeParser_t;
+
+/* prototypes for public functions */
+
+void XBeeParser_Init( XBeeParser_t *pParser, uint8_t Mode,
+                      uint8_t *pBuffer, uint16_t BufferSize );
+void XBeeParser_SetBuffer( XBeeParser_t *pParser, uint8_t *pBuffer,
+                           uint16_t BufferSize );
+void XBeeParser_Reset( XBeeParser_t *pParser );
+XBeeParseResult_t XBeeParser_Byte( XBeeParser_t *pParser, uint8_t Byte );
+uint16_t XBeeParser_Length( const XBeeParser_t *pParser );
+bool XBeeParser_InFrame( const XBeeParser_t *pParser );
+bool XBee_NeedsEscape( uint8_t Byte );
+
+#endif /* XBeeParser_H */
@@ -34,6 +34,9 @@ void TERMIO_PutChar(unsigned char ch);
 void TERMIO_Init(void);
 /* checks for a character from the terminal channel */
 int kbhit(void);
+/* checks that everything sent to the terminal channel has gone out, so
+   that up to a FIFO's worth can be sent without waiting */
+int TERMIO_TxEmpty(void);
 
 #if defined(ccs)
 #include <file.h>
@@ -0,0 +1,291 @@
+/****************************************************************************
+ Module
+   HostDriverlib.c
+
+ Description
+   Host (Linux) versions of the TivaWare driverlib calls that the DOG code
+   makes. Like the real library they are thin wrappers around register
+   accesses, so the peripheral behaviour all lives in HostSim.c.
+
+ Notes
+   Only the calls that the application and the framework use are here.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               first pass
+****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_uart.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
+#include "driverlib/uart.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define SYSCTL_RCGC_BASE  0x400FE600
+#define SYSCTL_PR_BASE    0x400FEA00
+
+// the GPIO port index used in the pin_map.h encoding
+static const uint32_t GPIOBaseAddrs[] = {
+  GPIO_PORTA_BASE, GPIO_PORTB_BASE, GPIO_PORTC_BASE,
+  GPIO_PORTD_BASE, GPIO_PORTE_BASE, GPIO_PORTF_BASE
+};
+
+/*------------------------------ sysctl -----------------------------------*/
+void SysCtlClockSet(uint32_t ui32Config)
+{
+  // the simulation always runs at HOSTSIM_SYSCLK_HZ, as main() asks for
+  (void)ui32Config;
+}
+
+uint32_t SysCtlClockGet(void)
+{
+  return HOSTSIM_SYSCLK_HZ;
+}
+
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+  HWREG(SYSCTL_RCGC_BASE + ((ui32Peripheral & 0xff00) >> 8)) |=
+      (1UL << (ui32Peripheral & 0xff));
+}
+
+void SysCtlPeripheralDisable(uint32_t ui32Peripheral)
+{
+  HWREG(SYSCTL_RCGC_BASE + ((ui32Peripheral & 0xff00) >> 8)) &=
+      ~(1UL << (ui32Peripheral & 0xff));
+}
+
+bool SysCtlPeripheralReady(uint32_t ui32Peripheral)
+{
+  return (HWREG(SYSCTL_PR_BASE + ((ui32Peripheral & 0xff00) >> 8)) &
+          (1UL << (ui32Peripheral & 0xff))) != 0;
+}
+
+void SysCtlDelay(uint32_t ui32Count)
+{
+  // three cycles per loop on the target
+  uint64_t Until = HostSim_Now() + 3ULL * ui32Count * HOSTSIM_NS_PER_CYCLE;
+
+  while (HostSim_Now() < Until)
+  {
+    HostSim_Sync();
+  }
+}
+
+/*------------------------------- gpio ------------------------------------*/
+void GPIOPinConfigure(uint32_t ui32PinConfig)
+{
+  uint32_t ui32Port = (ui32PinConfig >> 16) & 0xff;
+  uint32_t ui32Shift = (ui32PinConfig >> 8) & 0xff;
+  uint32_t ui32Base;
+
+  if (ui32Port >= sizeof(GPIOBaseAddrs) / sizeof(GPIOBaseAddrs[0]))
+  {
+    return;
+  }
+  ui32Base = GPIOBaseAddrs[ui32Port];
+  HWREG(ui32Base + GPIO_O_PCTL) = ((HWREG(ui32Base + GPIO_O_PCTL) &
+                                    ~(0xfUL << ui32Shift)) |
+                                   ((ui32PinConfig & 0xf) << ui32Shift));
+}
+
+int32_t GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+  return HWREG(ui32Port + (GPIO_O_DATA + (ui8Pins << 2)));
+}
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+  HWREG(ui32Port + (GPIO_O_DATA + (ui8Pins << 2))) = ui8Val;
+}
+
+void GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+  HWREG(ui32Port + GPIO_O_DIR) &= ~ui8Pins;
+  HWREG(ui32Port + GPIO_O_AFSEL) &= ~ui8Pins;
+  HWREG(ui32Port + GPIO_O_DEN) |= ui8Pins;
+}
+
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+  HWREG(ui32Port + GPIO_O_DIR) |= ui8Pins;
+  HWREG(ui32Port + GPIO_O_AFSEL) &= ~ui8Pins;
+  HWREG(ui32Port + GPIO_O_DEN) |= ui8Pins;
+}
+
+void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins)
+{
+  HWREG(ui32Port + GPIO_O_AFSEL) |= ui8Pins;
+  HWREG(ui32Port + GPIO_O_DEN) |= ui8Pins;
+}
+
+/*----------------------------- interrupt ---------------------------------*/
+bool IntMasterEnable(void)
+{
+  uint32_t OldPRIMASK = HostSim_DisableIRQ();
+
+  HostSim_SetPRIMASK(0);
+  return OldPRIMASK != 0;
+}
+
+bool IntMasterDisable(void)
+{
+  return HostSim_DisableIRQ() != 0;
+}
+
+void IntEnable(uint32_t ui32Interrupt)
+{
+  if (ui32Interrupt == FAULT_SYSTICK)
+  {
+    HWREG(NVIC_ST_CTRL) |= NVIC_ST_CTRL_INTEN;
+  }
+  else if (ui32Interrupt >= 16)
+  {
+    HWREG(NVIC_EN0 + ((ui32Interrupt - 16) / 32) * 4) =
+        1UL << ((ui32Interrupt - 16) & 31);
+  }
+}
+
+void IntDisable(uint32_t ui32Interrupt)
+{
+  if (ui32Interrupt == FAULT_SYSTICK)
+  {
+    HWREG(NVIC_ST_CTRL) &= ~NVIC_ST_CTRL_INTEN;
+  }
+  else if (ui32Interrupt >= 16)
+  {
+    HWREG(NVIC_DIS0 + ((ui32Interrupt - 16) / 32) * 4) =
+        1UL << ((ui32Interrupt - 16) & 31);
+  }
+}
+
+/*------------------------------ systick ----------------------------------*/
+void SysTickEnable(void)
+{
+  HWREG(NVIC_ST_CTRL) |= NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_ENABLE;
+}
+
+void SysTickDisable(void)
+{
+  HWREG(NVIC_ST_CTRL) &= ~NVIC_ST_CTRL_ENABLE;
+}
+
+void SysTickIntEnable(void)
+{
+  HWREG(NVIC_ST_CTRL) |= NVIC_ST_CTRL_INTEN;
+}
+
+void SysTickIntDisable(void)
+{
+  HWREG(NVIC_ST_CTRL) &= ~NVIC_ST_CTRL_INTEN;
+}
+
+void SysTickPeriodSet(uint32_t ui32Period)
+{
+  HWREG(NVIC_ST_RELOAD) = ui32Period - 1;
+}
+
+uint32_t SysTickPeriodGet(void)
+{
+  return HWREG(NVIC_ST_RELOAD) + 1;
+}
+
+uint32_t SysTickValueGet(void)
+{
+  return HWREG(NVIC_ST_CURRENT);
+}
+
+/*------------------------------- timer -----------------------------------*/
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config)
+{
+  HWREG(ui32Base + TIMER_O_CTL) &= ~(TIMER_CTL_TAEN | TIMER_CTL_TBEN);
+  HWREG(ui32Base + TIMER_O_CFG) = ui32Config >> 24;
+  HWREG(ui32Base + TIMER_O_TAMR) = ui32Config & 0xff;
+  HWREG(ui32Base + TIMER_O_TBMR) = (ui32Config >> 8) & 0xff;
+}
+
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+  HWREG(ui32Base + TIMER_O_CTL) |= ui32Timer & (TIMER_CTL_TAEN | TIMER_CTL_TBEN);
+}
+
+void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+  HWREG(ui32Base + TIMER_O_CTL) &= ~(ui32Timer & (TIMER_CTL_TAEN | TIMER_CTL_TBEN));
+}
+
+void TimerPrescaleSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+  if (ui32Timer & TIMER_A)
+  {
+    HWREG(ui32Base + TIMER_O_TAPR) = ui32Value;
+  }
+  if (ui32Timer & TIMER_B)
+  {
+    HWREG(ui32Base + TIMER_O_TBPR) = ui32Value;
+  }
+}
+
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+  if (ui32Timer & TIMER_A)
+  {
+    HWREG(ui32Base + TIMER_O_TAILR) = ui32Value;
+  }
+  if (ui32Timer & TIMER_B)
+  {
+    HWREG(ui32Base + TIMER_O_TBILR) = ui32Value;
+  }
+}
+
+uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+  return (ui32Timer == TIMER_A) ? HWREG(ui32Base + TIMER_O_TAV) :
+                                  HWREG(ui32Base + TIMER_O_TBV);
+}
+
+void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+  HWREG(ui32Base + TIMER_O_IMR) |= ui32IntFlags;
+}
+
+void TimerIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+  HWREG(ui32Base + TIMER_O_IMR) &= ~ui32IntFlags;
+}
+
+void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+  HWREG(ui32Base + TIMER_O_ICR) = ui32IntFlags;
+}
+
+/*------------------------------- uart ------------------------------------*/
+void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source)
+{
+  HWREG(ui32Base + UART_O_CC) = ui32Source;
+}
+
+void UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+  // UART0 is the console, which is stdout on the host
+  if (ui32Base == UART0_BASE)
+  {
+    putchar(ucData);
+    return;
+  }
+  while (HWREG(ui32Base + UART_O_FR) & UART_FR_TXFF)
+  {
+  }
+  HWREG(ui32Base + UART_O_DR) = ucData;
+}
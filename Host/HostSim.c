@@ -0,0 +1,1921 @@
+/****************************************************************************
+ Module
+   HostSim.c
+
+ Description
+   Host (Linux) simulation of the TM4C123 registers and peripherals used by
+   the DOG code, so that the services, the framework and the ISRs can run
+   unmodified in a normal process.
+
+ Notes
+   Every HWREG() goes through HostSim_Reg(), which hands back a pointer to
+   a cell holding the current value of the register. The access is only
+   acted on when the next register access (or HostSim_Sync) comes along:
+   if the cell still holds the value that was loaded it was a read,
+   otherwise it was a write. That is enough for the idioms in this code
+   (x = HWREG(), HWREG() = x, HWREG() |= x, HWREG() = f(HWREG())) but it
+   relies on gcc evaluating the right hand side of an assignment before
+   the left, so build the host image with gcc.
+   Data registers (UART DR, SSI DR, ADC FIFO) load a rolling tag in bits
+   24-30 so that writing back the value just read still counts as a write.
+
+   Interrupts are level sensitive and are taken between register accesses
+   and when PRIMASK is cleared, SysTick first and then in IRQ number order.
+   There is no nesting: nothing is taken while an ISR is running.
+   PendSV comes after all of the others, and its handler is run in thread
+   context (as ES_Port.c arranges on the target), so the ISRs can still
+   interrupt it.
+
+   Watchdog 0 counts down from LOAD once INTEN is set. The first time-out
+   sets RIS, and with RESEN set a second one ends the process, as a reset
+   would end the run on the target.
+
+   Build (from the project root):
+     gcc -Dhost -IHost -IHeaders -o dog_host Host/HostSim.c
+         Host/HostDriverlib.c Host/HostTermio.c <the Source files in the
+         Keil project>
+   leaving out termio.c, uartstdio.c and retarget.c, which are replaced
+   by HostTermio.c.
+
+   Environment:
+     DOG_XBEE_RX  file of raw bytes to play into the UART4 RX pin at start
+     DOG_XBEE_TX  file to which bytes sent out of UART4 are written
+     DOG_REPLAY   console capture of a run recorded with ES_TRACE_INPUTS
+                  (ES_Configure.h), to be replayed instead of DOG_XBEE_RX
+
+   Replay runs in virtual time, so that it goes the same way every time and
+   as fast as the host can manage. Each byte that UART4 received in the
+   recording arrives at the time its ISR recorded it (cycles since
+   ES_Initialize zeroed the cycle counter), and everything else (SysTick,
+   SSI1 EOTs, Timer5) comes from the simulation as usual. Each of those
+   interrupts is matched with the recorded one of its kind nearest in time,
+   and the first that has no recorded one within REPLAY_TOLERANCE_NS (or
+   recorded one without a replayed one) is reported. REPLAY_TAIL_NS after the last
+   recorded input the run ends with a summary on stderr (and the host time
+   it took, for benchmarking), exiting with EXIT_FAILURE if it diverged.
+   A recording with records lost (LOST) is only replayed up to the loss.
+   In virtual time each HostSim_Sync moves time on by SYNC_STEP_NS, so the
+   idle loop and SysCtlDelay move along without ES_TICKLESS as well.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               added the replay of recorded inputs (DOG_REPLAY)
+ 10/17/26               added watchdog 0, for ES_WATCHDOG_MS
+ 10/17/26               added PendSV, for ES_PREEMPTIVE
+ 10/17/26               added HostSim_WaitForInterrupt & SysTick pending in
+                        NVIC_INT_CTRL for the tickless idle
+ 10/17/26               first pass
+****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "HostSim.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_ssi.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_uart.h"
+#include "inc/hw_watchdog.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define PERIPH_BASE       0x40000000UL
+#define PERIPH_SIZE       0x00100000UL
+#define SCS_BASE          0xE0000000UL
+#define SCS_SIZE          0x00010000UL
+
+#define DWT_CYCCNT        0xE0001004UL
+
+#define SYSCTL_PR_BASE    0x400FEA00UL
+
+#define ADC_O_RIS         0x004
+#define ADC_O_IM          0x008
+#define ADC_O_ISC         0x00C
+#define ADC_O_PSSI        0x028
+#define ADC_O_SSCTL2      0x084
+#define ADC_O_SSFIFO2     0x088
+#define ADC_O_SSFSTAT2    0x08C
+
+#define TAG_SHIFT         24
+#define FIFO_DEPTH        16
+#define SSI_FIFO_DEPTH    8
+#define NUM_GPIO_PORTS    6
+
+// IRQ numbers (vector number - 16) and their NVIC enable bits
+#define IRQ_SSI1          34
+#define IRQ_UART4         60
+#define IRQ_TIMER5A       92
+#define IRQ_TIMER5B       93
+
+#define IMU_WHO_AM_I      0x0F
+
+// how long HostSim_WaitForInterrupt sleeps between looks at the peripherals
+#define WFI_NAP_NS        100000UL
+// how far a HostSim_Sync moves virtual time on
+#define SYNC_STEP_NS      1000UL
+
+// the frames that ES_Trace.c sends, and the record kinds (ES_Trace.h) that
+// a replay uses
+#define TRACE_FRAME_START   0xA5
+#define TRACE_FRAME_LENGTH  10
+#define TRACE_ISR           5
+#define TRACE_LOST          8
+#define TRACE_INPUT         9
+
+// interrupt numbers (hw_ints.h) in the recording
+#define INT_NUM_SYSTICK     15
+#define INT_NUM_UART4       (IRQ_UART4 + 16)
+
+// how far a replayed interrupt may be from the recorded one, and how long a
+// replay runs on after the last recorded input
+#define REPLAY_TOLERANCE_NS 500000ULL
+#define REPLAY_TAIL_NS      1000000000ULL
+
+// SysTick, SSI1, UART4, Timer5A and Timer5B, as numbered by HighestPending
+#define NUM_SOURCES       5
+
+/*---------------------------- Module Types -------------------------------*/
+typedef struct
+{
+  uint16_t Data[FIFO_DEPTH];
+  uint8_t Head;
+  uint8_t Count;
+} Fifo_t;
+
+// an interrupt response or a byte received, from a recording
+typedef struct
+{
+  uint64_t Cycle;         // since the cycle counter was zeroed
+  uint8_t Interrupt;      // number from hw_ints.h
+  uint8_t Byte;
+} Input_t;
+
+typedef struct
+{
+  volatile uint32_t *pCell;
+  uint32_t Address;
+  uint32_t Loaded;
+  bool Pending;
+} Access_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+static void Init(void);
+static volatile uint32_t *Cell(uint32_t Address);
+static void LoadReg(uint32_t Address, volatile uint32_t *pCell);
+static void CommitAccess(void);
+static void OnRead(uint32_t Address);
+static void OnWrite(uint32_t Address, uint32_t OldValue, uint32_t NewValue);
+static void SyncPeripherals(void);
+static int HighestPending(void);
+static void TakePendingInterrupts(void);
+static uint64_t ReadClock(void);
+
+static void ReplayLoad(const char *pName);
+static bool ReplayAdd(Input_t **ppList, size_t *pCount, const Input_t *pInput);
+static size_t ReplayNextISR(int Source, size_t From);
+static uint64_t ReplayTime(uint64_t Cycle);
+static bool ReplayRx(uint64_t Now, uint8_t *pByte, uint64_t *pAt);
+static void ReplayCheck(int Source, uint64_t Now);
+static void ReplayDiverged(int Source, uint64_t Now, const char *pWhat);
+static void ReplaySync(uint64_t Now);
+
+static bool FifoPut(Fifo_t *pFifo, uint16_t Value, uint8_t Depth);
+static uint16_t FifoPeek(const Fifo_t *pFifo);
+static uint16_t FifoGet(Fifo_t *pFifo);
+
+static uint64_t UART4CharTime(void);
+static uint8_t UART4Depth(void);
+static uint8_t UART4RxTrigger(void);
+static uint8_t UART4TxTrigger(void);
+static void UART4Sync(uint64_t Now);
+static void UART4Arrive(uint8_t Byte, uint64_t At);
+static void UART4Write(uint8_t Byte, uint64_t Now);
+static void UART4Read(uint64_t Now);
+
+static uint64_t SSI1FrameTime(void);
+static uint32_t SSI1RawInts(void);
+static void SSI1Sync(uint64_t Now);
+static uint8_t IMUExchange(uint8_t Byte);
+
+static void Timer5Start(int Which, uint64_t Now);
+static void Timer5Sync(uint64_t Now);
+
+static uint64_t SysTickPeriod(void);
+static void SysTickSync(uint64_t Now);
+
+static void ADC0Trigger(uint32_t Sequencers);
+
+static uint64_t WatchdogPeriod(void);
+static void WatchdogSync(uint64_t Now);
+
+/*---------------------------- External ISRs ------------------------------*/
+// these mirror the vector table in the startup file; any that are not
+// linked in are simply left out of the dispatch
+extern void SysTickIntHandler(void) __attribute__((weak));
+extern void SPI_ISR(void) __attribute__((weak));
+extern void UART_ISR(void) __attribute__((weak));
+extern void ShortTimerAHandler(void) __attribute__((weak));
+extern void ShortTimerBHandler(void) __attribute__((weak));
+extern void PendSV_Handler(void) __attribute__((weak));
+
+/*---------------------------- Module Variables ---------------------------*/
+static uint32_t PeriphRegs[PERIPH_SIZE / 4];
+static uint32_t ScsRegs[SCS_SIZE / 4];
+static uint32_t Unmapped;
+
+static bool Initialized = false;
+static Access_t Access;
+static uint8_t NextTag = 1;
+
+// CPU
+static uint32_t PRIMASK = 0;
+static bool InISR = false;
+static bool PendingWhileMasked = false;
+static bool PendSVPending = false;
+static uint32_t NvicEnabled[5];
+
+// time
+static bool VirtualTime = false;
+static uint64_t VirtualNow = 0;
+static uint64_t ClockOrigin = 0;
+static uint64_t CycleOrigin = 0;
+
+// SysTick
+static uint64_t NextTick;
+static bool SysTickCountFlag = false;
+static uint32_t SysTickPending = 0;
+
+// GPIO
+static uint32_t GPIOData[NUM_GPIO_PORTS];
+static const uint32_t GPIOBase[NUM_GPIO_PORTS] = {
+  GPIO_PORTA_BASE, GPIO_PORTB_BASE, GPIO_PORTC_BASE,
+  GPIO_PORTD_BASE, GPIO_PORTE_BASE, GPIO_PORTF_BASE
+};
+
+// UART4
+static struct
+{
+  Fifo_t Rx;
+  Fifo_t Tx;
+  uint32_t RIS;
+  bool Shifting;
+  uint8_t ShiftByte;
+  uint64_t ShiftDone;
+  uint64_t LastRxActivity;
+  // bytes still to arrive on the RX pin
+  uint8_t *pIn;
+  size_t InLength;
+  size_t InNext;
+  size_t InCapacity;
+  uint64_t NextArrival;
+} UART4;
+static HostSim_ByteHook_t XBeeTxHook = NULL;
+static FILE *XBeeTxFile = NULL;
+
+// SSI1 and the IMU hanging off it
+static struct
+{
+  Fifo_t Rx;
+  Fifo_t Tx;
+  bool Overrun;
+  bool Busy;
+  uint8_t ShiftByte;
+  uint64_t ShiftDone;
+} SSI1;
+static struct
+{
+  uint8_t Regs[128];
+  bool InTransaction;
+  bool Reading;
+  uint8_t Address;
+} IMU;
+
+// Timer5 A and B
+static struct
+{
+  uint32_t RIS;
+  uint64_t Deadline[2];
+} Timer5;
+
+// watchdog 0
+static struct
+{
+  bool Running;
+  uint32_t RIS;
+  uint64_t Deadline;
+} Watchdog;
+
+// ADC0 sample sequencer 2
+static struct
+{
+  uint32_t RIS;
+  Fifo_t Fifo;
+  uint16_t Value[4];
+} ADC0;
+
+// replay of a recorded run (DOG_REPLAY)
+static const struct
+{
+  uint8_t Interrupt;
+  const char *pName;
+} Sources[NUM_SOURCES] = {
+  { INT_NUM_SYSTICK, "SysTick" },
+  { IRQ_SSI1 + 16, "SSI1" },
+  { INT_NUM_UART4, "UART4" },
+  { IRQ_TIMER5A + 16, "Timer5A" },
+  { IRQ_TIMER5B + 16, "Timer5B" },
+};
+static struct
+{
+  bool Active;
+  // the bytes UART4 received, and the next one to arrive
+  Input_t *pRx;
+  size_t NumRx;
+  size_t NextRx;
+  // the interrupt responses, and the next one of each source to check
+  Input_t *pISR;
+  size_t NumISR;
+  size_t Next[NUM_SOURCES];
+  uint32_t Recorded[NUM_SOURCES];
+  uint32_t Taken[NUM_SOURCES];
+  uint32_t Matched[NUM_SOURCES];
+  uint64_t MaxDrift[NUM_SOURCES];
+  uint64_t LastCycle;
+  uint64_t HostStart;
+  bool Diverged;
+  char Divergence[160];
+} Replay;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+     HostSim_Reg
+ Parameters
+     uint32_t Address, the peripheral or system register address
+ Returns
+     volatile uint32_t *, the cell standing in for that register
+ Description
+     Completes the previous register access, lets the peripherals catch up
+     and takes any pending interrupts, then loads the current value of the
+     register into its cell.
+ Notes
+     see the module notes on how reads and writes are told apart
+****************************************************************************/
+volatile uint32_t *HostSim_Reg(uint32_t Address)
+{
+  volatile uint32_t *pCell;
+
+  Init();
+  CommitAccess();
+  TakePendingInterrupts();
+
+  pCell = Cell(Address);
+  LoadReg(Address, pCell);
+  Access.pCell = pCell;
+  Access.Address = Address;
+  Access.Loaded = *pCell;
+  Access.Pending = true;
+  return pCell;
+}
+
+/****************************************************************************
+ Function
+     HostSim_Sync
+ Parameters
+     none
+ Returns
+     none
+ Description
+     Completes any outstanding register access, brings the peripherals up
+     to the current time and takes pending interrupts if they are enabled.
+ Notes
+     called from _HW_Process_Pending_Ints and kbhit so that the simulation
+     moves along while the framework is idle. In virtual time each call
+     counts as SYNC_STEP_NS
+****************************************************************************/
+void HostSim_Sync(void)
+{
+  Init();
+  CommitAccess();
+  if (VirtualTime && !InISR)
+  {
+    VirtualNow += SYNC_STEP_NS;
+  }
+  TakePendingInterrupts();
+}
+
+/****************************************************************************
+ Function
+     HostSim_DisableIRQ
+ Parameters
+     none
+ Returns
+     uint32_t, the previous value of PRIMASK
+ Description
+     The host equivalent of "mrs r0, PRIMASK; cpsid i"
+****************************************************************************/
+uint32_t HostSim_DisableIRQ(void)
+{
+  uint32_t OldPRIMASK = PRIMASK;
+
+  PRIMASK = 1;
+  return OldPRIMASK;
+}
+
+/****************************************************************************
+ Function
+     HostSim_SetPRIMASK
+ Parameters
+     uint32_t NewPRIMASK, only bit 0 is significant
+ Returns
+     none
+ Description
+     The host equivalent of "msr PRIMASK, r0". Anything that was seen to
+     become pending while interrupts were masked is taken as soon as they
+     are unmasked; otherwise this stays cheap so that the framework's
+     critical sections cost about what they do on the target.
+****************************************************************************/
+void HostSim_SetPRIMASK(uint32_t NewPRIMASK)
+{
+  Init();
+  PRIMASK = NewPRIMASK & 1;
+  if ((PRIMASK == 0) && PendingWhileMasked)
+  {
+    PendingWhileMasked = false;
+    CommitAccess();
+    TakePendingInterrupts();
+  }
+}
+
+/****************************************************************************
+ Function
+     HostSim_WaitForInterrupt
+ Parameters
+     none
+ Returns
+     none
+ Description
+     The host equivalent of "wfi": returns once an enabled interrupt is
+     pending. If PRIMASK is clear it is taken first, otherwise it is taken
+     when PRIMASK is cleared.
+ Notes
+     In real time this naps in the host between looks at the peripherals,
+     in virtual time it moves time along by the same amount instead. As on
+     the target, it never returns if nothing can interrupt.
+****************************************************************************/
+void HostSim_WaitForInterrupt(void)
+{
+  struct timespec Nap = { 0, WFI_NAP_NS };
+
+  Init();
+  CommitAccess();
+  for (;;)
+  {
+    SyncPeripherals();
+    if (HighestPending() >= 0)
+    {
+      break;
+    }
+    if (VirtualTime)
+    {
+      VirtualNow += WFI_NAP_NS;
+    }
+    else
+    {
+      nanosleep(&Nap, NULL);
+    }
+  }
+  TakePendingInterrupts();
+}
+
+/****************************************************************************
+ Function
+     HostSim_InISR
+ Parameters
+     none
+ Returns
+     bool, true while one of the simulated ISRs is running
+****************************************************************************/
+bool HostSim_InISR(void)
+{
+  return InISR;
+}
+
+/****************************************************************************
+ Function
+     HostSim_Now
+ Parameters
+     none
+ Returns
+     uint64_t, simulated time in ns since start up
+****************************************************************************/
+uint64_t HostSim_Now(void)
+{
+  Init();
+  if (VirtualTime)
+  {
+    return VirtualNow;
+  }
+  return ReadClock() - ClockOrigin;
+}
+
+/****************************************************************************
+ Function
+     HostSim_UseVirtualTime
+ Parameters
+     bool Enable, true to stop following the host clock
+ Returns
+     none
+ Description
+     In virtual time, simulated time only advances through HostSim_Advance,
+     which makes runs repeatable. Switching over keeps time continuous.
+****************************************************************************/
+void HostSim_UseVirtualTime(bool Enable)
+{
+  uint64_t Now = HostSim_Now();
+
+  VirtualTime = Enable;
+  VirtualNow = Now;
+  ClockOrigin = ReadClock() - Now;
+}
+
+/****************************************************************************
+ Function
+     HostSim_Advance
+ Parameters
+     uint64_t Nanoseconds, how far to move virtual time
+ Returns
+     none
+ Description
+     Moves virtual time forward, stopping at each peripheral event on the
+     way so that interrupts are taken in order and at the right time.
+****************************************************************************/
+void HostSim_Advance(uint64_t Nanoseconds)
+{
+  uint64_t Target;
+
+  Init();
+  if (!VirtualTime)
+  {
+    return;
+  }
+  Target = VirtualNow + Nanoseconds;
+  CommitAccess();
+  // step one SysTick period (or less) at a time so that tick interrupts
+  // interleave with the other sources the way they would on the target
+  while (VirtualNow < Target)
+  {
+    uint64_t Step = SysTickPeriod();
+    if ((Step == 0) || (Step > (Target - VirtualNow)))
+    {
+      Step = Target - VirtualNow;
+    }
+    VirtualNow += Step;
+    TakePendingInterrupts();
+  }
+}
+
+/****************************************************************************
+ Function
+     HostSim_XBeeRx
+ Parameters
+     const uint8_t *pBytes, Length: bytes for the XBee to send to the TIVA
+ Returns
+     none
+ Description
+     Queues bytes to arrive on the UART4 RX pin, one character time apart
+****************************************************************************/
+void HostSim_XBeeRx(const uint8_t *pBytes, size_t Length)
+{
+  Init();
+  CommitAccess();
+  SyncPeripherals();
+  if (UART4.InNext == UART4.InLength)
+  {
+    UART4.InNext = 0;
+    UART4.InLength = 0;
+    UART4.NextArrival = HostSim_Now() + UART4CharTime();
+  }
+  if (UART4.InLength + Length > UART4.InCapacity)
+  {
+    UART4.InCapacity = (UART4.InLength + Length) * 2;
+    UART4.pIn = realloc(UART4.pIn, UART4.InCapacity);
+    if (UART4.pIn == NULL)
+    {
+      fprintf(stderr, "HostSim: out of memory for XBee input\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  memcpy(&UART4.pIn[UART4.InLength], pBytes, Length);
+  UART4.InLength += Length;
+}
+
+/****************************************************************************
+ Function
+     HostSim_XBeeRxPending
+ Parameters
+     none
+ Returns
+     size_t, number of queued bytes that have not reached the RX pin yet
+****************************************************************************/
+size_t HostSim_XBeeRxPending(void)
+{
+  return UART4.InLength - UART4.InNext;
+}
+
+/****************************************************************************
+ Function
+     HostSim_SetXBeeTxHook
+ Parameters
+     HostSim_ByteHook_t Hook, called with each byte as its stop bit goes out
+ Returns
+     none
+****************************************************************************/
+void HostSim_SetXBeeTxHook(HostSim_ByteHook_t Hook)
+{
+  XBeeTxHook = Hook;
+}
+
+/****************************************************************************
+ Function
+     HostSim_IMUSetReg / HostSim_IMUGetReg
+ Description
+     Access to the register file of the simulated LSM6DS3
+****************************************************************************/
+void HostSim_IMUSetReg(uint8_t Reg, uint8_t Value)
+{
+  IMU.Regs[Reg & 0x7F] = Value;
+}
+
+uint8_t HostSim_IMUGetReg(uint8_t Reg)
+{
+  return IMU.Regs[Reg & 0x7F];
+}
+
+/****************************************************************************
+ Function
+     HostSim_SetADC
+ Parameters
+     uint8_t Step, the sequencer step (0-3)
+     uint16_t Value, the 12 bit conversion result to return for it
+ Returns
+     none
+****************************************************************************/
+void HostSim_SetADC(uint8_t Step, uint16_t Value)
+{
+  if (Step < 4)
+  {
+    ADC0.Value[Step] = Value & 0x0FFF;
+  }
+}
+
+/****************************************************************************
+ Function
+     HostSim_Peek
+ Parameters
+     uint32_t Address, register address
+ Returns
+     uint32_t, the register contents as the hardware would read them
+ Description
+     For test code: looks at a register without completing the pending
+     access or triggering any read side effects.
+****************************************************************************/
+uint32_t HostSim_Peek(uint32_t Address)
+{
+  volatile uint32_t *pCell;
+  uint32_t Saved;
+  uint32_t Value;
+
+  Init();
+  pCell = Cell(Address);
+  Saved = *pCell;
+  LoadReg(Address, pCell);
+  Value = *pCell;
+  *pCell = Saved;
+  return Value;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+static void Init(void)
+{
+  const char *pName;
+  FILE *pFile;
+
+  if (Initialized)
+  {
+    return;
+  }
+  Initialized = true;
+  ClockOrigin = ReadClock();
+
+  // reset values that matter to the code
+  IMU.Regs[IMU_WHO_AM_I] = 0x69;
+  IMU.Regs[0x12] = 0x04;             // CTRL3_C: IF_INC
+  IMU.Regs[0x2D] = 0x40;             // OUTZ_H_XL: 1g at +/-2g full scale
+  ADC0.Value[0] = ADC0.Value[1] = ADC0.Value[2] = ADC0.Value[3] = 1500;
+
+  pName = getenv("DOG_XBEE_TX");
+  if (pName != NULL)
+  {
+    XBeeTxFile = fopen(pName, "wb");
+    if (XBeeTxFile == NULL)
+    {
+      perror(pName);
+    }
+  }
+  pName = getenv("DOG_REPLAY");
+  if (pName != NULL)
+  {
+    ReplayLoad(pName);
+  }
+  pName = getenv("DOG_XBEE_RX");
+  if ((pName != NULL) && !Replay.Active)
+  {
+    pFile = fopen(pName, "rb");
+    if (pFile == NULL)
+    {
+      perror(pName);
+    }
+    else
+    {
+      uint8_t Buffer[256];
+      size_t Count;
+      while ((Count = fread(Buffer, 1, sizeof(Buffer), pFile)) > 0)
+      {
+        HostSim_XBeeRx(Buffer, Count);
+      }
+      fclose(pFile);
+    }
+  }
+}
+
+static uint64_t ReadClock(void)
+{
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+  return (uint64_t)Now.tv_sec * 1000000000ULL + (uint64_t)Now.tv_nsec;
+}
+
+static volatile uint32_t *Cell(uint32_t Address)
+{
+  if ((Address >= PERIPH_BASE) && (Address < PERIPH_BASE + PERIPH_SIZE))
+  {
+    return &PeriphRegs[(Address - PERIPH_BASE) >> 2];
+  }
+  if ((Address >= SCS_BASE) && (Address < SCS_BASE + SCS_SIZE))
+  {
+    return &ScsRegs[(Address - SCS_BASE) >> 2];
+  }
+  return &Unmapped;
+}
+
+static int GPIOPort(uint32_t Address)
+{
+  int i;
+
+  for (i = 0; i < NUM_GPIO_PORTS; i++)
+  {
+    if ((Address & ~0xFFFUL) == GPIOBase[i])
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static uint32_t Tag(void)
+{
+  uint32_t ThisTag = (uint32_t)NextTag << TAG_SHIFT;
+
+  NextTag = (NextTag % 127) + 1;
+  return ThisTag;
+}
+
+/*
+ put the current value of a register into its cell. Registers that are
+ nothing more than storage are left alone, the cell is the register.
+*/
+static void LoadReg(uint32_t Address, volatile uint32_t *pCell)
+{
+  uint64_t Now = HostSim_Now();
+  int Port;
+
+  switch (Address)
+  {
+    case UART4_BASE + UART_O_DR:
+      *pCell = Tag() | FifoPeek(&UART4.Rx);
+      break;
+    case UART4_BASE + UART_O_FR:
+      *pCell = ((UART4.Tx.Count == 0) ? UART_FR_TXFE : 0)
+             | ((UART4.Tx.Count >= UART4Depth()) ? UART_FR_TXFF : 0)
+             | ((UART4.Rx.Count == 0) ? UART_FR_RXFE : 0)
+             | ((UART4.Rx.Count >= UART4Depth()) ? UART_FR_RXFF : 0)
+             | ((UART4.Shifting || (UART4.Tx.Count != 0)) ? UART_FR_BUSY : 0);
+      break;
+    case UART4_BASE + UART_O_RIS:
+      *pCell = UART4.RIS;
+      break;
+    case UART4_BASE + UART_O_MIS:
+      *pCell = UART4.RIS & PeriphRegs[(UART4_BASE + UART_O_IM - PERIPH_BASE) >> 2];
+      break;
+    case UART4_BASE + UART_O_ICR:
+    case SSI1_BASE + SSI_O_ICR:
+    case TIMER5_BASE + TIMER_O_ICR:
+    case WATCHDOG0_BASE + WDT_O_ICR:
+      *pCell = 0;
+      break;
+
+    case SSI1_BASE + SSI_O_DR:
+      *pCell = Tag() | FifoPeek(&SSI1.Rx);
+      break;
+    case SSI1_BASE + SSI_O_SR:
+      *pCell = ((SSI1.Tx.Count == 0) ? SSI_SR_TFE : 0)
+             | ((SSI1.Tx.Count < SSI_FIFO_DEPTH) ? SSI_SR_TNF : 0)
+             | ((SSI1.Rx.Count != 0) ? SSI_SR_RNE : 0)
+             | ((SSI1.Rx.Count >= SSI_FIFO_DEPTH) ? SSI_SR_RFF : 0)
+             | ((SSI1.Busy || (SSI1.Tx.Count != 0)) ? SSI_SR_BSY : 0);
+      break;
+    case SSI1_BASE + SSI_O_RIS:
+      *pCell = SSI1RawInts();
+      break;
+    case SSI1_BASE + SSI_O_MIS:
+      *pCell = SSI1RawInts() & PeriphRegs[(SSI1_BASE + SSI_O_IM - PERIPH_BASE) >> 2];
+      break;
+
+    case TIMER5_BASE + TIMER_O_RIS:
+      *pCell = Timer5.RIS;
+      break;
+    case TIMER5_BASE + TIMER_O_MIS:
+      *pCell = Timer5.RIS & PeriphRegs[(TIMER5_BASE + TIMER_O_IMR - PERIPH_BASE) >> 2];
+      break;
+    case TIMER5_BASE + TIMER_O_TAV:
+    case TIMER5_BASE + TIMER_O_TBV:
+    {
+      int Which = (Address == TIMER5_BASE + TIMER_O_TAV) ? 0 : 1;
+      uint32_t Prescale = PeriphRegs[(TIMER5_BASE + TIMER_O_TAPR + 4 * Which - PERIPH_BASE) >> 2] & 0xFF;
+      uint64_t Left = (Timer5.Deadline[Which] > Now) ? (Timer5.Deadline[Which] - Now) : 0;
+      *pCell = (uint32_t)(Left / HOSTSIM_NS_PER_CYCLE / (Prescale + 1));
+      break;
+    }
+
+    case WATCHDOG0_BASE + WDT_O_VALUE:
+      *pCell = (Watchdog.Deadline > Now) ?
+               (uint32_t)((Watchdog.Deadline - Now) / HOSTSIM_NS_PER_CYCLE) : 0;
+      break;
+    case WATCHDOG0_BASE + WDT_O_RIS:
+    case WATCHDOG0_BASE + WDT_O_MIS:
+      *pCell = Watchdog.RIS;
+      break;
+
+    case ADC0_BASE + ADC_O_RIS:
+      *pCell = ADC0.RIS;
+      break;
+    case ADC0_BASE + ADC_O_ISC:
+      *pCell = ADC0.RIS & PeriphRegs[(ADC0_BASE + ADC_O_IM - PERIPH_BASE) >> 2];
+      break;
+    case ADC0_BASE + ADC_O_SSFIFO2:
+      *pCell = Tag() | FifoPeek(&ADC0.Fifo);
+      break;
+    case ADC0_BASE + ADC_O_SSFSTAT2:
+      *pCell = (ADC0.Fifo.Count == 0) ? 0x100 : ADC0.Fifo.Count;
+      break;
+
+    case NVIC_ST_CTRL:
+      *pCell = (*pCell & ~NVIC_ST_CTRL_COUNT) | (SysTickCountFlag ? NVIC_ST_CTRL_COUNT : 0);
+      break;
+    case NVIC_INT_CTRL:
+      *pCell = ((SysTickPending != 0) ? NVIC_INT_CTRL_PENDSTSET : 0) |
+               (PendSVPending ? NVIC_INT_CTRL_PEND_SV : 0);
+      break;
+    case NVIC_ST_CURRENT:
+    {
+      uint64_t Left = (NextTick > Now) ? (NextTick - Now) : 0;
+      *pCell = (uint32_t)(Left / HOSTSIM_NS_PER_CYCLE) & 0x00FFFFFF;
+      break;
+    }
+    case DWT_CYCCNT:
+      *pCell = (uint32_t)(Now / HOSTSIM_NS_PER_CYCLE - CycleOrigin);
+      break;
+
+    default:
+      if ((Address >= NVIC_EN0) && (Address < NVIC_EN0 + 4 * 5))
+      {
+        *pCell = NvicEnabled[(Address - NVIC_EN0) >> 2];
+      }
+      else if ((Address >= NVIC_DIS0) && (Address < NVIC_DIS0 + 4 * 5))
+      {
+        *pCell = NvicEnabled[(Address - NVIC_DIS0) >> 2];
+      }
+      else if ((Address >= SYSCTL_PR_BASE) && (Address < SYSCTL_PR_BASE + 0x100))
+      {
+        // peripherals are ready as soon as their clock is turned on
+        *pCell = PeriphRegs[(Address - 0x400 - PERIPH_BASE) >> 2];
+      }
+      else if (((Port = GPIOPort(Address)) >= 0) && ((Address & 0xFFF) < GPIO_O_DIR))
+      {
+        // address bits 9:2 mask the data register
+        *pCell = GPIOData[Port] & ((Address >> 2) & 0xFF);
+      }
+      break;
+  }
+}
+
+static void CommitAccess(void)
+{
+  uint32_t Value;
+
+  if (!Access.Pending)
+  {
+    return;
+  }
+  Access.Pending = false;
+  Value = *Access.pCell;
+  if (Value == Access.Loaded)
+  {
+    OnRead(Access.Address);
+  }
+  else
+  {
+    OnWrite(Access.Address, Access.Loaded, Value);
+  }
+}
+
+static void OnRead(uint32_t Address)
+{
+  uint64_t Now = HostSim_Now();
+
+  switch (Address)
+  {
+    case UART4_BASE + UART_O_DR:
+      UART4Read(Now);
+      break;
+    case SSI1_BASE + SSI_O_DR:
+      FifoGet(&SSI1.Rx);
+      break;
+    case ADC0_BASE + ADC_O_SSFIFO2:
+      FifoGet(&ADC0.Fifo);
+      break;
+    case NVIC_ST_CTRL:
+      SysTickCountFlag = false;
+      break;
+    default:
+      break;
+  }
+}
+
+static void OnWrite(uint32_t Address, uint32_t OldValue, uint32_t NewValue)
+{
+  uint64_t Now = HostSim_Now();
+  int Port;
+
+  switch (Address)
+  {
+    case UART4_BASE + UART_O_DR:
+      UART4Write((uint8_t)NewValue, Now);
+      break;
+    case UART4_BASE + UART_O_ICR:
+      UART4.RIS &= ~NewValue;
+      break;
+    case UART4_BASE + UART_O_CTL:
+      if ((NewValue & UART_CTL_UARTEN) && !(OldValue & UART_CTL_UARTEN))
+      {
+        UART4.LastRxActivity = Now;
+      }
+      UART4Sync(Now);
+      break;
+
+    case SSI1_BASE + SSI_O_DR:
+      FifoPut(&SSI1.Tx, (uint16_t)(NewValue & SSI_DR_DATA_M), SSI_FIFO_DEPTH);
+      SSI1Sync(Now);
+      break;
+    case SSI1_BASE + SSI_O_ICR:
+      if (NewValue & SSI_ICR_RORIC)
+      {
+        SSI1.Overrun = false;
+      }
+      break;
+
+    case TIMER5_BASE + TIMER_O_CTL:
+      if ((NewValue & TIMER_CTL_TAEN) && !(OldValue & TIMER_CTL_TAEN))
+      {
+        Timer5Start(0, Now);
+      }
+      if ((NewValue & TIMER_CTL_TBEN) && !(OldValue & TIMER_CTL_TBEN))
+      {
+        Timer5Start(1, Now);
+      }
+      break;
+    case TIMER5_BASE + TIMER_O_ICR:
+      Timer5.RIS &= ~NewValue;
+      break;
+
+    case WATCHDOG0_BASE + WDT_O_CTL:
+      if ((NewValue & WDT_CTL_INTEN) && !(OldValue & WDT_CTL_INTEN))
+      {
+        Watchdog.Running = true;
+        Watchdog.Deadline = Now + WatchdogPeriod();
+      }
+      break;
+    case WATCHDOG0_BASE + WDT_O_ICR:
+      // any write clears the time-out and reloads the count
+      Watchdog.RIS = 0;
+      Watchdog.Deadline = Now + WatchdogPeriod();
+      break;
+    case WATCHDOG0_BASE + WDT_O_LOAD:
+      Watchdog.Deadline = Now + WatchdogPeriod();
+      break;
+
+    case ADC0_BASE + ADC_O_ISC:
+      ADC0.RIS &= ~NewValue;
+      break;
+    case ADC0_BASE + ADC_O_PSSI:
+      ADC0Trigger(NewValue);
+      break;
+
+    case NVIC_ST_CTRL:
+      if ((NewValue & NVIC_ST_CTRL_ENABLE) && !(OldValue & NVIC_ST_CTRL_ENABLE))
+      {
+        NextTick = Now + SysTickPeriod();
+      }
+      break;
+    case NVIC_ST_CURRENT:
+      // any write clears the counter and COUNTFLAG, and it reloads
+      SysTickCountFlag = false;
+      NextTick = Now + SysTickPeriod();
+      break;
+    case DWT_CYCCNT:
+      CycleOrigin = Now / HOSTSIM_NS_PER_CYCLE - NewValue;
+      break;
+    case NVIC_INT_CTRL:
+      if (NewValue & NVIC_INT_CTRL_PEND_SV)
+      {
+        PendSVPending = true;
+      }
+      if (NewValue & NVIC_INT_CTRL_UNPEND_SV)
+      {
+        PendSVPending = false;
+      }
+      break;
+
+    default:
+      if ((Address >= NVIC_EN0) && (Address < NVIC_EN0 + 4 * 5))
+      {
+        NvicEnabled[(Address - NVIC_EN0) >> 2] |= NewValue;
+      }
+      else if ((Address >= NVIC_DIS0) && (Address < NVIC_DIS0 + 4 * 5))
+      {
+        NvicEnabled[(Address - NVIC_DIS0) >> 2] &= ~NewValue;
+      }
+      else if (((Port = GPIOPort(Address)) >= 0) && ((Address & 0xFFF) < GPIO_O_DIR))
+      {
+        uint32_t Mask = (Address >> 2) & 0xFF;
+        GPIOData[Port] = (GPIOData[Port] & ~Mask) | (NewValue & Mask);
+      }
+      break;
+  }
+}
+
+static void SyncPeripherals(void)
+{
+  uint64_t Now = HostSim_Now();
+
+  SysTickSync(Now);
+  UART4Sync(Now);
+  SSI1Sync(Now);
+  Timer5Sync(Now);
+  WatchdogSync(Now);
+  ReplaySync(Now);
+}
+
+static bool IRQEnabled(uint32_t IRQ)
+{
+  return (NvicEnabled[IRQ / 32] & (1UL << (IRQ % 32))) != 0;
+}
+
+static void RunISR(void (*pISR)(void), const char *pName)
+{
+  if (pISR == NULL)
+  {
+    // on the target this would land in IntDefaultHandler and hang there
+    fprintf(stderr, "HostSim: %s is pending but there is no handler\n", pName);
+    exit(EXIT_FAILURE);
+  }
+  InISR = true;
+  pISR();
+  CommitAccess();
+  InISR = false;
+}
+
+/*
+ the highest priority interrupt that is pending and enabled in the NVIC:
+ SysTick first, then the IRQs in vector order, then PendSV
+*/
+static int HighestPending(void)
+{
+  if (SysTickPending != 0)
+  {
+    return 0;
+  }
+  if (IRQEnabled(IRQ_SSI1) &&
+      (SSI1RawInts() & PeriphRegs[(SSI1_BASE + SSI_O_IM - PERIPH_BASE) >> 2]))
+  {
+    return 1;
+  }
+  if (IRQEnabled(IRQ_UART4) &&
+      (UART4.RIS & PeriphRegs[(UART4_BASE + UART_O_IM - PERIPH_BASE) >> 2]))
+  {
+    return 2;
+  }
+  if (IRQEnabled(IRQ_TIMER5A) && (Timer5.RIS & 0x1F &
+      PeriphRegs[(TIMER5_BASE + TIMER_O_IMR - PERIPH_BASE) >> 2]))
+  {
+    return 3;
+  }
+  if (IRQEnabled(IRQ_TIMER5B) && (Timer5.RIS & 0xF00 &
+      PeriphRegs[(TIMER5_BASE + TIMER_O_IMR - PERIPH_BASE) >> 2]))
+  {
+    return 4;
+  }
+  if (PendSVPending)
+  {
+    return 5;
+  }
+  return -1;
+}
+
+static void TakePendingInterrupts(void)
+{
+  int Source;
+
+  if (InISR)
+  {
+    return;
+  }
+  for (;;)
+  {
+    SyncPeripherals();
+    Source = HighestPending();
+    if (PRIMASK != 0)
+    {
+      // remember so that clearing PRIMASK takes it straight away
+      PendingWhileMasked = (Source >= 0);
+      return;
+    }
+    if ((Source >= 0) && (Source < NUM_SOURCES))
+    {
+      ReplayCheck(Source, HostSim_Now());
+    }
+    switch (Source)
+    {
+      case 0:
+        SysTickPending--;
+        RunISR(SysTickIntHandler, "SysTick");
+        break;
+      case 1:
+        RunISR(SPI_ISR, "SSI1");
+        break;
+      case 2:
+        RunISR(UART_ISR, "UART4");
+        break;
+      case 3:
+        RunISR(ShortTimerAHandler, "Timer5A");
+        break;
+      case 4:
+        RunISR(ShortTimerBHandler, "Timer5B");
+        break;
+      case 5:
+        // not through RunISR: the handler runs the preempting services in
+        // thread context, where the ISRs can still come in
+        PendSVPending = false;
+        if (PendSV_Handler == NULL)
+        {
+          fprintf(stderr, "HostSim: PendSV is pending but there is no handler\n");
+          exit(EXIT_FAILURE);
+        }
+        PendSV_Handler();
+        break;
+      default:
+        return;
+    }
+  }
+}
+
+/*------------------------------- FIFOs -----------------------------------*/
+static bool FifoPut(Fifo_t *pFifo, uint16_t Value, uint8_t Depth)
+{
+  if (pFifo->Count >= Depth)
+  {
+    return false;
+  }
+  pFifo->Data[(pFifo->Head + pFifo->Count) % FIFO_DEPTH] = Value;
+  pFifo->Count++;
+  return true;
+}
+
+static uint16_t FifoPeek(const Fifo_t *pFifo)
+{
+  return (pFifo->Count != 0) ? pFifo->Data[pFifo->Head] : 0;
+}
+
+static uint16_t FifoGet(Fifo_t *pFifo)
+{
+  uint16_t Value = FifoPeek(pFifo);
+
+  if (pFifo->Count != 0)
+  {
+    pFifo->Head = (pFifo->Head + 1) % FIFO_DEPTH;
+    pFifo->Count--;
+  }
+  return Value;
+}
+
+/*------------------------------- UART4 -----------------------------------*/
+static uint32_t UART4Reg(uint32_t Offset)
+{
+  return PeriphRegs[(UART4_BASE + Offset - PERIPH_BASE) >> 2];
+}
+
+/*
+ time for one 10 bit character: the baud rate divisor is in units of
+ 16 clocks, with a 6 bit fraction
+*/
+static uint64_t UART4CharTime(void)
+{
+  uint64_t Divisor = ((uint64_t)(UART4Reg(UART_O_IBRD) & 0xFFFF) << 6)
+                   | (UART4Reg(UART_O_FBRD) & 0x3F);
+
+  if (Divisor == 0)
+  {
+    Divisor = (0x104 << 6) | 0x1B;     // 9600 baud at 40MHz
+  }
+  return (10 * 16 * Divisor * HOSTSIM_NS_PER_CYCLE) >> 6;
+}
+
+static uint8_t UART4Depth(void)
+{
+  return (UART4Reg(UART_O_LCRH) & UART_LCRH_FEN) ? FIFO_DEPTH : 1;
+}
+
+static uint8_t FifoLevel(uint32_t Select)
+{
+  static const uint8_t Levels[] = { 2, 4, 8, 12, 14 };
+
+  return (Select < sizeof(Levels)) ? Levels[Select] : 14;
+}
+
+static uint8_t UART4RxTrigger(void)
+{
+  if (UART4Depth() == 1)
+  {
+    return 1;
+  }
+  return FifoLevel((UART4Reg(UART_O_IFLS) & UART_IFLS_RX_M) >> 3);
+}
+
+static uint8_t UART4TxTrigger(void)
+{
+  if (UART4Depth() == 1)
+  {
+    return 0;
+  }
+  return FifoLevel(UART4Reg(UART_O_IFLS) & UART_IFLS_TX_M);
+}
+
+static void UART4Sync(uint64_t Now)
+{
+  uint32_t Ctl = UART4Reg(UART_O_CTL);
+  uint64_t CharTime = UART4CharTime();
+  uint64_t StartTime = Now;
+
+  if (!(Ctl & UART_CTL_UARTEN))
+  {
+    // nothing moves on a disabled UART; hold back anything in flight
+    if (UART4.InNext < UART4.InLength)
+    {
+      UART4.NextArrival = Now + CharTime;
+    }
+    return;
+  }
+
+  // transmit side: the shifter takes from the FIFO back to back
+  for (;;)
+  {
+    if (UART4.Shifting)
+    {
+      if (Now < UART4.ShiftDone)
+      {
+        break;
+      }
+      UART4.Shifting = false;
+      StartTime = UART4.ShiftDone;
+      if (XBeeTxHook != NULL)
+      {
+        XBeeTxHook(UART4.ShiftByte);
+      }
+      if (XBeeTxFile != NULL)
+      {
+        fputc(UART4.ShiftByte, XBeeTxFile);
+        fflush(XBeeTxFile);
+      }
+      if ((Ctl & UART_CTL_EOT) && (UART4.Tx.Count == 0))
+      {
+        UART4.RIS |= UART_RIS_TXRIS;
+      }
+    }
+    if ((UART4.Tx.Count == 0) || !(Ctl & UART_CTL_TXE))
+    {
+      break;
+    }
+    UART4.ShiftByte = (uint8_t)FifoGet(&UART4.Tx);
+    UART4.Shifting = true;
+    UART4.ShiftDone = StartTime + CharTime;
+    if (!(Ctl & UART_CTL_EOT) && (UART4.Tx.Count <= UART4TxTrigger()))
+    {
+      UART4.RIS |= UART_RIS_TXRIS;
+    }
+  }
+
+  // receive side
+  if (!(Ctl & UART_CTL_RXE))
+  {
+    if (UART4.InNext < UART4.InLength)
+    {
+      UART4.NextArrival = Now + CharTime;
+    }
+    return;
+  }
+  while ((UART4.InNext < UART4.InLength) && (UART4.NextArrival <= Now))
+  {
+    UART4Arrive(UART4.pIn[UART4.InNext], UART4.NextArrival);
+    UART4.InNext++;
+    UART4.NextArrival += CharTime;
+  }
+  {
+    uint8_t Byte;
+    uint64_t At;
+    while (ReplayRx(Now, &Byte, &At))
+    {
+      UART4Arrive(Byte, At);
+    }
+  }
+  // receive timeout after 32 bit periods of quiet with data in the FIFO
+  if ((UART4.Rx.Count != 0) && (Now - UART4.LastRxActivity >= (CharTime * 32) / 10))
+  {
+    UART4.RIS |= UART_RIS_RTRIS;
+  }
+}
+
+// a byte has come in on the RX pin
+static void UART4Arrive(uint8_t Byte, uint64_t At)
+{
+  if (FifoPut(&UART4.Rx, Byte, UART4Depth()))
+  {
+    if (UART4.Rx.Count == UART4RxTrigger())
+    {
+      UART4.RIS |= UART_RIS_RXRIS;
+    }
+  }
+  else
+  {
+    UART4.RIS |= UART_RIS_OERIS;
+  }
+  UART4.LastRxActivity = At;
+}
+
+static void UART4Write(uint8_t Byte, uint64_t Now)
+{
+  uint32_t Ctl = UART4Reg(UART_O_CTL);
+
+  UART4Sync(Now);
+  FifoPut(&UART4.Tx, Byte, UART4Depth());
+  if (!(Ctl & UART_CTL_EOT) && (UART4.Tx.Count > UART4TxTrigger()))
+  {
+    UART4.RIS &= ~UART_RIS_TXRIS;
+  }
+  UART4Sync(Now);
+}
+
+static void UART4Read(uint64_t Now)
+{
+  FifoGet(&UART4.Rx);
+  UART4.LastRxActivity = Now;
+  if (UART4.Rx.Count < UART4RxTrigger())
+  {
+    UART4.RIS &= ~UART_RIS_RXRIS;
+  }
+  if (UART4.Rx.Count == 0)
+  {
+    UART4.RIS &= ~UART_RIS_RTRIS;
+  }
+}
+
+/*------------------------------- SSI1 ------------------------------------*/
+static uint32_t SSI1Reg(uint32_t Offset)
+{
+  return PeriphRegs[(SSI1_BASE + Offset - PERIPH_BASE) >> 2];
+}
+
+static uint64_t SSI1FrameTime(void)
+{
+  uint32_t Cr0 = SSI1Reg(SSI_O_CR0);
+  uint64_t Prescale = SSI1Reg(SSI_O_CPSR) & SSI_CPSR_CPSDVSR_M;
+  uint64_t Bits = (Cr0 & SSI_CR0_DSS_M) + 1;
+  uint64_t Scr = (Cr0 & SSI_CR0_SCR_M) >> 8;
+
+  if (Prescale < 2)
+  {
+    Prescale = 2;
+  }
+  if (Bits < 4)
+  {
+    Bits = 8;
+  }
+  return Bits * Prescale * (1 + Scr) * HOSTSIM_NS_PER_CYCLE;
+}
+
+static uint32_t SSI1RawInts(void)
+{
+  uint32_t RIS = 0;
+
+  if (SSI1Reg(SSI_O_CR1) & SSI_CR1_EOT)
+  {
+    if ((SSI1.Tx.Count == 0) && !SSI1.Busy)
+    {
+      RIS |= SSI_RIS_TXRIS;
+    }
+  }
+  else if (SSI1.Tx.Count <= SSI_FIFO_DEPTH / 2)
+  {
+    RIS |= SSI_RIS_TXRIS;
+  }
+  if (SSI1.Rx.Count >= SSI_FIFO_DEPTH / 2)
+  {
+    RIS |= SSI_RIS_RXRIS;
+  }
+  if (SSI1.Overrun)
+  {
+    RIS |= SSI_RIS_RORRIS;
+  }
+  return RIS;
+}
+
+static void SSI1Sync(uint64_t Now)
+{
+  uint64_t StartTime = Now;
+
+  if (!(SSI1Reg(SSI_O_CR1) & SSI_CR1_SSE))
+  {
+    return;
+  }
+  for (;;)
+  {
+    if (SSI1.Busy)
+    {
+      if (Now < SSI1.ShiftDone)
+      {
+        break;
+      }
+      SSI1.Busy = false;
+      StartTime = SSI1.ShiftDone;
+      if (!FifoPut(&SSI1.Rx, IMUExchange(SSI1.ShiftByte), SSI_FIFO_DEPTH))
+      {
+        SSI1.Overrun = true;
+      }
+    }
+    if (SSI1.Tx.Count == 0)
+    {
+      // FSS goes high once the FIFO runs dry, ending the IMU transaction
+      IMU.InTransaction = false;
+      break;
+    }
+    SSI1.ShiftByte = (uint8_t)FifoGet(&SSI1.Tx);
+    SSI1.Busy = true;
+    SSI1.ShiftDone = StartTime + SSI1FrameTime();
+  }
+}
+
+/*
+ LSM6DS3 SPI protocol: the first byte of a transaction is the register
+ address with bit 7 set for a read, the following bytes read or write
+ successive registers
+*/
+static uint8_t IMUExchange(uint8_t Byte)
+{
+  uint8_t Response = 0;
+
+  if (!IMU.InTransaction)
+  {
+    IMU.InTransaction = true;
+    IMU.Reading = (Byte & 0x80) != 0;
+    IMU.Address = Byte & 0x7F;
+    return 0;
+  }
+  if (IMU.Reading)
+  {
+    Response = IMU.Regs[IMU.Address];
+  }
+  else if (IMU.Address != IMU_WHO_AM_I)
+  {
+    IMU.Regs[IMU.Address] = Byte;
+  }
+  IMU.Address = (IMU.Address + 1) & 0x7F;
+  return Response;
+}
+
+/*------------------------------- Timer5 ----------------------------------*/
+static uint32_t Timer5Reg(uint32_t Offset)
+{
+  return PeriphRegs[(TIMER5_BASE + Offset - PERIPH_BASE) >> 2];
+}
+
+static uint64_t Timer5Period(int Which)
+{
+  uint64_t Load = Timer5Reg(TIMER_O_TAILR + 4 * Which);
+  uint64_t Prescale = Timer5Reg(TIMER_O_TAPR + 4 * Which) & 0xFF;
+
+  // split (16 bit) mode uses the prescaler as a true prescaler
+  if (Timer5Reg(TIMER_O_CFG) == 0x4)
+  {
+    Load &= 0xFFFF;
+  }
+  return (Load + 1) * (Prescale + 1) * HOSTSIM_NS_PER_CYCLE;
+}
+
+static void Timer5Start(int Which, uint64_t Now)
+{
+  Timer5.Deadline[Which] = Now + Timer5Period(Which);
+}
+
+static void Timer5Sync(uint64_t Now)
+{
+  static const uint32_t Enable[2] = { TIMER_CTL_TAEN, TIMER_CTL_TBEN };
+  static const uint32_t Timeout[2] = { TIMER_RIS_TATORIS, TIMER_RIS_TBTORIS };
+  uint32_t *pCtl = &PeriphRegs[(TIMER5_BASE + TIMER_O_CTL - PERIPH_BASE) >> 2];
+  int Which;
+
+  for (Which = 0; Which < 2; Which++)
+  {
+    if ((*pCtl & Enable[Which]) && (Now >= Timer5.Deadline[Which]))
+    {
+      Timer5.RIS |= Timeout[Which];
+      if ((Timer5Reg(TIMER_O_TAMR + 4 * Which) & 0x3) == 0x1)
+      {
+        *pCtl &= ~Enable[Which];         // one-shot stops at zero
+      }
+      else
+      {
+        Timer5.Deadline[Which] += Timer5Period(Which);
+      }
+    }
+  }
+}
+
+/*------------------------------- Watchdog --------------------------------*/
+static uint64_t WatchdogPeriod(void)
+{
+  return (uint64_t)PeriphRegs[(WATCHDOG0_BASE + WDT_O_LOAD - PERIPH_BASE) >> 2]
+         * HOSTSIM_NS_PER_CYCLE;
+}
+
+static void WatchdogSync(uint64_t Now)
+{
+  uint32_t Ctl = PeriphRegs[(WATCHDOG0_BASE + WDT_O_CTL - PERIPH_BASE) >> 2];
+  uint64_t Period = WatchdogPeriod();
+
+  if (!Watchdog.Running || (Period == 0))
+  {
+    return;
+  }
+  while (Now >= Watchdog.Deadline)
+  {
+    if ((Watchdog.RIS != 0) && (Ctl & WDT_CTL_RESEN))
+    {
+      fprintf(stderr, "HostSim: watchdog reset\n");
+      exit(EXIT_FAILURE);
+    }
+    Watchdog.RIS = WDT_RIS_WDTRIS;
+    Watchdog.Deadline += Period;
+  }
+}
+
+/*------------------------------- SysTick ---------------------------------*/
+static uint64_t SysTickPeriod(void)
+{
+  uint32_t Reload = ScsRegs[(NVIC_ST_RELOAD - SCS_BASE) >> 2] & 0x00FFFFFF;
+
+  return (Reload == 0) ? 0 : ((uint64_t)Reload + 1) * HOSTSIM_NS_PER_CYCLE;
+}
+
+static void SysTickSync(uint64_t Now)
+{
+  uint32_t Ctl = ScsRegs[(NVIC_ST_CTRL - SCS_BASE) >> 2];
+  uint64_t Period = SysTickPeriod();
+
+  if (!(Ctl & NVIC_ST_CTRL_ENABLE) || (Period == 0))
+  {
+    return;
+  }
+  while (Now >= NextTick)
+  {
+    SysTickCountFlag = true;
+    if (Ctl & NVIC_ST_CTRL_INTEN)
+    {
+      SysTickPending++;
+    }
+    NextTick += Period;
+  }
+}
+
+/*-------------------------------- ADC0 -----------------------------------*/
+static void ADC0Trigger(uint32_t Sequencers)
+{
+  uint32_t Ctl;
+  int Step;
+
+  if (!(Sequencers & 0x4))
+  {
+    return;
+  }
+  // conversions are instantaneous: fill the FIFO up to the END step
+  Ctl = PeriphRegs[(ADC0_BASE + ADC_O_SSCTL2 - PERIPH_BASE) >> 2];
+  for (Step = 0; Step < 4; Step++)
+  {
+    FifoPut(&ADC0.Fifo, ADC0.Value[Step], 4);
+    if (Ctl & (0x2UL << (4 * Step)))
+    {
+      break;
+    }
+  }
+  ADC0.RIS |= 0x4;
+}
+
+/*------------------------------- replay ----------------------------------*/
+// reads a recording (ES_TRACE_INPUTS) out of a console capture and switches
+// to virtual time to replay it
+static void ReplayLoad(const char *pName)
+{
+  FILE *pFile = fopen(pName, "rb");
+  uint8_t Frame[TRACE_FRAME_LENGTH];
+  size_t Have = 0;
+  uint32_t LastTime = 0;
+  bool HaveTime = false;
+  Input_t Input;
+  int Byte;
+  int Source;
+  uint8_t Sum;
+  uint8_t CheckSum;
+  int i;
+
+  if (pFile == NULL)
+  {
+    perror(pName);
+    exit(EXIT_FAILURE);
+  }
+  Input.Cycle = 0;
+  // a sliding window over the capture, which can hold any amount of printf
+  // output between the frames
+  while ((Byte = fgetc(pFile)) != EOF)
+  {
+    if ((Have == 0) && (Byte != TRACE_FRAME_START))
+    {
+      continue;
+    }
+    Frame[Have++] = (uint8_t)Byte;
+    if (Have < TRACE_FRAME_LENGTH)
+    {
+      continue;
+    }
+    for (Sum = 0, i = 1; i < TRACE_FRAME_LENGTH - 1; i++)
+    {
+      Sum += Frame[i];
+    }
+    CheckSum = 0xFF - Sum;
+    if (CheckSum != Frame[TRACE_FRAME_LENGTH - 1])
+    {
+      // not a frame after all: look for the next start byte in what was read
+      for (i = 1; (i < TRACE_FRAME_LENGTH) && (Frame[i] != TRACE_FRAME_START); i++)
+      {
+      }
+      Have = TRACE_FRAME_LENGTH - i;
+      memmove(Frame, Frame + i, Have);
+      continue;
+    }
+    Have = 0;
+    if (Frame[1] == TRACE_LOST)
+    {
+      fprintf(stderr, "HostSim: %u records were lost from %s, replaying up to "
+              "there\n", (unsigned)(Frame[3] | (Frame[4] << 8)), pName);
+      break;
+    }
+    if ((Frame[1] != TRACE_ISR) && (Frame[1] != TRACE_INPUT))
+    {
+      continue;
+    }
+    {
+      uint32_t Time = Frame[5] | (Frame[6] << 8) | (Frame[7] << 16) |
+                      ((uint32_t)Frame[8] << 24);
+      // the cycle count wraps every 107s at 40MHz
+      if (HaveTime)
+      {
+        Input.Cycle += (uint32_t)(Time - LastTime);
+      }
+      else
+      {
+        Input.Cycle = Time;
+      }
+      LastTime = Time;
+      HaveTime = true;
+    }
+    Input.Interrupt = Frame[2];
+    Input.Byte = Frame[3];
+    if (Frame[1] == TRACE_INPUT)
+    {
+      if ((Input.Interrupt == INT_NUM_UART4) &&
+          !ReplayAdd(&Replay.pRx, &Replay.NumRx, &Input))
+      {
+        break;
+      }
+    }
+    else if (!ReplayAdd(&Replay.pISR, &Replay.NumISR, &Input))
+    {
+      break;
+    }
+    Replay.LastCycle = Input.Cycle;
+  }
+  fclose(pFile);
+
+  if ((Replay.NumRx == 0) && (Replay.NumISR == 0))
+  {
+    fprintf(stderr, "HostSim: no recorded inputs in %s\n", pName);
+    exit(EXIT_FAILURE);
+  }
+  for (Source = 0; Source < NUM_SOURCES; Source++)
+  {
+    Replay.Next[Source] = ReplayNextISR(Source, 0);
+    for (i = 0; (size_t)i < Replay.NumISR; i++)
+    {
+      if (Replay.pISR[i].Interrupt == Sources[Source].Interrupt)
+      {
+        Replay.Recorded[Source]++;
+      }
+    }
+  }
+  Replay.Active = true;
+  Replay.HostStart = ReadClock();
+  VirtualTime = true;
+  VirtualNow = 0;
+}
+
+static bool ReplayAdd(Input_t **ppList, size_t *pCount, const Input_t *pInput)
+{
+  // 256 to start with, doubling each time it fills
+  if ((*pCount == 0) || ((*pCount >= 256) && ((*pCount & (*pCount - 1)) == 0)))
+  {
+    Input_t *pList = realloc(*ppList, (*pCount ? 2 * *pCount : 256) * sizeof(Input_t));
+    if (pList == NULL)
+    {
+      fprintf(stderr, "HostSim: out of memory for the replay\n");
+      return false;
+    }
+    *ppList = pList;
+  }
+  (*ppList)[(*pCount)++] = *pInput;
+  return true;
+}
+
+// the index of the first recorded interrupt response from Source at or
+// after From, or NumISR if there are no more
+static size_t ReplayNextISR(int Source, size_t From)
+{
+  while ((From < Replay.NumISR) &&
+         (Replay.pISR[From].Interrupt != Sources[Source].Interrupt))
+  {
+    From++;
+  }
+  return From;
+}
+
+// the simulated time of a recorded cycle count: the recording counts from
+// when ES_Initialize zeroed the cycle counter, and so does CycleOrigin
+static uint64_t ReplayTime(uint64_t Cycle)
+{
+  return (CycleOrigin + Cycle) * HOSTSIM_NS_PER_CYCLE;
+}
+
+// the next recorded byte for UART4, if its time has come
+static bool ReplayRx(uint64_t Now, uint8_t *pByte, uint64_t *pAt)
+{
+  uint64_t At;
+
+  if (!Replay.Active || (Replay.NextRx >= Replay.NumRx))
+  {
+    return false;
+  }
+  At = ReplayTime(Replay.pRx[Replay.NextRx].Cycle);
+  if (At > Now)
+  {
+    return false;
+  }
+  *pByte = Replay.pRx[Replay.NextRx++].Byte;
+  *pAt = At;
+  return true;
+}
+
+// an interrupt from Source is being taken: match it with the recorded one
+// nearest in time. Recorded ones left behind never happened in the replay
+static void ReplayCheck(int Source, uint64_t Now)
+{
+  size_t i;
+  uint64_t Recorded = 0;
+  uint64_t Drift;
+
+  if (!Replay.Active ||
+      (Now > ReplayTime(Replay.LastCycle) + REPLAY_TOLERANCE_NS))
+  {
+    // past the end of the recording there is nothing to compare with
+    return;
+  }
+  Replay.Taken[Source]++;
+  for (i = Replay.Next[Source]; i < Replay.NumISR; i = ReplayNextISR(Source, i + 1))
+  {
+    Recorded = ReplayTime(Replay.pISR[i].Cycle);
+    if (Recorded + REPLAY_TOLERANCE_NS >= Now)
+    {
+      break;
+    }
+    ReplayDiverged(Source, Recorded, "recorded, but not in the replay");
+  }
+  Replay.Next[Source] = i;
+  if ((i >= Replay.NumISR) || (Recorded > Now + REPLAY_TOLERANCE_NS))
+  {
+    ReplayDiverged(Source, Now, "in the replay, but not recorded");
+    return;
+  }
+  Replay.Next[Source] = ReplayNextISR(Source, i + 1);
+  Replay.Matched[Source]++;
+  Drift = (Now > Recorded) ? (Now - Recorded) : (Recorded - Now);
+  if (Drift > Replay.MaxDrift[Source])
+  {
+    Replay.MaxDrift[Source] = Drift;
+  }
+}
+
+// keeps the first divergence for the summary
+static void ReplayDiverged(int Source, uint64_t When, const char *pWhat)
+{
+  if (Replay.Diverged)
+  {
+    return;
+  }
+  Replay.Diverged = true;
+  snprintf(Replay.Divergence, sizeof(Replay.Divergence), "%s at %.3fms, %s",
+           Sources[Source].pName, (When - ReplayTime(0)) / 1000000.0, pWhat);
+}
+
+// ends the run once the recording has been played out, with the summary
+static void ReplaySync(uint64_t Now)
+{
+  int Source;
+
+  if (!Replay.Active || (Replay.NextRx < Replay.NumRx) ||
+      (Now < ReplayTime(Replay.LastCycle) + REPLAY_TAIL_NS))
+  {
+    return;
+  }
+  Replay.Active = false;
+  for (Source = 0; Source < NUM_SOURCES; Source++)
+  {
+    if (Replay.Next[Source] < Replay.NumISR)
+    {
+      ReplayDiverged(Source, ReplayTime(Replay.pISR[Replay.Next[Source]].Cycle),
+                     "recorded, but not in the replay");
+    }
+  }
+  fprintf(stderr, "HostSim: replayed %u bytes and %u interrupts, %.3fs of "
+          "recording in %.3fs\n", (unsigned)Replay.NumRx,
+          (unsigned)Replay.NumISR, Replay.LastCycle * HOSTSIM_NS_PER_CYCLE / 1e9,
+          (ReadClock() - Replay.HostStart) / 1e9);
+  for (Source = 0; Source < NUM_SOURCES; Source++)
+  {
+    if ((Replay.Recorded[Source] != 0) || (Replay.Taken[Source] != 0))
+    {
+      fprintf(stderr, "  %-8s recorded %6u  replayed %6u  matched %6u  "
+              "max drift %.1fus\n", Sources[Source].pName,
+              (unsigned)Replay.Recorded[Source], (unsigned)Replay.Taken[Source],
+              (unsigned)Replay.Matched[Source], Replay.MaxDrift[Source] / 1000.0);
+    }
+  }
+  if (Replay.Diverged)
+  {
+    fprintf(stderr, "  first divergence: %s\n", Replay.Divergence);
+  }
+  fflush(stdout);
+  exit(Replay.Diverged ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,77 @@
+/****************************************************************************
+ Module
+   HostSim.h
+
+ Description
+   Interface to the host (Linux) simulation of the parts of the TM4C123 that
+   the DOG code touches: the CPU interrupt mask, the NVIC, SysTick, the DWT
+   cycle counter and the UART4 (XBee), SSI1 (IMU), Timer5, ADC0, PWM0,
+   watchdog 0 and GPIO peripherals.
+
+ Notes
+   The application code is compiled unmodified with -Dhost and the Host
+   directory ahead of the TivaWare include path, so that HWREG() lands in
+   HostSim_Reg() instead of on a peripheral address.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               HostSim_Sync moves virtual time on, for replay
+ 10/17/26               added watchdog 0
+ 10/17/26               added HostSim_WaitForInterrupt
+ 10/17/26               first pass
+****************************************************************************/
+#ifndef HOSTSIM_H
+#define HOSTSIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// the simulated system clock, matching SysCtlClockSet() in main.c
+#define HOSTSIM_SYSCLK_HZ   40000000UL
+#define HOSTSIM_NS_PER_CYCLE  (1000000000UL / HOSTSIM_SYSCLK_HZ)
+
+// register access, used by HWREG() in inc/hw_types.h
+volatile uint32_t *HostSim_Reg(uint32_t Address);
+
+// bring the peripherals up to the current time and take any pending
+// interrupts (if they are not masked). In virtual time this moves time on a
+// little, as a pass of the idle loop would on the target
+void HostSim_Sync(void);
+
+// CPU interrupt mask
+uint32_t HostSim_DisableIRQ(void);
+void HostSim_SetPRIMASK(uint32_t NewPRIMASK);
+bool HostSim_InISR(void);
+void HostSim_WaitForInterrupt(void);
+
+#define __enable_irq()    HostSim_SetPRIMASK(0)
+#define __disable_irq()   ((void)HostSim_DisableIRQ())
+
+// time, in ns since start up. Real (monotonic) time unless virtual time
+// has been selected (or DOG_REPLAY set, see HostSim.c), in which case time
+// only moves with HostSim_Advance(), HostSim_Sync() and while waiting for
+// an interrupt
+uint64_t HostSim_Now(void);
+void HostSim_UseVirtualTime(bool Enable);
+void HostSim_Advance(uint64_t Nanoseconds);
+
+// XBee side of UART4. Bytes handed to HostSim_XBeeRx arrive on the RX pin
+// one character time apart at the programmed baud rate
+typedef void (*HostSim_ByteHook_t)(uint8_t Byte);
+void HostSim_XBeeRx(const uint8_t *pBytes, size_t Length);
+size_t HostSim_XBeeRxPending(void);
+void HostSim_SetXBeeTxHook(HostSim_ByteHook_t Hook);
+
+// IMU (LSM6DS3) on SSI1
+void HostSim_IMUSetReg(uint8_t Reg, uint8_t Value);
+uint8_t HostSim_IMUGetReg(uint8_t Reg);
+
+// ADC0 sample sequencer 2 result for a given step
+void HostSim_SetADC(uint8_t Step, uint16_t Value);
+
+// raw view of a register, without any read side effects
+uint32_t HostSim_Peek(uint32_t Address);
+
+#endif /* HOSTSIM_H */
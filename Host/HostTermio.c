@@ -0,0 +1,145 @@
+/****************************************************************************
+ Module
+   HostTermio.c
+
+ Description
+   Host (Linux) replacement for termio.c and uartstdio.c: the console that
+   is UART0 on the target is the process's stdin and stdout.
+
+ Notes
+   When stdin is a terminal it is put in non-canonical, no echo mode so that
+   keystrokes reach MapKeys one at a time, as they do over the serial port.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               added TERMIO_TxEmpty
+ 10/17/26               first pass
+****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "termio.h"
+#include "HostSim.h"
+
+/*---------------------------- Module Variables ---------------------------*/
+static struct termios SavedTermios;
+static bool TermiosSaved = false;
+static bool StdinClosed = false;
+
+/*---------------------------- Module Functions ---------------------------*/
+static void RestoreTerminal(void);
+
+/*------------------------------ Module Code ------------------------------*/
+unsigned char TERMIO_GetChar(void)
+{
+  return (unsigned char)getchar();
+}
+
+void TERMIO_PutChar(unsigned char ch)
+{
+  putchar(ch);
+}
+
+void TERMIO_Init(void)
+{
+  struct termios Raw;
+
+  setvbuf(stdout, NULL, _IONBF, 0);
+  setvbuf(stdin, NULL, _IONBF, 0);
+  if (isatty(STDIN_FILENO) && (tcgetattr(STDIN_FILENO, &SavedTermios) == 0))
+  {
+    TermiosSaved = true;
+    atexit(RestoreTerminal);
+    Raw = SavedTermios;
+    Raw.c_lflag &= ~(ICANON | ECHO);
+    Raw.c_cc[VMIN] = 1;
+    Raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &Raw);
+  }
+}
+
+/****************************************************************************
+ Function
+     kbhit
+ Parameters
+     none
+ Returns
+     int, 1 if a key is waiting, 0 otherwise
+ Description
+     Polls stdin without blocking. Since the event checkers call this every
+     time round the ES_Run loop it is also where the simulation is kept up
+     to date while the framework is idle.
+ Notes
+     end of file on stdin (e.g. input from a pipe) just means no more keys
+****************************************************************************/
+int kbhit(void)
+{
+  fd_set ReadSet;
+  struct timeval NoWait = { 0, 0 };
+  int Key;
+
+  HostSim_Sync();
+  if (StdinClosed)
+  {
+    return 0;
+  }
+  FD_ZERO(&ReadSet);
+  FD_SET(STDIN_FILENO, &ReadSet);
+  if (select(STDIN_FILENO + 1, &ReadSet, NULL, NULL, &NoWait) <= 0)
+  {
+    return 0;
+  }
+  Key = getchar();
+  if (Key == EOF)
+  {
+    StdinClosed = true;
+    return 0;
+  }
+  ungetc(Key, stdin);
+  return 1;
+}
+
+// stdout takes whatever it is given, so there is never anything waiting
+int TERMIO_TxEmpty(void)
+{
+  return 1;
+}
+
+void UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud, uint32_t ui32SrcClock)
+{
+  (void)ui32Port;
+  (void)ui32Baud;
+  (void)ui32SrcClock;
+}
+
+void UARTprintf(const char *pcString, ...)
+{
+  va_list Args;
+
+  va_start(Args, pcString);
+  vprintf(pcString, Args);
+  va_end(Args);
+}
+
+unsigned char UARTgetc(void)
+{
+  return TERMIO_GetChar();
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+static void RestoreTerminal(void)
+{
+  if (TermiosSaved)
+  {
+    tcsetattr(STDIN_FILENO, TCSANOW, &SavedTermios);
+  }
+}
@@ -0,0 +1,341 @@
+/****************************************************************************
+ Module
+   QueueSizer.c
+
+ Description
+   PC program that reads the service statistics that ES_DumpServiceStats
+   (ES_Framework.c) writes to the console, and recommends the size of each
+   service's queue: the smallest that would have taken every post in the
+   runs that were recorded.
+
+ Notes
+   Capture the console to a file while exercising the DOG (press 'R' at the
+   start to reset the statistics and 'B' at the end to dump them, see
+   MapKeys.c) and run
+     QueueSizer [-e EventBytes] [-m Margin] capture.bin
+   or pipe the capture into it. The capture can hold any amount of printf
+   output and any number of dumps: each dump is found by its start byte and
+   checksum, and everything shown for a service is the largest over all of
+   them, so the captures of several runs can be put together.
+   The recommended size is the Needed count of the dump (the queue size
+   that would have taken every post, counting the rejected and overwritten
+   ones as still queued until the queue next emptied) plus Margin, and at
+   least 1. Queue sizes for SPSC queues still have to be rounded up to a
+   power of 2.
+   EventBytes is sizeof(ES_Event) on the target, 4 with the Keil compiler's
+   packed enums, and is only used to show the RAM that would be saved.
+
+   Build (from the project root):
+     gcc -o QueueSizer Host/QueueSizer.c
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               reads version 5, with the overflow policy counts
+ 10/17/26               first pass
+****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*----------------------------- Module Defines ----------------------------*/
+// the record written by ES_DumpServiceStats
+#define DUMP_START          0x7E
+#define DUMP_VERSION_NEEDED 4   // the first version with Needed
+#define DUMP_VERSION_OVERFLOW 5 // the first with the overflow counts
+#define DUMP_VERSION        5
+#define MAX_SERVICES        32
+
+// bytes for each service: 8 words, OverrunEvent, HighWater, (Needed,)
+// QueueSize, (Overwritten, Escalated)
+#define QUEUE_SIZE_INDEX(Version) (8 * 4 + 2 + (((Version) >= 4) ? 1 : 0))
+#define SERVICE_BYTES(Version) \
+  (QUEUE_SIZE_INDEX(Version) + 1 + (((Version) >= 5) ? 2 * 4 : 0))
+
+/*------------------------------ Module Types -----------------------------*/
+typedef struct
+{
+  bool Seen;
+  uint32_t Dispatches;
+  uint32_t RejectedPosts;
+  uint32_t Coalesced;
+  uint32_t Overwritten;
+  uint32_t Escalated;
+  uint8_t HighWater;
+  uint8_t Needed;
+  uint8_t QueueSize;
+  bool NeededKnown;             // false for dumps from before version 4
+} Service_t;
+
+/*---------------------------- Module Variables ---------------------------*/
+static Service_t Services[MAX_SERVICES];
+static unsigned NumServices = 0;
+static unsigned NumDumps = 0;
+
+/*---------------------------- Module Functions ---------------------------*/
+static size_t ParseDump(const uint8_t *pBytes, size_t Length);
+static uint32_t GetWord(const uint8_t *pBytes, unsigned NumBytes);
+static unsigned Recommend(const Service_t *pService, unsigned Margin);
+static void Usage(const char *pName);
+
+/*------------------------------ Module Code ------------------------------*/
+int main(int argc, char *argv[])
+{
+  FILE *pFile = stdin;
+  uint8_t *pBytes = NULL;
+  size_t Length = 0;
+  size_t Room = 0;
+  size_t Used;
+  size_t i;
+  unsigned EventBytes = 4;
+  unsigned Margin = 0;
+  int Arg;
+  long Saved = 0;
+
+  for (Arg = 1; (Arg < argc) && (argv[Arg][0] == '-'); Arg++)
+  {
+    if ((strcmp(argv[Arg], "-e") == 0) && (Arg + 1 < argc))
+    {
+      EventBytes = (unsigned)strtoul(argv[++Arg], NULL, 0);
+    }
+    else if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc))
+    {
+      Margin = (unsigned)strtoul(argv[++Arg], NULL, 0);
+    }
+    else
+    {
+      Usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (Arg < argc)
+  {
+    pFile = fopen(argv[Arg], "rb");
+    if (pFile == NULL)
+    {
+      perror(argv[Arg]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  // the whole capture, so that a dump can be checked before it is used
+  for (;;)
+  {
+    if (Length == Room)
+    {
+      Room = (Room == 0) ? 4096 : 2 * Room;
+      pBytes = realloc(pBytes, Room);
+      if (pBytes == NULL)
+      {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+      }
+    }
+    Used = fread(pBytes + Length, 1, Room - Length, pFile);
+    if (Used == 0)
+    {
+      break;
+    }
+    Length += Used;
+  }
+
+  for (i = 0; i < Length; i++)
+  {
+    if (pBytes[i] == DUMP_START)
+    {
+      Used = ParseDump(pBytes + i, Length - i);
+      if (Used != 0)
+      {
+        i += Used - 1;
+      }
+    }
+  }
+  free(pBytes);
+
+  if (NumDumps == 0)
+  {
+    fprintf(stderr, "no service statistics dumps found\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%u dump(s), %u services, %u bytes per event, margin %u\n\n",
+         NumDumps, NumServices, EventBytes, Margin);
+  printf("Svc Dispatches Rejected Escalated Overwrote Coalesced High Needed"
+         "  Size  Recommended\n");
+  for (i = 0; i < NumServices; i++)
+  {
+    const Service_t *pService = &Services[i];
+    unsigned Recommended;
+    char Needed[8];
+
+    if (!pService->Seen)
+    {
+      continue;
+    }
+    Recommended = Recommend(pService, Margin);
+    if (pService->NeededKnown)
+    {
+      snprintf(Needed, sizeof(Needed), "%u", (unsigned)pService->Needed);
+    }
+    else
+    {
+      strcpy(Needed, "?");
+    }
+    printf("%2u  %10lu %8lu %9lu %9lu %9lu %4u %6s %5u  %5u%s\n",
+           (unsigned)i, (unsigned long)pService->Dispatches,
+           (unsigned long)pService->RejectedPosts,
+           (unsigned long)pService->Escalated,
+           (unsigned long)pService->Overwritten,
+           (unsigned long)pService->Coalesced, (unsigned)pService->HighWater,
+           Needed, (unsigned)pService->QueueSize,
+           Recommended,
+           (Recommended > pService->QueueSize) ? "  too small" :
+           (Recommended < pService->QueueSize) ? "  too big" : "");
+    Saved += ((long)pService->QueueSize - (long)Recommended) * EventBytes;
+  }
+  printf("\nRAM %s by the recommended sizes: %ld bytes\n",
+         (Saved >= 0) ? "saved" : "added", labs(Saved));
+  return EXIT_SUCCESS;
+}
+
+/*---------------------------- Private Functions --------------------------*/
+// checks and takes in the dump that starts at pBytes, returning its length,
+// or 0 if this 0x7E is not the start of a good dump
+static size_t ParseDump(const uint8_t *pBytes, size_t Length)
+{
+  unsigned Version;
+  unsigned Count;
+  size_t DumpLength;
+  size_t i;
+  uint8_t Sum = 0;
+  uint8_t Check;
+  const uint8_t *p;
+
+  if (Length < 4)
+  {
+    return 0;
+  }
+  Version = pBytes[1];
+  Count = pBytes[2];
+  if ((Version < 3) || (Version > DUMP_VERSION) || (Count == 0) ||
+      (Count > MAX_SERVICES))
+  {
+    return 0;
+  }
+  DumpLength = 3 + Count * SERVICE_BYTES(Version) + 1;
+  if (Length < DumpLength)
+  {
+    return 0;
+  }
+  for (i = 1; i < DumpLength - 1; i++)
+  {
+    Sum += pBytes[i];
+  }
+  Check = 0xFF - Sum;
+  if (Check != pBytes[DumpLength - 1])
+  {
+    return 0;
+  }
+
+  p = pBytes + 3;
+  for (i = 0; i < Count; i++)
+  {
+    Service_t *pService = &Services[i];
+    uint32_t Dispatches = GetWord(p, 4);
+    uint32_t RejectedPosts = GetWord(p + 16, 4);
+    uint32_t Coalesced = GetWord(p + 20, 4);
+    uint8_t HighWater = p[33];
+    uint8_t Needed = (Version >= DUMP_VERSION_NEEDED) ? p[34] : HighWater;
+    uint8_t QueueSize = p[QUEUE_SIZE_INDEX(Version)];
+    uint32_t Overwritten = 0;
+    uint32_t Escalated = 0;
+
+    if (Version >= DUMP_VERSION_OVERFLOW)
+    {
+      Overwritten = GetWord(p + QUEUE_SIZE_INDEX(Version) + 1, 4);
+      Escalated = GetWord(p + QUEUE_SIZE_INDEX(Version) + 5, 4);
+    }
+
+    if (!pService->Seen)
+    {
+      pService->Seen = true;
+      pService->NeededKnown = true;
+    }
+    // the counts run on from one dump to the next unless the statistics
+    // were reset in between, so they can't be added up
+    if (Dispatches > pService->Dispatches)
+    {
+      pService->Dispatches = Dispatches;
+    }
+    if (RejectedPosts > pService->RejectedPosts)
+    {
+      pService->RejectedPosts = RejectedPosts;
+    }
+    if (Coalesced > pService->Coalesced)
+    {
+      pService->Coalesced = Coalesced;
+    }
+    if (Overwritten > pService->Overwritten)
+    {
+      pService->Overwritten = Overwritten;
+    }
+    if (Escalated > pService->Escalated)
+    {
+      pService->Escalated = Escalated;
+    }
+    if (HighWater > pService->HighWater)
+    {
+      pService->HighWater = HighWater;
+    }
+    if (Needed > pService->Needed)
+    {
+      pService->Needed = Needed;
+    }
+    if ((Version < DUMP_VERSION_NEEDED) && (RejectedPosts != 0))
+    {
+      pService->NeededKnown = false;   // only that it was over QueueSize
+    }
+    pService->QueueSize = QueueSize;
+    p += SERVICE_BYTES(Version);
+  }
+  if (Count > NumServices)
+  {
+    NumServices = Count;
+  }
+  NumDumps++;
+  return DumpLength;
+}
+
+// the NumBytes byte word at pBytes, least significant byte first
+static uint32_t GetWord(const uint8_t *pBytes, unsigned NumBytes)
+{
+  uint32_t Word = 0;
+
+  while (NumBytes-- > 0)
+  {
+    Word = (Word << 8) | pBytes[NumBytes];
+  }
+  return Word;
+}
+
+// the queue size to use for a service. Without Needed, a queue that
+// rejected posts gets one more than it had, to be checked with another run
+static unsigned Recommend(const Service_t *pService, unsigned Margin)
+{
+  unsigned Size = pService->Needed;
+
+  if (!pService->NeededKnown && (Size <= pService->QueueSize))
+  {
+    Size = pService->QueueSize + 1;
+  }
+  Size += Margin;
+  return (Size < 1) ? 1 : Size;
+}
+
+static void Usage(const char *pName)
+{
+  fprintf(stderr, "usage: %s [-e EventBytes] [-m Margin] [capture]\n", pName);
+}
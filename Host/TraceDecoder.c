@@ -0,0 +1,371 @@
+/****************************************************************************
+ Module
+   TraceDecoder.c
+
+ Description
+   PC program that reads the event trace that ES_Trace.c sends to the
+   console and prints it as a timeline: the time of each record, the time
+   since the one before, and what happened, indented by the run function
+   that was running at the time, so that the interrupts and posts that came
+   in the middle of a run function show up inside it.
+
+ Notes
+   Capture the console to a file (with ES_TRACE_DRAIN defined, or pressing
+   'T' after whatever is to be looked at, see MapKeys.c) and run
+     TraceDecoder [-c CyclesPerUS] capture.bin
+   or pipe the capture into it. Each record is found by its start byte and
+   checksum, so the capture can hold any amount of printf output.
+   CyclesPerUS is the CPU clock in MHz, 40 by default (ES_CYCLES_PER_US).
+   The names of the services, timers and trace points are taken from the
+   lists in ES_Configure.h, so build this against the same one as the code
+   that made the trace. Events are shown by number (ES_EventTyp_t in
+   ES_Configure.h) with the low byte of their parameter.
+   The cycle count wraps every 107 seconds at 40MHz, so a gap of longer
+   than that between two records shows up as the remainder.
+
+   Build (from the project root):
+     gcc -IHeaders -IHost -o TraceDecoder Host/TraceDecoder.c
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               shows the bytes recorded with ES_TRACE_INPUTS
+ 10/17/26               first pass
+****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ES_Configure.h"
+#include "inc/hw_ints.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// the frame that ES_Trace.c sends for each record
+#define TRACE_FRAME_START   0xA5
+#define TRACE_FRAME_LENGTH  10
+
+// the record kinds, ES_TraceKind_t in ES_Trace.h
+#define TRACE_POST    1
+#define TRACE_REJECT  2
+#define TRACE_BEGIN   3
+#define TRACE_END     4
+#define TRACE_ISR     5
+#define TRACE_TIMER   6
+#define TRACE_POINT   7
+#define TRACE_LOST    8
+#define TRACE_INPUT   9
+
+// how deep run functions can be shown nested (ES_PREEMPTIVE)
+#define MAX_DEPTH     8
+
+// the names, from the lists in ES_Configure.h
+#define SERVICE_NAME(Name, InitFunc, RunFunc, QueueSize, SPSC, BudgetUS) #Name,
+#define TIMER_NAME(Name, RespFunc) #Name,
+#define POINT_NAME(Name) #Name,
+
+/*------------------------------ Module Types -----------------------------*/
+typedef struct
+{
+  uint8_t Kind;
+  uint8_t Id;
+  uint16_t Data;
+  uint32_t Time;
+} Record_t;
+
+typedef struct
+{
+  unsigned Number;
+  const char *pName;
+} Interrupt_t;
+
+/*---------------------------- Module Variables ---------------------------*/
+static const char *const ServiceNames[] = { ES_SERVICE_LIST(SERVICE_NAME) };
+static const char *const TimerNames[] = { ES_TIMER_LIST(TIMER_NAME) };
+#ifdef ES_TRACE_POINTS
+static const char *const PointNames[] = { ES_TRACE_POINTS(POINT_NAME) };
+#endif
+
+static const Interrupt_t Interrupts[] =
+{
+  { FAULT_PENDSV, "PendSV" },
+  { FAULT_SYSTICK, "SysTick" },
+  { INT_SSI1, "SSI1" },
+  { INT_UART4, "UART4" },
+  { INT_TIMER5A, "Timer5A" },
+  { INT_TIMER5B, "Timer5B" },
+};
+
+// the services whose run functions are running, innermost last
+static uint8_t Running[MAX_DEPTH];
+static uint32_t RunStart[MAX_DEPTH];
+static unsigned Depth = 0;
+
+/*---------------------------- Module Functions ---------------------------*/
+static bool ParseRecord(const uint8_t *pBytes, Record_t *pRecord);
+static uint32_t GetWord(const uint8_t *pBytes, unsigned NumBytes);
+static void PrintRecord(const Record_t *pRecord, double CyclesPerUS);
+static const char *Name(const char *const *pNames, unsigned NumNames,
+                        unsigned Which);
+static const char *InterruptName(unsigned Number);
+static void Usage(const char *pName);
+
+/*------------------------------ Module Code ------------------------------*/
+int main(int argc, char *argv[])
+{
+  FILE *pFile = stdin;
+  uint8_t *pBytes = NULL;
+  size_t Length = 0;
+  size_t Room = 0;
+  size_t Used;
+  size_t i;
+  double CyclesPerUS = 40.0;
+  uint64_t Now = 0;
+  uint32_t Last = 0;
+  uint32_t Since;
+  bool HaveTime = false;
+  unsigned NumRecords = 0;
+  Record_t Record;
+  int Arg;
+
+  for (Arg = 1; (Arg < argc) && (argv[Arg][0] == '-'); Arg++)
+  {
+    if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc))
+    {
+      CyclesPerUS = strtod(argv[++Arg], NULL);
+    }
+    else
+    {
+      Usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (CyclesPerUS <= 0)
+  {
+    Usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (Arg < argc)
+  {
+    pFile = fopen(argv[Arg], "rb");
+    if (pFile == NULL)
+    {
+      perror(argv[Arg]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  // the whole capture, so that a frame can be checked before it is used
+  for (;;)
+  {
+    if (Length == Room)
+    {
+      Room = (Room == 0) ? 4096 : 2 * Room;
+      pBytes = realloc(pBytes, Room);
+      if (pBytes == NULL)
+      {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+      }
+    }
+    Used = fread(pBytes + Length, 1, Room - Length, pFile);
+    if (Used == 0)
+    {
+      break;
+    }
+    Length += Used;
+  }
+
+  printf("    time(us)    +us  what\n");
+  for (i = 0; i + TRACE_FRAME_LENGTH <= Length; i++)
+  {
+    if ((pBytes[i] != TRACE_FRAME_START) || !ParseRecord(pBytes + i, &Record))
+    {
+      continue;
+    }
+    i += TRACE_FRAME_LENGTH - 1;
+    // a lost record is stamped when it was sent, not when the records that
+    // it stands for were made, so it doesn't move the time on
+    Since = 0;
+    if (Record.Kind != TRACE_LOST)
+    {
+      if (HaveTime)
+      {
+        Since = Record.Time - Last;
+      }
+      Now += Since;
+      Last = Record.Time;
+      HaveTime = true;
+    }
+    printf("%12.3f %6.1f  ", Now / CyclesPerUS, Since / CyclesPerUS);
+    PrintRecord(&Record, CyclesPerUS);
+    NumRecords++;
+  }
+  free(pBytes);
+
+  if (NumRecords == 0)
+  {
+    fprintf(stderr, "no trace records found\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/*---------------------------- Private Functions --------------------------*/
+// checks the frame at pBytes and takes the record out of it
+static bool ParseRecord(const uint8_t *pBytes, Record_t *pRecord)
+{
+  uint8_t Sum = 0;
+  uint8_t Check;
+  unsigned i;
+
+  for (i = 1; i < TRACE_FRAME_LENGTH - 1; i++)
+  {
+    Sum += pBytes[i];
+  }
+  Check = 0xFF - Sum;
+  if ((Check != pBytes[TRACE_FRAME_LENGTH - 1]) || (pBytes[1] < TRACE_POST) ||
+      (pBytes[1] > TRACE_INPUT))
+  {
+    return false;
+  }
+  pRecord->Kind = pBytes[1];
+  pRecord->Id = pBytes[2];
+  pRecord->Data = (uint16_t)GetWord(pBytes + 3, 2);
+  pRecord->Time = GetWord(pBytes + 5, 4);
+  return true;
+}
+
+// the NumBytes byte word at pBytes, least significant byte first
+static uint32_t GetWord(const uint8_t *pBytes, unsigned NumBytes)
+{
+  uint32_t Word = 0;
+
+  while (NumBytes-- > 0)
+  {
+    Word = (Word << 8) | pBytes[NumBytes];
+  }
+  return Word;
+}
+
+// prints what the record says happened, indented by the run functions that
+// were running, and keeps track of which those are
+static void PrintRecord(const Record_t *pRecord, double CyclesPerUS)
+{
+  const char *pService = Name(ServiceNames,
+                              sizeof(ServiceNames) / sizeof(ServiceNames[0]),
+                              pRecord->Id);
+  unsigned EventType = pRecord->Data & 0xFF;
+  unsigned Param = pRecord->Data >> 8;
+  bool Ended = false;
+  unsigned i;
+
+  if ((pRecord->Kind == TRACE_END) && (Depth > 0) &&
+      (Running[Depth - 1] == pRecord->Id))
+  {
+    Depth--;
+    Ended = true;
+  }
+  for (i = 0; i < Depth; i++)
+  {
+    printf("| ");
+  }
+
+  switch (pRecord->Kind)
+  {
+    case TRACE_POST:
+      printf("post    -> %u %s  event %u (%u)\n", (unsigned)pRecord->Id,
+             pService, EventType, Param);
+      break;
+
+    case TRACE_REJECT:
+      printf("REJECT  -> %u %s  event %u (%u), queue full\n",
+             (unsigned)pRecord->Id, pService, EventType, Param);
+      break;
+
+    case TRACE_BEGIN:
+      printf("run     %u %s  event %u (%u)\n", (unsigned)pRecord->Id, pService,
+             EventType, Param);
+      if (Depth < MAX_DEPTH)
+      {
+        Running[Depth] = pRecord->Id;
+        RunStart[Depth] = pRecord->Time;
+        Depth++;
+      }
+      break;
+
+    case TRACE_END:
+      printf("done    %u %s", (unsigned)pRecord->Id, pService);
+      if (Ended)
+      {
+        printf("  %.1fus", (uint32_t)(pRecord->Time - RunStart[Depth]) /
+               CyclesPerUS);
+      }
+      if (pRecord->Data != 0)
+      {
+        printf("  returned event %u", (unsigned)pRecord->Data);
+      }
+      printf("\n");
+      break;
+
+    case TRACE_ISR:
+      printf("ISR     %s\n", InterruptName(pRecord->Id));
+      break;
+
+    case TRACE_TIMER:
+      printf("timeout %s\n", Name(TimerNames,
+                                  sizeof(TimerNames) / sizeof(TimerNames[0]),
+                                  pRecord->Id));
+      break;
+
+    case TRACE_POINT:
+#ifdef ES_TRACE_POINTS
+      printf("point   %s  %u\n", Name(PointNames,
+                                      sizeof(PointNames) / sizeof(PointNames[0]),
+                                      pRecord->Id), (unsigned)pRecord->Data);
+#else
+      printf("point   %u  %u\n", (unsigned)pRecord->Id,
+             (unsigned)pRecord->Data);
+#endif
+      break;
+
+    case TRACE_INPUT:
+      printf("input   %s  0x%02X\n", InterruptName(pRecord->Id),
+             (unsigned)pRecord->Data);
+      break;
+
+    case TRACE_LOST:
+      printf("--- %u records lost ---\n", (unsigned)pRecord->Data);
+      Depth = 0; // whatever was running may have finished in those
+      break;
+  }
+}
+
+static const char *Name(const char *const *pNames, unsigned NumNames,
+                        unsigned Which)
+{
+  return (Which < NumNames) ? pNames[Which] : "?";
+}
+
+static const char *InterruptName(unsigned Number)
+{
+  static char Unknown[16];
+  unsigned i;
+
+  for (i = 0; i < sizeof(Interrupts) / sizeof(Interrupts[0]); i++)
+  {
+    if (Interrupts[i].Number == Number)
+    {
+      return Interrupts[i].pName;
+    }
+  }
+  snprintf(Unknown, sizeof(Unknown), "interrupt %u", Number);
+  return Unknown;
+}
+
+static void Usage(const char *pName)
+{
+  fprintf(stderr, "usage: %s [-c CyclesPerUS] [capture]\n", pName);
+}
@@ -0,0 +1,261 @@
+/****************************************************************************
+ Module
+   TransmitTest.c
+
+ Description
+   Host (HostSim) test of the XBee transmit path: Transmit_SM, UART_ISR and
+   the simulated UART4. A known frame is sent over and over, and the bytes
+   that come out of the TX pin are checked against the frame, escaped as
+   the XBee expects in API mode 2. For each frame it reports the Transmit_SM
+   dispatches, the UART4 interrupts and the host time spent in RunTransmit_SM
+   and UART_ISR, so that the transmitters can be compared.
+
+ Notes
+   Build (from the project root) with the DOG sources, leaving out main.c
+   as well as termio.c, uartstdio.c and retarget.c:
+     gcc -Dhost -IHost -IHeaders -o TransmitTest Host/TransmitTest.c
+         Host/HostSim.c Host/HostDriverlib.c Host/HostTermio.c
+         <the other Source files in the Keil project>
+         -Wl,--wrap=PostTransmit_SM,--wrap=UART_ISR
+   for the whole frame transmitter in API mode 1. Add -DUART_BYTE_TX for
+   the byte at a time transmitter, or -DXBEE_API_MODE=2 for the whole frame
+   transmitter with escaping (the byte at a time one can't escape).
+   The wraps hand UART_ISR's posts to Transmit_SM to this program, which
+   runs the state machine itself instead of ES_Run, so that no other
+   service is started. The frame is 0x10 (transmit request) with a 0x7E,
+   0x7D, 0x11 and 0x13 in its data and a checksum of 0x7D, so that in API
+   mode 2 every kind of escape goes out.
+   Host times are real time at HOSTSIM_SYSCLK_HZ, so they only give the
+   cost of one transmitter relative to the other.
+   Exits with EXIT_FAILURE if any frame is wrong or doesn't finish.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               first pass
+****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "HostSim.h"
+#include "driverlib/sysctl.h"
+
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Buffer.h"
+#include "Constants.h"
+#include "Transmit_SM.h"
+#include "UART.h"
+#include "XBeeParser.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define NUM_FRAMES        20
+#define FRAME_TIMEOUT_NS  100000000ULL   // 100ms, far longer than a frame
+#define MAX_WIRE_BYTES    (2 * sizeof(Frame))
+#define EVENT_QUEUE_SIZE  8
+
+/*---------------------------- Module Functions ---------------------------*/
+bool __real_PostTransmit_SM(ES_Event ThisEvent);
+bool __wrap_PostTransmit_SM(ES_Event ThisEvent);
+void __real_UART_ISR(void);
+void __wrap_UART_ISR(void);
+
+static uint16_t BuildWireBytes(uint8_t *pWire);
+static bool SendFrame(void);
+static void Dispatch(ES_Event ThisEvent);
+static void TxByte(uint8_t Byte);
+
+/*---------------------------- Module Variables ---------------------------*/
+// a transmit request (0x10) with every byte that API mode 2 escapes in
+// it, the checksum (0x7D) included
+static const uint8_t Frame[] =
+{
+  XBEE_START_DELIMITER, 0x00, 0x12,
+  0x10, 0x01, 0x00, 0x13, 0xA2, 0x00, 0x40, 0xA1, 0x7E, 0x11,
+  0xFF, 0xFE, 0x00, 0x00, 0x7D, 0x13, 0x01, 0xBE,
+  0x7D
+};
+
+static uint8_t Wire[MAX_WIRE_BYTES];
+static uint8_t Sent[MAX_WIRE_BYTES];
+static uint16_t NumSent;
+
+// what UART_ISR posted to Transmit_SM, waiting for Dispatch
+static ES_Event Events[EVENT_QUEUE_SIZE];
+static volatile uint8_t EventsIn;
+static uint8_t EventsOut;
+static bool Overflowed;
+
+static uint32_t Dispatches;
+static uint32_t Interrupts;
+static uint64_t RunNs;
+static uint64_t ISRNs;
+
+/*------------------------------ Module Code ------------------------------*/
+int main(void)
+{
+  ES_Event ThisEvent;
+  uint16_t WireLength;
+  uint32_t Good = 0;
+  uint32_t i;
+
+  SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
+                 | SYSCTL_XTAL_16MHZ);
+  ES_InitBuffers();
+  InitUART();
+  UART_SetBaud(XBEE_BAUD);
+  HostSim_SetXBeeTxHook(TxByte);
+
+  ThisEvent.EventType = ES_INIT;
+  ThisEvent.Buffer = ES_NO_BUFFER;
+  RunTransmit_SM(ThisEvent);
+
+  WireLength = BuildWireBytes(Wire);
+  for (i = 0; i < NUM_FRAMES; i++)
+  {
+    if (!SendFrame())
+    {
+      printf("frame %u did not finish (%u of %u bytes out)\n",
+             (unsigned)i, (unsigned)NumSent, (unsigned)WireLength);
+    }
+    else if ((NumSent != WireLength) ||
+             (memcmp(Sent, Wire, WireLength) != 0))
+    {
+      printf("frame %u: wrong bytes out\n", (unsigned)i);
+    }
+    else
+    {
+      Good++;
+    }
+  }
+
+  printf("%s transmitter, API mode %u, %u byte frame (%u on the wire)\n",
+#ifdef UART_WHOLE_FRAME_TX
+         "whole frame",
+#else
+         "byte at a time",
+#endif
+         (unsigned)XBEE_API_MODE, (unsigned)sizeof(Frame),
+         (unsigned)WireLength);
+  printf("  per frame: %.1f Transmit_SM dispatches, %.1f UART4 interrupts\n",
+         (double)Dispatches / NUM_FRAMES, (double)Interrupts / NUM_FRAMES);
+  printf("  per frame: ~%.0f cycles in RunTransmit_SM, ~%.0f in UART_ISR\n",
+         (double)RunNs / HOSTSIM_NS_PER_CYCLE / NUM_FRAMES,
+         (double)ISRNs / HOSTSIM_NS_PER_CYCLE / NUM_FRAMES);
+  printf("%s: %u of %u frames sent correctly\n",
+         ((Good == NUM_FRAMES) && !Overflowed) ? "PASS" : "FAIL",
+         (unsigned)Good, (unsigned)NUM_FRAMES);
+  return ((Good == NUM_FRAMES) && !Overflowed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// stands in for the framework's queue, taking the events that UART_ISR
+// posts to Transmit_SM
+bool __wrap_PostTransmit_SM(ES_Event ThisEvent)
+{
+  if ((uint8_t)(EventsIn - EventsOut) == EVENT_QUEUE_SIZE)
+  {
+    Overflowed = true;
+    return false;
+  }
+  Events[EventsIn % EVENT_QUEUE_SIZE] = ThisEvent;
+  EventsIn++;
+  return true;
+}
+
+void __wrap_UART_ISR(void)
+{
+  uint64_t Start = HostSim_Now();
+
+  __real_UART_ISR();
+  ISRNs += HostSim_Now() - Start;
+  Interrupts++;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+// the frame as it should leave the TX pin, returns its length
+static uint16_t BuildWireBytes(uint8_t *pWire)
+{
+  uint16_t Length = 0;
+  uint16_t i;
+
+  for (i = 0; i < sizeof(Frame); i++)
+  {
+    if ((XBEE_API_MODE == XBEE_API_ESCAPED) && (i != START_BYTE_INDEX) &&
+        XBee_NeedsEscape(Frame[i]))
+    {
+      pWire[Length++] = XBEE_ESCAPE;
+      pWire[Length++] = Frame[i] ^ XBEE_ESCAPE_XOR;
+    }
+    else
+    {
+      pWire[Length++] = Frame[i];
+    }
+  }
+  return Length;
+}
+
+// hands Transmit_SM the frame, as Comm_Service does, and runs it until it
+// is back in Idle. Returns false if that took longer than FRAME_TIMEOUT_NS
+static bool SendFrame(void)
+{
+  ES_Event ThisEvent;
+  uint64_t Deadline;
+  uint8_t *pData;
+
+  NumSent = 0;
+  ThisEvent.EventType = ES_START_XMIT;
+  ThisEvent.EventParam = sizeof(Frame) - HEADER_LENGTH - 1;
+  ThisEvent.Buffer = ES_BufAlloc(sizeof(Frame));
+  pData = ES_BufData(ThisEvent.Buffer);
+  if (pData == NULL)
+  {
+    return false;
+  }
+  memcpy(pData, Frame, sizeof(Frame));
+  Dispatch(ThisEvent);
+  // Transmit_SM holds its own reference until the frame is out
+  ES_BufRelease(ThisEvent.Buffer);
+
+  Deadline = HostSim_Now() + FRAME_TIMEOUT_NS;
+  while (ES_BufNumFree() != ES_NUM_BUFFERS)
+  {
+    if (HostSim_Now() > Deadline)
+    {
+      return false;
+    }
+    HostSim_Sync();
+    while (EventsOut != EventsIn)
+    {
+      Dispatch(Events[EventsOut % EVENT_QUEUE_SIZE]);
+      EventsOut++;
+    }
+  }
+  return true;
+}
+
+// runs Transmit_SM, as ES_Run would
+static void Dispatch(ES_Event ThisEvent)
+{
+  uint64_t Start = HostSim_Now();
+
+  RunTransmit_SM(ThisEvent);
+  RunNs += HostSim_Now() - Start;
+  Dispatches++;
+}
+
+// each byte as it leaves the TX pin
+static void TxByte(uint8_t Byte)
+{
+  if (NumSent < sizeof(Sent))
+  {
+    Sent[NumSent] = Byte;
+  }
+  NumSent++;
+}
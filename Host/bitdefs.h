@@ -0,0 +1,10 @@
+/****************************************************************************
+ Module
+   bitdefs.h
+
+ Description
+   The framework includes "bitdefs.h" while the file in Headers is named
+   BITDEFS.H. That is fine on Windows, but not on a case sensitive host
+   file system, so this forwards to the real header.
+****************************************************************************/
+#include "BITDEFS.H"
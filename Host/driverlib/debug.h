@@ -0,0 +1,18 @@
+//*****************************************************************************
+//
+// debug.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_DEBUG_H__
+#define __DRIVERLIB_DEBUG_H__
+
+#include <assert.h>
+
+#ifdef DEBUG
+#define ASSERT(expr)            assert(expr)
+#else
+#define ASSERT(expr)
+#endif
+
+#endif // __DRIVERLIB_DEBUG_H__
@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// interrupt.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// The functions declared here are implemented in Host/HostDriverlib.c.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_INTERRUPT_H__
+#define __DRIVERLIB_INTERRUPT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+bool IntMasterEnable(void);
+bool IntMasterDisable(void);
+void IntEnable(uint32_t ui32Interrupt);
+void IntDisable(uint32_t ui32Interrupt);
+
+#endif // __DRIVERLIB_INTERRUPT_H__
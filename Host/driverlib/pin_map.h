@@ -0,0 +1,22 @@
+//*****************************************************************************
+//
+// pin_map.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// Encoding follows TivaWare: port index in bits 16-23, PCTL shift in bits
+// 8-15 and the alternate function number in bits 0-3.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_PIN_MAP_H__
+#define __DRIVERLIB_PIN_MAP_H__
+
+#define GPIO_PA0_U0RX           0x00000001
+#define GPIO_PA1_U0TX           0x00000401
+#define GPIO_PC4_U4RX           0x00021001
+#define GPIO_PC5_U4TX           0x00021401
+#define GPIO_PD0_SSI1CLK        0x00030002
+#define GPIO_PD1_SSI1FSS        0x00030402
+#define GPIO_PD2_SSI1RX         0x00030802
+#define GPIO_PD3_SSI1TX         0x00030C02
+
+#endif // __DRIVERLIB_PIN_MAP_H__
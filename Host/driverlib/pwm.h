@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// pwm.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// PWM_Module.c programs PWM0 through HWREG, so nothing is declared here.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_PWM_H__
+#define __DRIVERLIB_PWM_H__
+
+#endif // __DRIVERLIB_PWM_H__
@@ -0,0 +1,13 @@
+//*****************************************************************************
+//
+// rom.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// There is no ROM on the host; the application does not use the ROM_ or
+// MAP_ entry points, so nothing is declared here.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_ROM_H__
+#define __DRIVERLIB_ROM_H__
+
+#endif // __DRIVERLIB_ROM_H__
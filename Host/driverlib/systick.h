@@ -0,0 +1,23 @@
+//*****************************************************************************
+//
+// systick.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// The functions declared here are implemented in Host/HostDriverlib.c.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_SYSTICK_H__
+#define __DRIVERLIB_SYSTICK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void SysTickEnable(void);
+void SysTickDisable(void);
+void SysTickIntEnable(void);
+void SysTickIntDisable(void);
+void SysTickPeriodSet(uint32_t ui32Period);
+uint32_t SysTickPeriodGet(void);
+uint32_t SysTickValueGet(void);
+
+#endif // __DRIVERLIB_SYSTICK_H__
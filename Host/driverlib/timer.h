@@ -0,0 +1,40 @@
+//*****************************************************************************
+//
+// timer.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// The functions declared here are implemented in Host/HostDriverlib.c.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_TIMER_H__
+#define __DRIVERLIB_TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TIMER_CFG_ONE_SHOT      0x00000021
+#define TIMER_CFG_PERIODIC      0x00000022
+#define TIMER_CFG_SPLIT_PAIR    0x04000000
+#define TIMER_CFG_A_ONE_SHOT    0x00000021
+#define TIMER_CFG_A_PERIODIC    0x00000022
+#define TIMER_CFG_B_ONE_SHOT    0x00002100
+#define TIMER_CFG_B_PERIODIC    0x00002200
+
+#define TIMER_A                 0x000000ff
+#define TIMER_B                 0x0000ff00
+#define TIMER_BOTH              0x0000ffff
+
+#define TIMER_TIMA_TIMEOUT      0x00000001
+#define TIMER_TIMB_TIMEOUT      0x00000100
+
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config);
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer);
+void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer);
+void TimerPrescaleSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value);
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value);
+uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer);
+void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+void TimerIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags);
+void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+
+#endif // __DRIVERLIB_TIMER_H__
@@ -0,0 +1,21 @@
+//*****************************************************************************
+//
+// uart.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// The functions declared here are implemented in Host/HostDriverlib.c.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_UART_H__
+#define __DRIVERLIB_UART_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UART_CLOCK_SYSTEM       0x00000000
+#define UART_CLOCK_PIOSC        0x00000005
+
+void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source);
+void UARTCharPut(uint32_t ui32Base, unsigned char ucData);
+
+#endif // __DRIVERLIB_UART_H__
@@ -0,0 +1,29 @@
+//*****************************************************************************
+//
+// hw_ints.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// Interrupt numbers include the 16 processor exceptions, as in TivaWare.
+//
+//*****************************************************************************
+
+#ifndef __HW_INTS_H__
+#define __HW_INTS_H__
+
+#define FAULT_PENDSV            14
+#define FAULT_SYSTICK           15
+
+#define INT_UART0_TM4C123       21
+#define INT_SSI1_TM4C123        50
+#define INT_UDMA_TM4C123        62
+#define INT_UART4_TM4C123       76
+#define INT_TIMER5A_TM4C123     108
+#define INT_TIMER5B_TM4C123     109
+
+#define INT_SSI1                INT_SSI1_TM4C123
+#define INT_UART4               INT_UART4_TM4C123
+#define INT_TIMER5A             INT_TIMER5A_TM4C123
+#define INT_TIMER5B             INT_TIMER5B_TM4C123
+
+#define NUM_INTERRUPTS          155
+
+#endif // __HW_INTS_H__
@@ -0,0 +1,29 @@
+//*****************************************************************************
+//
+// hw_memmap.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// Only the bases used by the DOG firmware are listed.
+//
+//*****************************************************************************
+
+#ifndef __HW_MEMMAP_H__
+#define __HW_MEMMAP_H__
+
+#define WATCHDOG0_BASE          0x40000000
+#define GPIO_PORTA_BASE         0x40004000
+#define GPIO_PORTB_BASE         0x40005000
+#define GPIO_PORTC_BASE         0x40006000
+#define GPIO_PORTD_BASE         0x40007000
+#define SSI0_BASE               0x40008000
+#define SSI1_BASE               0x40009000
+#define UART0_BASE              0x4000C000
+#define UART4_BASE              0x40010000
+#define GPIO_PORTE_BASE         0x40024000
+#define GPIO_PORTF_BASE         0x40025000
+#define PWM0_BASE               0x40028000
+#define TIMER5_BASE             0x40035000
+#define ADC0_BASE               0x40038000
+#define SYSCTL_BASE             0x400FE000
+#define UDMA_BASE               0x400FF000
+
+#endif // __HW_MEMMAP_H__
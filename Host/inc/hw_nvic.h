@@ -0,0 +1,41 @@
+//*****************************************************************************
+//
+// hw_nvic.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// The System Control Space registers (NVIC, SysTick, SCB) and the DWT
+// cycle counter are all backed by HostSim.c.
+//
+//*****************************************************************************
+
+#ifndef __HW_NVIC_H__
+#define __HW_NVIC_H__
+
+#define NVIC_ST_CTRL            0xE000E010
+#define NVIC_ST_RELOAD          0xE000E014
+#define NVIC_ST_CURRENT         0xE000E018
+#define NVIC_EN0                0xE000E100
+#define NVIC_EN1                0xE000E104
+#define NVIC_EN2                0xE000E108
+#define NVIC_DIS0               0xE000E180
+#define NVIC_DIS1               0xE000E184
+#define NVIC_DIS2               0xE000E188
+#define NVIC_INT_CTRL           0xE000ED04
+#define NVIC_SYS_CTRL           0xE000ED10
+#define NVIC_SYS_PRI3           0xE000ED20
+#define NVIC_DBG_CTRL           0xE000EDF0
+
+#define NVIC_ST_CTRL_COUNT      0x00010000
+#define NVIC_ST_CTRL_CLK_SRC    0x00000004
+#define NVIC_ST_CTRL_INTEN      0x00000002
+#define NVIC_ST_CTRL_ENABLE     0x00000001
+
+#define NVIC_INT_CTRL_PEND_SV   0x10000000
+#define NVIC_INT_CTRL_UNPEND_SV 0x08000000
+#define NVIC_INT_CTRL_PENDSTSET 0x04000000
+#define NVIC_INT_CTRL_PENDSTCLR 0x02000000
+
+#define NVIC_SYS_CTRL_SLEEPDEEP 0x00000004
+
+#define NVIC_SYS_PRI3_PENDSV_M  0x00E00000
+
+#endif // __HW_NVIC_H__
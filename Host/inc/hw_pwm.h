@@ -0,0 +1,99 @@
+//*****************************************************************************
+//
+// hw_pwm.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+//*****************************************************************************
+
+#ifndef __HW_PWM_H__
+#define __HW_PWM_H__
+
+#define PWM_O_CTL               0x00000000
+#define PWM_O_SYNC              0x00000004
+#define PWM_O_ENABLE            0x00000008
+#define PWM_O_INVERT            0x0000000C
+#define PWM_O_0_CTL             0x00000040
+#define PWM_O_0_LOAD            0x00000050
+#define PWM_O_0_COUNT           0x00000054
+#define PWM_O_0_CMPA            0x00000058
+#define PWM_O_0_CMPB            0x0000005C
+#define PWM_O_0_GENA            0x00000060
+#define PWM_O_0_GENB            0x00000064
+#define PWM_O_1_CTL             0x00000080
+#define PWM_O_1_LOAD            0x00000090
+#define PWM_O_1_COUNT           0x00000094
+#define PWM_O_1_CMPA            0x00000098
+#define PWM_O_1_CMPB            0x0000009C
+#define PWM_O_1_GENA            0x000000A0
+#define PWM_O_1_GENB            0x000000A4
+#define PWM_O_2_CTL             0x000000C0
+#define PWM_O_2_LOAD            0x000000D0
+#define PWM_O_2_COUNT           0x000000D4
+#define PWM_O_2_CMPA            0x000000D8
+#define PWM_O_2_CMPB            0x000000DC
+#define PWM_O_2_GENA            0x000000E0
+#define PWM_O_2_GENB            0x000000E4
+
+#define PWM_ENABLE_PWM4EN       0x00000010
+#define PWM_ENABLE_PWM3EN       0x00000008
+#define PWM_ENABLE_PWM2EN       0x00000004
+#define PWM_ENABLE_PWM1EN       0x00000002
+#define PWM_ENABLE_PWM0EN       0x00000001
+
+#define PWM_INVERT_PWM3INV      0x00000008
+#define PWM_INVERT_PWM2INV      0x00000004
+#define PWM_INVERT_PWM1INV      0x00000002
+#define PWM_INVERT_PWM0INV      0x00000001
+
+#define PWM_X_CTL_GENBUPD_LS    0x00000200
+#define PWM_X_CTL_GENAUPD_LS    0x00000080
+#define PWM_X_CTL_MODE          0x00000002
+#define PWM_X_CTL_ENABLE        0x00000001
+
+#define PWM_X_GENA_ACTCMPAD_ZERO 0x00000040
+#define PWM_X_GENA_ACTCMPAD_ONE 0x000000C0
+#define PWM_X_GENA_ACTCMPAU_ZERO 0x00000010
+#define PWM_X_GENA_ACTCMPAU_ONE 0x00000030
+#define PWM_X_GENA_ACTZERO_ZERO 0x00000001
+#define PWM_X_GENA_ACTZERO_ONE  0x00000003
+#define PWM_X_GENB_ACTCMPBD_ZERO 0x00000400
+#define PWM_X_GENB_ACTCMPBD_ONE 0x00000C00
+#define PWM_X_GENB_ACTCMPBU_ZERO 0x00000100
+#define PWM_X_GENB_ACTCMPBU_ONE 0x00000300
+#define PWM_X_GENB_ACTZERO_ZERO 0x00000001
+#define PWM_X_GENB_ACTZERO_ONE  0x00000003
+
+#define PWM_0_CTL_GENBUPD_LS    PWM_X_CTL_GENBUPD_LS
+#define PWM_0_CTL_GENAUPD_LS    PWM_X_CTL_GENAUPD_LS
+#define PWM_0_CTL_MODE          PWM_X_CTL_MODE
+#define PWM_0_CTL_ENABLE        PWM_X_CTL_ENABLE
+#define PWM_1_CTL_GENBUPD_LS    PWM_X_CTL_GENBUPD_LS
+#define PWM_1_CTL_GENAUPD_LS    PWM_X_CTL_GENAUPD_LS
+#define PWM_1_CTL_MODE          PWM_X_CTL_MODE
+#define PWM_1_CTL_ENABLE        PWM_X_CTL_ENABLE
+#define PWM_2_CTL_GENBUPD_LS    PWM_X_CTL_GENBUPD_LS
+#define PWM_2_CTL_GENAUPD_LS    PWM_X_CTL_GENAUPD_LS
+#define PWM_2_CTL_MODE          PWM_X_CTL_MODE
+#define PWM_2_CTL_ENABLE        PWM_X_CTL_ENABLE
+
+#define PWM_0_GENA_ACTCMPAD_ZERO PWM_X_GENA_ACTCMPAD_ZERO
+#define PWM_0_GENA_ACTCMPAU_ONE PWM_X_GENA_ACTCMPAU_ONE
+#define PWM_0_GENA_ACTZERO_ZERO PWM_X_GENA_ACTZERO_ZERO
+#define PWM_0_GENA_ACTZERO_ONE  PWM_X_GENA_ACTZERO_ONE
+#define PWM_0_GENB_ACTCMPBD_ZERO PWM_X_GENB_ACTCMPBD_ZERO
+#define PWM_0_GENB_ACTCMPBU_ONE PWM_X_GENB_ACTCMPBU_ONE
+#define PWM_0_GENB_ACTZERO_ZERO PWM_X_GENB_ACTZERO_ZERO
+#define PWM_0_GENB_ACTZERO_ONE  PWM_X_GENB_ACTZERO_ONE
+#define PWM_1_GENA_ACTCMPAD_ZERO PWM_X_GENA_ACTCMPAD_ZERO
+#define PWM_1_GENA_ACTCMPAU_ONE PWM_X_GENA_ACTCMPAU_ONE
+#define PWM_1_GENA_ACTZERO_ZERO PWM_X_GENA_ACTZERO_ZERO
+#define PWM_1_GENA_ACTZERO_ONE  PWM_X_GENA_ACTZERO_ONE
+#define PWM_1_GENB_ACTCMPBD_ZERO PWM_X_GENB_ACTCMPBD_ZERO
+#define PWM_1_GENB_ACTCMPBU_ONE PWM_X_GENB_ACTCMPBU_ONE
+#define PWM_1_GENB_ACTZERO_ZERO PWM_X_GENB_ACTZERO_ZERO
+#define PWM_1_GENB_ACTZERO_ONE  PWM_X_GENB_ACTZERO_ONE
+#define PWM_2_GENA_ACTCMPAD_ZERO PWM_X_GENA_ACTCMPAD_ZERO
+#define PWM_2_GENA_ACTCMPAU_ONE PWM_X_GENA_ACTCMPAU_ONE
+#define PWM_2_GENA_ACTZERO_ZERO PWM_X_GENA_ACTZERO_ZERO
+#define PWM_2_GENA_ACTZERO_ONE  PWM_X_GENA_ACTZERO_ONE
+
+#endif // __HW_PWM_H__
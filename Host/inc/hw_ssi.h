@@ -0,0 +1,62 @@
+//*****************************************************************************
+//
+// hw_ssi.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+//*****************************************************************************
+
+#ifndef __HW_SSI_H__
+#define __HW_SSI_H__
+
+#define SSI_O_CR0               0x00000000
+#define SSI_O_CR1               0x00000004
+#define SSI_O_DR                0x00000008
+#define SSI_O_SR                0x0000000C
+#define SSI_O_CPSR              0x00000010
+#define SSI_O_IM                0x00000014
+#define SSI_O_RIS               0x00000018
+#define SSI_O_MIS               0x0000001C
+#define SSI_O_ICR               0x00000020
+#define SSI_O_DMACTL            0x00000024
+#define SSI_O_CC                0x00000FC8
+
+#define SSI_CR0_SCR_M           0x0000FF00
+#define SSI_CR0_SCR_S           8
+#define SSI_CR0_SPH             0x00000080
+#define SSI_CR0_SPO             0x00000040
+#define SSI_CR0_FRF_M           0x00000030
+#define SSI_CR0_FRF_MOTO        0x00000000
+#define SSI_CR0_DSS_M           0x0000000F
+#define SSI_CR0_DSS_8           0x00000007
+
+#define SSI_CR1_EOT             0x00000010
+#define SSI_CR1_MS              0x00000004
+#define SSI_CR1_SSE             0x00000002
+#define SSI_CR1_LBM             0x00000001
+
+#define SSI_DR_DATA_M           0x0000FFFF
+
+#define SSI_SR_BSY              0x00000010
+#define SSI_SR_RFF              0x00000008
+#define SSI_SR_RNE              0x00000004
+#define SSI_SR_TNF              0x00000002
+#define SSI_SR_TFE              0x00000001
+
+#define SSI_CPSR_CPSDVSR_M      0x000000FF
+
+#define SSI_IM_TXIM             0x00000008
+#define SSI_IM_RXIM             0x00000004
+#define SSI_IM_RTIM             0x00000002
+#define SSI_IM_RORIM            0x00000001
+
+#define SSI_RIS_TXRIS           0x00000008
+#define SSI_RIS_RXRIS           0x00000004
+#define SSI_RIS_RTRIS           0x00000002
+#define SSI_RIS_RORRIS          0x00000001
+#define SSI_MIS_TXMIS           0x00000008
+
+#define SSI_ICR_RTIC            0x00000002
+#define SSI_ICR_RORIC           0x00000001
+
+#define SSI_CC_CS_SYSPLL        0x00000000
+
+#endif // __HW_SSI_H__
@@ -0,0 +1,59 @@
+//*****************************************************************************
+//
+// hw_sysctl.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+//*****************************************************************************
+
+#ifndef __HW_SYSCTL_H__
+#define __HW_SYSCTL_H__
+
+#define SYSCTL_RCC              0x400FE060
+#define SYSCTL_RCGCTIMER        0x400FE604
+#define SYSCTL_RCGCGPIO         0x400FE608
+#define SYSCTL_RCGCDMA          0x400FE60C
+#define SYSCTL_RCGCUART         0x400FE618
+#define SYSCTL_RCGCSSI          0x400FE61C
+#define SYSCTL_RCGCADC          0x400FE638
+#define SYSCTL_RCGCPWM          0x400FE640
+#define SYSCTL_PRTIMER          0x400FEA04
+#define SYSCTL_PRGPIO           0x400FEA08
+#define SYSCTL_PRDMA            0x400FEA0C
+#define SYSCTL_PRUART           0x400FEA18
+#define SYSCTL_PRSSI            0x400FEA1C
+#define SYSCTL_PRADC            0x400FEA38
+#define SYSCTL_PRPWM            0x400FEA40
+
+#define SYSCTL_RCC_USEPWMDIV    0x00100000
+#define SYSCTL_RCC_PWMDIV_M     0x000E0000
+#define SYSCTL_RCC_PWMDIV_2     0x00000000
+#define SYSCTL_RCC_PWMDIV_32    0x00080000
+#define SYSCTL_RCC_PWMDIV_64    0x000A0000
+
+#define SYSCTL_RCGCTIMER_R5     0x00000020
+#define SYSCTL_RCGCGPIO_R0      0x00000001
+#define SYSCTL_RCGCGPIO_R1      0x00000002
+#define SYSCTL_RCGCGPIO_R2      0x00000004
+#define SYSCTL_RCGCGPIO_R3      0x00000008
+#ifndef SYSCTL_RCGCGPIO_R4
+#define SYSCTL_RCGCGPIO_R4      0x00000010
+#endif
+#define SYSCTL_RCGCGPIO_R5      0x00000020
+#define SYSCTL_RCGCDMA_R0       0x00000001
+#define SYSCTL_RCGCUART_R0      0x00000001
+#define SYSCTL_RCGCUART_R4      0x00000010
+#define SYSCTL_RCGCSSI_R1       0x00000002
+#define SYSCTL_RCGCPWM_R0       0x00000001
+
+#define SYSCTL_PRTIMER_R5       0x00000020
+#define SYSCTL_PRGPIO_R0        0x00000001
+#define SYSCTL_PRGPIO_R1        0x00000002
+#define SYSCTL_PRGPIO_R2        0x00000004
+#define SYSCTL_PRGPIO_R3        0x00000008
+#define SYSCTL_PRGPIO_R4        0x00000010
+#define SYSCTL_PRGPIO_R5        0x00000020
+#define SYSCTL_PRDMA_R0         0x00000001
+#define SYSCTL_PRUART_R4        0x00000010
+#define SYSCTL_PRSSI_R1         0x00000002
+#define SYSCTL_PRPWM_R0         0x00000001
+
+#endif // __HW_SYSCTL_H__
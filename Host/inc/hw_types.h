@@ -0,0 +1,24 @@
+//*****************************************************************************
+//
+// hw_types.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// HWREG and friends resolve to the simulated register file in HostSim.c
+// instead of dereferencing a peripheral address.
+//
+//*****************************************************************************
+
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "HostSim.h"
+
+#define HWREG(x)        (*HostSim_Reg((uint32_t)(x)))
+#define HWREGH(x)       (*(volatile uint16_t *)HostSim_Reg((uint32_t)(x)))
+#define HWREGB(x)       (*(volatile uint8_t *)HostSim_Reg((uint32_t)(x)))
+
+#define CLASS_IS_TM4C123 1
+#define REVISION_IS_A0   0
+
+#endif // __HW_TYPES_H__
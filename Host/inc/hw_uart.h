@@ -0,0 +1,98 @@
+//*****************************************************************************
+//
+// hw_uart.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+//*****************************************************************************
+
+#ifndef __HW_UART_H__
+#define __HW_UART_H__
+
+#define UART_O_DR               0x00000000
+#define UART_O_RSR              0x00000004
+#define UART_O_ECR              0x00000004
+#define UART_O_FR               0x00000018
+#define UART_O_ILPR             0x00000020
+#define UART_O_IBRD             0x00000024
+#define UART_O_FBRD             0x00000028
+#define UART_O_LCRH             0x0000002C
+#define UART_O_CTL              0x00000030
+#define UART_O_IFLS             0x00000034
+#define UART_O_IM               0x00000038
+#define UART_O_RIS              0x0000003C
+#define UART_O_MIS              0x00000040
+#define UART_O_ICR              0x00000044
+#define UART_O_DMACTL           0x00000048
+#define UART_O_CC               0x00000FC8
+
+#define UART_DR_OE              0x00000800
+#define UART_DR_BE              0x00000400
+#define UART_DR_PE              0x00000200
+#define UART_DR_FE              0x00000100
+#define UART_DR_DATA_M          0x000000FF
+
+#define UART_FR_TXFE            0x00000080
+#define UART_FR_RXFF            0x00000040
+#define UART_FR_TXFF            0x00000020
+#define UART_FR_RXFE            0x00000010
+#define UART_FR_BUSY            0x00000008
+
+#define UART_LCRH_SPS           0x00000080
+#define UART_LCRH_WLEN_M        0x00000060
+#define UART_LCRH_WLEN_8        0x00000060
+#define UART_LCRH_FEN           0x00000010
+#define UART_LCRH_STP2          0x00000008
+#define UART_LCRH_EPS           0x00000004
+#define UART_LCRH_PEN           0x00000002
+#define UART_LCRH_BRK           0x00000001
+
+#define UART_CTL_RXE            0x00000200
+#define UART_CTL_TXE            0x00000100
+#define UART_CTL_LBE            0x00000080
+#define UART_CTL_HSE            0x00000020
+#define UART_CTL_EOT            0x00000010
+#define UART_CTL_UARTEN         0x00000001
+
+#define UART_IFLS_RX_M          0x00000038
+#define UART_IFLS_RX1_8         0x00000000
+#define UART_IFLS_RX2_8         0x00000008
+#define UART_IFLS_RX4_8         0x00000010
+#define UART_IFLS_RX6_8         0x00000018
+#define UART_IFLS_RX7_8         0x00000020
+#define UART_IFLS_TX_M          0x00000007
+#define UART_IFLS_TX1_8         0x00000000
+#define UART_IFLS_TX2_8         0x00000001
+#define UART_IFLS_TX4_8         0x00000002
+#define UART_IFLS_TX6_8         0x00000003
+#define UART_IFLS_TX7_8         0x00000004
+
+#define UART_IM_OEIM            0x00000400
+#define UART_IM_BEIM            0x00000200
+#define UART_IM_PEIM            0x00000100
+#define UART_IM_FEIM            0x00000080
+#define UART_IM_RTIM            0x00000040
+#define UART_IM_TXIM            0x00000020
+#define UART_IM_RXIM            0x00000010
+
+#define UART_RIS_OERIS          0x00000400
+#define UART_RIS_RTRIS          0x00000040
+#define UART_RIS_TXRIS          0x00000020
+#define UART_RIS_RXRIS          0x00000010
+
+#define UART_MIS_OEMIS          0x00000400
+#define UART_MIS_RTMIS          0x00000040
+#define UART_MIS_TXMIS          0x00000020
+#define UART_MIS_RXMIS          0x00000010
+
+#define UART_ICR_OEIC           0x00000400
+#define UART_ICR_RTIC           0x00000040
+#define UART_ICR_TXIC           0x00000020
+#define UART_ICR_RXIC           0x00000010
+
+#define UART_DMACTL_DMAERR      0x00000004
+#define UART_DMACTL_TXDMAE      0x00000002
+#define UART_DMACTL_RXDMAE      0x00000001
+
+#define UART_CC_CS_SYSCLK       0x00000000
+#define UART_CC_CS_PIOSC        0x00000005
+
+#endif // __HW_UART_H__
@@ -0,0 +1,26 @@
+//*****************************************************************************
+//
+// hw_watchdog.h - host (Linux) stand-in for the TivaWare header of the same
+// name
+//
+//*****************************************************************************
+
+#ifndef __HW_WATCHDOG_H__
+#define __HW_WATCHDOG_H__
+
+#define WDT_O_LOAD              0x00000000
+#define WDT_O_VALUE             0x00000004
+#define WDT_O_CTL               0x00000008
+#define WDT_O_ICR               0x0000000C
+#define WDT_O_RIS               0x00000010
+#define WDT_O_MIS               0x00000014
+#define WDT_O_TEST              0x00000418
+#define WDT_O_LOCK              0x00000C00
+
+#define WDT_CTL_RESEN           0x00000002
+#define WDT_CTL_INTEN           0x00000001
+#define WDT_RIS_WDTRIS          0x00000001
+#define WDT_TEST_STALL          0x00000100
+#define WDT_LOCK_UNLOCK         0x1ACCE551
+
+#endif // __HW_WATCHDOG_H__
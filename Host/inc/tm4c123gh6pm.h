@@ -0,0 +1,48 @@
+//*****************************************************************************
+//
+// tm4c123gh6pm.h - host (Linux) stand-in for the TI device header
+//
+// Only the register names used by ADMulti.c are provided; they go through
+// HWREG so that they land in the simulated register file.
+//
+//*****************************************************************************
+
+#ifndef __TM4C123GH6PM_H__
+#define __TM4C123GH6PM_H__
+
+#include "inc/hw_types.h"
+
+#define GPIO_PORTE_DIR_R        HWREG(0x40024400)
+#define GPIO_PORTE_AFSEL_R      HWREG(0x40024420)
+#define GPIO_PORTE_DEN_R        HWREG(0x4002451C)
+#define GPIO_PORTE_AMSEL_R      HWREG(0x40024528)
+
+#define ADC0_ACTSS_R            HWREG(0x40038000)
+#define ADC0_RIS_R              HWREG(0x40038004)
+#define ADC0_IM_R               HWREG(0x40038008)
+#define ADC0_ISC_R              HWREG(0x4003800C)
+#define ADC0_EMUX_R             HWREG(0x40038014)
+#define ADC0_SSPRI_R            HWREG(0x40038020)
+#define ADC0_PSSI_R             HWREG(0x40038028)
+#define ADC0_SSMUX2_R           HWREG(0x40038080)
+#define ADC0_SSCTL2_R           HWREG(0x40038084)
+#define ADC0_SSFIFO2_R          HWREG(0x40038088)
+#define ADC0_PC_R               HWREG(0x40038FC4)
+
+#define SYSCTL_RCGCGPIO_R       HWREG(0x400FE608)
+#define SYSCTL_RCGCADC_R        HWREG(0x400FE638)
+
+#define ADC_SSCTL2_IE3          0x00004000
+#define ADC_SSCTL2_END3         0x00002000
+#define ADC_SSCTL2_IE2          0x00000400
+#define ADC_SSCTL2_END2         0x00000200
+#define ADC_SSCTL2_IE1          0x00000040
+#define ADC_SSCTL2_END1         0x00000020
+#define ADC_SSCTL2_IE0          0x00000004
+#define ADC_SSCTL2_END0         0x00000002
+
+#ifndef SYSCTL_RCGCGPIO_R4
+#define SYSCTL_RCGCGPIO_R4      0x00000010
+#endif
+
+#endif // __TM4C123GH6PM_H__
@@ -0,0 +1,18 @@
+//*****************************************************************************
+//
+// uartstdio.h - host (Linux) stand-in for the TivaWare header of the same name
+//
+// The console is the process's stdin/stdout; see Host/HostTermio.c.
+//
+//*****************************************************************************
+
+#ifndef __UARTSTDIO_H__
+#define __UARTSTDIO_H__
+
+#include <stdint.h>
+
+void UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud, uint32_t ui32SrcClock);
+void UARTprintf(const char *pcString, ...);
+unsigned char UARTgetc(void);
+
+#endif // __UARTSTDIO_H__
@@ -7,9 +7,25 @@
 	 to implement to facilitate bug-free interoperability. It handles the decision making structure 
 	 for incoming data packets and actuates the hovercraft's peripherals accordingly.
 
+ Notes
+   Received frames arrive in packet buffers (ES_Buffer.c) and are passed on
+   to DOG_SM in the same buffer. Each transmitted frame is built in a buffer
+   of its own, which is kept until the next one in case it has to be resent
+   At start up (ES_SET_XBEE_BAUD, once UART4 is up) it switches the XBee to
+   XBEE_BAUD with the BD AT command, asked at the rate the XBee starts at
+   and then, if that gets no answer, at XBEE_BAUD in case the XBee is there
+   already from before the TIVA was reset. UART4 follows once the XBee has
+   answered, as the XBee answers at the old rate. With no answer at either,
+   the link stays at XBEE_DEFAULT_BAUD
+
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26               switch the XBee to XBEE_BAUD at start up
+ 10/17/26               decrypt commands on arrival for the latest-command
+                        queue policy of DOG_SM
+ 10/17/26               TX frames take a buffer of the size they need
+ 10/17/26               frames are carried in ES packet buffers
  05/14/2017			MCH
 ****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
@@ -27,17 +43,20 @@
 /*---------------------------- Module Functions ---------------------------*/
 uint8_t CalculateChecksum (uint8_t FrameLength);
 void ConstructIMUData (void);
+static void SendBaudCommand (void);
 
 /*---------------------------- Module Variables ---------------------------*/
 static uint8_t MyPriority;
 
 static uint8_t* DataPacket_Rx;
-static uint8_t DataPacket_Tx[MAX_PACKET_LENGTH];
+static uint8_t* DataPacket_Tx;
+static ES_BufHandle_t LastTxBuffer = ES_NO_BUFFER; // kept for a resend
 static uint8_t DataFrameLength_Tx;
 static uint8_t API_Ident;
 static ES_Event DeferralQueue[3+1];
 
 static uint8_t* IMU_Data;
+static LinkState_t LinkState = LinkAtDefault;
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -120,18 +139,21 @@ ES_Event RunComm_Service( ES_Event ThisEvent )
   {
     case ES_DATAPACKET_RECEIVED  : 
 			
-			  DataPacket_Rx	= GetDataPacket();
+			  DataPacket_Rx	= ES_BufData(ThisEvent.Buffer);
+				if (DataPacket_Rx == NULL) {
+					break;
+				}
 				/*for (int i = 0; i < 5; i++) {
 					printf("%i \n\r", *(DataPacket_Rx + i));
 				}*/
-				API_Ident = GetAPIIdentifier(); //API_IDENT_BYTE_INDEX_RX);
+				API_Ident = *(DataPacket_Rx + API_IDENT_BYTE_INDEX_RX);
 		    printf("datapacket received in comm service: %i \n\r", API_Ident);
 				if (API_Ident == API_IDENTIFIER_Rx) {
 					  ES_Event NewEvent;
 					  uint8_t PacketType = 0;
 						DOGState_t CurrentState = GetDOGState();
 						if (CurrentState == Paired) {
-							PacketType = GetHeader();
+							PacketType = GetHeader(DataPacket_Rx);
 						} else {
 							PacketType = *(DataPacket_Rx + PACKET_TYPE_BYTE_INDEX_RX);
 						}
@@ -147,6 +169,10 @@ ES_Event RunComm_Service( ES_Event ThisEvent )
 								break;
 							case FARMER_DOG_CTRL:
 								printf("received CMD\r\n");
+								//decrypt it now, DOG_SM may only see the latest one
+								if (CurrentState == Paired) {
+									DecryptCommand(DataPacket_Rx);
+								}
 								NewEvent.EventType = ES_NEW_CMD_RECEIVED;
 								break;
 							default:
@@ -159,7 +185,7 @@ ES_Event RunComm_Service( ES_Event ThisEvent )
 						}
 						//printf("about to post to DOG SM \n\r");
 						NewEvent.EventParam = ThisEvent.EventParam; //the frame length
-						PostDOG_SM(NewEvent);
+						ES_PostWithBuffer(PostDOG_SM, NewEvent, ThisEvent.Buffer);
 					} else if (API_Ident == API_IDENTIFIER_Tx_Result) { 
 						#ifdef COMM_TEST_PRINTS
 						printf("RECEIVED A TRANSMISSION RESULT DATAPACKET (Comm_Service) \n\r");
@@ -172,13 +198,48 @@ ES_Event RunComm_Service( ES_Event ThisEvent )
 							ES_Event NewEvent;
 							NewEvent.EventType = ES_START_XMIT;
 							NewEvent.EventParam = DataFrameLength_Tx;
-							PostTransmit_SM(NewEvent);
+							ES_PostWithBuffer(PostTransmit_SM, NewEvent, LastTxBuffer);
 						}
 					} else if (API_Ident == API_IDENTIFIER_Reset) {
 						printf("Hardware Reset Status Message \n\r");
+					} else if ((API_Ident == API_IDENTIFIER_AT_Result) &&
+					           (DataPacket_Rx[AT_COMMAND_BYTE_INDEX_RX] == 'B') &&
+					           (DataPacket_Rx[AT_COMMAND_BYTE_INDEX_RX + 1] == 'D') &&
+					           (DataPacket_Rx[AT_STATUS_BYTE_INDEX_RX] == SUCCESS)) {
+						// the XBee has taken the new rate, and goes to it now
+						if ((LinkState == AskedAtDefault) || (LinkState == AskedAtLinkBaud)) {
+							ES_Timer_StopTimer(LINK_TIMER);
+							if (LinkState == AskedAtDefault) {
+								UART_SetBaud(XBEE_BAUD);
+							}
+							LinkState = LinkAtLinkBaud;
+						}
 					}
     break;
 
+    case ES_SET_XBEE_BAUD :
+			if (XBEE_BAUD != XBEE_DEFAULT_BAUD) {
+				SendBaudCommand();
+				LinkState = AskedAtDefault;
+			}
+    break;
+
+    case ES_TIMEOUT :
+			if (ThisEvent.EventParam != LINK_TIMER) {
+				break;
+			}
+			if (LinkState == AskedAtDefault) {
+				// no answer, try the XBee at the rate it may have kept
+				UART_SetBaud(XBEE_BAUD);
+				SendBaudCommand();
+				LinkState = AskedAtLinkBaud;
+			} else if (LinkState == AskedAtLinkBaud) {
+				printf("No answer from the XBee (Comm_Service) \n\r");
+				UART_SetBaud(XBEE_DEFAULT_BAUD);
+				LinkState = LinkAtDefault;
+			}
+    break;
+
     case ES_CONSTRUCT_DATAPACKET :
 			    #ifdef COMM_TEST_PRINTS
 					printf("--------------CONSTRUCTING-----------\n\r");
@@ -187,6 +248,21 @@ ES_Event RunComm_Service( ES_Event ThisEvent )
 		      #ifdef COMM_TEST_PRINTS
 					printf("Constructing Datapacket (Comm_Service) \n\r");
 					#endif
+					//store the length of the data frame, the status report is the
+					//only long one
+					if (ThisEvent.EventParam == DOG_FARMER_REPORT) {
+						DataFrameLength_Tx = STATUS_FRAME_LEN;
+					} else {
+						DataFrameLength_Tx = ACK_N_ENCRYPT_FRAME_LEN;
+					}
+					// the last frame can't be resent once there is a newer one
+					ES_BufRelease(LastTxBuffer);
+					LastTxBuffer = ES_BufAlloc(HEADER_LENGTH + DataFrameLength_Tx + 1 /*checksum*/);
+					DataPacket_Tx = ES_BufData(LastTxBuffer);
+					if (DataPacket_Tx == NULL) {
+						printf("No buffer for the datapacket (Comm_Service) \n\r");
+						break;
+					}
 		      DataPacket_Tx[START_BYTE_INDEX] = START_DELIMITER;
 					DataPacket_Tx[LENGTH_MSB_BYTE_INDEX] = 0x00; 
 					DataPacket_Tx[API_IDENT_BYTE_INDEX_TX] = API_IDENTIFIER_Tx;
@@ -198,24 +274,18 @@ ES_Event RunComm_Service( ES_Event ThisEvent )
 					switch (ThisEvent.EventParam) {
 						case DOG_ACK:
 							//printf("Dog Ack Construction \n\r");
-							//store the length of the data frame
-						  DataFrameLength_Tx = ACK_N_ENCRYPT_FRAME_LEN;
 							//add the packet type
 							DataPacket_Tx[PACKET_TYPE_BYTE_INDEX_TX] = DOG_ACK;
 							//no extra data
 							break;
 						case DOG_FARMER_RESET_ENCR:
 							//printf("Reset Encryption Construction \n\r");
-						  //store the length of the data frame
-						  DataFrameLength_Tx = ACK_N_ENCRYPT_FRAME_LEN;
 							//add the packet type
 							DataPacket_Tx[PACKET_TYPE_BYTE_INDEX_TX] = DOG_FARMER_RESET_ENCR;
 							//no extra data
 							break;
 						case DOG_FARMER_REPORT:
 							//printf("Dog Report Construction \n\r");
-						  //store the length of the data frame
-						  DataFrameLength_Tx = STATUS_FRAME_LEN;
 							//add the packet type
 							DataPacket_Tx[PACKET_TYPE_BYTE_INDEX_TX] = DOG_FARMER_REPORT;
 							//add in data from IMU SERVICE
@@ -237,7 +307,7 @@ ES_Event RunComm_Service( ES_Event ThisEvent )
 					NewEvent.EventParam = DataFrameLength_Tx;						
 					 //param is length of entire data packet
 					//Post NewEvent to transmit service
-					PostTransmit_SM(NewEvent);
+					ES_PostWithBuffer(PostTransmit_SM, NewEvent, LastTxBuffer);
     break;
 
 						default:
@@ -263,6 +333,57 @@ uint8_t CalculateChecksum (uint8_t FrameLength) {
 	return Checksum;
 }
 
+// sends the AT command frame that sets the XBee's rate to XBEE_BAUD, and
+// starts LINK_TIMER for the answer. The standard rates go as the XBee's BD
+// code (0 to 7), any other as the rate itself
+static void SendBaudCommand (void) {
+	static const uint32_t StandardRates[] = { 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200 };
+	uint8_t Code;
+	uint8_t FrameLength = 4; // API identifier, frame ID and the command
+	uint8_t* pFrame;
+	uint8_t RunningSum = 0;
+	
+	for (Code = 0; Code < ARRAY_SIZE(StandardRates); Code++) {
+		if (StandardRates[Code] == XBEE_BAUD) break;
+	}
+	FrameLength += (Code < ARRAY_SIZE(StandardRates)) ? 1 : 4;
+	
+	ES_BufHandle_t Buffer = ES_BufAlloc(HEADER_LENGTH + FrameLength + 1 /*checksum*/);
+	pFrame = ES_BufData(Buffer);
+	if (pFrame == NULL) {
+		printf("No buffer for the AT command (Comm_Service) \n\r");
+		return;
+	}
+	pFrame[START_BYTE_INDEX] = START_DELIMITER;
+	pFrame[LENGTH_MSB_BYTE_INDEX] = 0x00;
+	pFrame[LENGTH_LSB_BYTE_INDEX] = FrameLength;
+	pFrame[API_IDENT_BYTE_INDEX_TX] = API_IDENTIFIER_AT;
+	pFrame[FRAME_ID_BYTE_INDEX] = FRAME_ID;
+	pFrame[FRAME_ID_BYTE_INDEX + 1] = 'B';
+	pFrame[FRAME_ID_BYTE_INDEX + 2] = 'D';
+	if (Code < ARRAY_SIZE(StandardRates)) {
+		pFrame[FRAME_ID_BYTE_INDEX + 3] = Code;
+	} else {
+		pFrame[FRAME_ID_BYTE_INDEX + 3] = (uint8_t)(XBEE_BAUD >> 24);
+		pFrame[FRAME_ID_BYTE_INDEX + 4] = (uint8_t)(XBEE_BAUD >> 16);
+		pFrame[FRAME_ID_BYTE_INDEX + 5] = (uint8_t)(XBEE_BAUD >> 8);
+		pFrame[FRAME_ID_BYTE_INDEX + 6] = (uint8_t)XBEE_BAUD;
+	}
+	for (int i = HEADER_LENGTH; i < HEADER_LENGTH + FrameLength; i++) {
+		RunningSum += pFrame[i];
+	}
+	pFrame[HEADER_LENGTH + FrameLength] = 0xFF - RunningSum;
+	
+	ES_Event NewEvent;
+	NewEvent.EventType = ES_START_XMIT;
+	NewEvent.EventParam = FrameLength;
+	ES_PostWithBuffer(PostTransmit_SM, NewEvent, Buffer);
+	// the queued event holds its own reference to the buffer
+	ES_BufRelease(Buffer);
+	
+	ES_Timer_InitTimer(LINK_TIMER, LINK_TIME);
+}
+
 void ConstructIMUData (void) {
 	uint8_t DataPacketIndex = PACKET_TYPE_BYTE_INDEX_TX + 1;
 	for (int i = 0; i < IMU_DATA_NUM_BYTES; i++) {
@@ -271,9 +392,4 @@ void ConstructIMUData (void) {
 }
 
 
-/******GETTER FUNCTIONS************/
-uint8_t* GetDataPacket_Tx (void) {
-  return &DataPacket_Tx[0];
-}
-
 
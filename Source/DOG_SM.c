@@ -10,18 +10,38 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26               the machine is a table for the framework's HSM engine
+                        (ES_HSM.c), with the lost comm handling in the
+                        Connected superstate and the entry and exit actions
+                        run once per state change
+ 10/17/26               added DOG_QueueOverflow, which lands the craft when
+                        the lost comm timeout can't be queued
+ 10/17/26               the status and the start of wagging are posted as
+                        one batch
+ 10/17/26               the state on each event goes in the trace
+                        (ES_TRACE_SIZE) instead of being printed
+ 10/17/26               commands are decrypted as they arrive (DecryptCommand)
+ 10/17/26               read the frames from the event's packet buffer
  05/14/2017			MCH
 ****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
 #include "ES_Configure.h"
 #include "ES_Framework.h"
 #include "ES_DeferRecall.h"
+#include "ES_HSM.h"
 
 #include "Hardware.h"
 #include "Constants.h"
 #include "DOG_SM.h"
 
 /*----------------------------- Module Defines ----------------------------*/
+// the state on each event goes in the trace when there is one, since
+// printing it takes longer than the rest of the run function
+#ifdef ES_TRACE_SIZE
+#define ShowState() ES_TracePoint( TRACE_DOG_STATE, GetDOGState() )
+#else
+#define ShowState() printf("DOG state %i \n\r", GetDOGState())
+#endif
 
 /*---------------------------- Module Functions ---------------------------*/
 void StoreEncryptionKey(void);
@@ -31,11 +51,62 @@ void TransmitAck(void);
 void StopWagging(void);
 void StartWagging(void);
 void InitDogTag(void);
-void DecodeCommandMessage(void);
+
+static bool HasPacket(ES_Event ThisEvent);
+static bool IsLostCommTimeout(ES_Event ThisEvent);
+static bool IsMyPairRequest(ES_Event ThisEvent);
+static void PairWithFarmer(ES_Event ThisEvent);
+static void AcceptKey(ES_Event ThisEvent);
+static void ExecuteCommand(ES_Event ThisEvent);
+static void EnterWaiting2Pair(void);
+static void EnterConnected(void);
+static void ExitConnected(void);
+static void EnterPaired(void);
+
+/*---------------------------- State Tables -------------------------------*/
+// Waiting2Pair, and Connected holding Paired_Waiting4Key and Paired. Losing
+// the link from either of the paired states lands the craft (leaving
+// Connected) and goes back to waiting for a pair request
+static const ES_HSMState_t Waiting2PairState;
+static const ES_HSMState_t ConnectedState;
+static const ES_HSMState_t Paired_Waiting4KeyState;
+static const ES_HSMState_t PairedState;
+
+static const ES_HSMTransition_t Waiting2PairTransitions[] = {
+	{ ES_PAIR_REQUEST_RECEIVED, IsMyPairRequest, PairWithFarmer, &ConnectedState }
+};
+static const ES_HSMTransition_t ConnectedTransitions[] = {
+	{ ES_UNPAIR, NULL, NULL, &Waiting2PairState },
+	{ ES_TIMEOUT, IsLostCommTimeout, NULL, &Waiting2PairState }
+};
+static const ES_HSMTransition_t Paired_Waiting4KeyTransitions[] = {
+	{ ES_ENCRYPTION_KEY_RECEIVED, HasPacket, AcceptKey, &PairedState }
+};
+static const ES_HSMTransition_t PairedTransitions[] = {
+	{ ES_NEW_CMD_RECEIVED, HasPacket, ExecuteCommand, NULL }
+};
+
+static const ES_HSMState_t Waiting2PairState = {
+	NULL, NULL, EnterWaiting2Pair, NULL,
+	Waiting2PairTransitions, ARRAY_SIZE(Waiting2PairTransitions), Waiting2Pair
+};
+static const ES_HSMState_t ConnectedState = {
+	NULL, &Paired_Waiting4KeyState, EnterConnected, ExitConnected,
+	ConnectedTransitions, ARRAY_SIZE(ConnectedTransitions), Connected
+};
+static const ES_HSMState_t Paired_Waiting4KeyState = {
+	&ConnectedState, NULL, NULL, NULL,
+	Paired_Waiting4KeyTransitions, ARRAY_SIZE(Paired_Waiting4KeyTransitions),
+	Paired_Waiting4Key
+};
+static const ES_HSMState_t PairedState = {
+	&ConnectedState, NULL, EnterPaired, NULL,
+	PairedTransitions, ARRAY_SIZE(PairedTransitions), Paired
+};
 
 /*---------------------------- Module Variables ---------------------------*/
 static uint8_t MyPriority;
-static DOGState_t CurrentState;
+static ES_HSM_t DOGMachine;
 
 static uint8_t DogTag = 0;
 static uint32_t ADResults[1];
@@ -56,6 +127,10 @@ static uint8_t Turning;
 static uint8_t Brake;
 static uint8_t Peripheral;
 
+// set when DOG_QueueOverflow has landed the craft, so that it is only done
+// once while the queue stays full
+static bool LandedOnOverflow = false;
+
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -78,12 +153,9 @@ static uint8_t Peripheral;
 ****************************************************************************/
 bool InitDOG_SM ( uint8_t Priority )
 {
-  //ES_Event ThisEvent;
+  ES_Event ThisEvent;
 
   MyPriority =  Priority;
-	
-  // put us into the Initial PseudoState
-  CurrentState = Waiting2Pair;
 
 //GET DOG TAG NUMBER
 	//InitDogTag();
@@ -92,8 +164,10 @@ bool InitDOG_SM ( uint8_t Priority )
 	printf("DOGTAG#: %i \n\r", DogTag);	
 	InitAll(); //initialize all hardware (ports, pins, interrupts)
 	
-	
-  return true;
+  // the machine starts on ES_INIT, once DogTail_Service's queue is set up
+  // for the entry into Waiting2Pair to post to
+  ThisEvent.EventType = ES_INIT;
+  return PostDOG_SM(ThisEvent);
 }
 
 /****************************************************************************
@@ -118,6 +192,41 @@ bool PostDOG_SM( ES_Event ThisEvent )
   return ES_PostToService( MyPriority, ThisEvent);
 }
 
+/****************************************************************************
+ Function
+     DOG_QueueOverflow
+
+ Parameters
+     uint8_t : the service whose queue was full (SERV_DOG_SM)
+     ES_Event : the event that did not fit
+
+ Returns
+     nothing
+
+ Description
+     The ES_OVERFLOW_HANDLER (ES_Configure.h): called by the framework when
+     a post finds this state machine's queue full. A timeout is tried again
+     on the next tick rather than lost, and if it is the lost comm timeout
+     the craft is landed straight away instead of hovering on until the
+     queue drains. Anything else is dropped: the farmer sends commands
+     several times a second
+ Notes
+     called from whatever made the post, usually the timer tick interrupt
+****************************************************************************/
+void DOG_QueueOverflow( uint8_t WhichService, ES_Event ThisEvent )
+{
+	(void)WhichService;
+	
+	if (ThisEvent.EventType != ES_TIMEOUT) {
+		return;
+	}
+	if ((ThisEvent.EventParam == LOST_COMM_TIMER) && (LandedOnOverflow == false)) {
+		DeactivateHover();
+		LandedOnOverflow = true;
+	}
+	ES_Timer_InitTimer(ThisEvent.EventParam, 1);
+}
+
 /****************************************************************************
  Function
     RunDOG_SM
@@ -129,9 +238,10 @@ bool PostDOG_SM( ES_Event ThisEvent )
    ES_Event, ES_NO_EVENT if no error ES_ERROR otherwise
 
  Description
-   add your description here
+   starts the machine on ES_INIT and hands every other event to it
  Notes
-   uses nested switch/case to implement the machine.
+   the states and transitions are the tables at the top of this file, run
+   by ES_HSMDispatch.
  Author
    Mihika Hemmady
 ****************************************************************************/
@@ -139,154 +249,114 @@ ES_Event RunDOG_SM( ES_Event ThisEvent )
 {
   ES_Event ReturnEvent;
   ReturnEvent.EventType = ES_NO_EVENT; // assume no errors
-	DOGState_t NextState;
-
-	/*
-	printf("Event was posted \n\r");
-  if (CurrentState == Waiting2Pair) {
-		printf("Waiting 2 Pair \n\r");
-	} else if (CurrentState == Paired_Waiting4Key) {
-		printf("Paired_Waiting4Key \n\r");
-	} else if (CurrentState == Paired) {
-		printf("Paired \n\r");
+
+	//the queue has room again, so a timeout that overflowed will get in
+	LandedOnOverflow = false;
+
+	if (ThisEvent.EventType == ES_INIT) {
+		ES_HSMStart(&DOGMachine, &Waiting2PairState);
 	} else {
-		printf("THERES A FOURTH STATE! \n\r");
-	} */
-	
-	switch ( CurrentState )
-  {
-    case Waiting2Pair : 
-			printf("waiting 2 pair state \n\r");
-			
-				//initialize encryption key index
-				EncryptionKey_Index = 0;
-		
-		   //stop wagging
-				StopWagging();
-		
-				if (ThisEvent.EventType == ES_PAIR_REQUEST_RECEIVED) {
-          DataPacket_Rx = GetDataPacket();
-          uint8_t DogTagReq = *(DataPacket_Rx + DOG_TAG_BYTE_INDEX);
-          if (DogTagReq == DogTag) {
-            PairedFarmer_MSB = *(DataPacket_Rx + SOURCE_ADDRESS_MSB_INDEX);
-            PairedFarmer_LSB = *(DataPacket_Rx + SOURCE_ADDRESS_LSB_INDEX);
-            
-            //Transmit an 0x02 PAIR_ACK message to FARMER
-            TransmitAck();
-            
-            //turn the Lift Fan On
-            ActivateHover();
-												
-						//start the lost-communications timer for 1s
-						ES_Timer_InitTimer(LOST_COMM_TIMER, LOST_COMM_TIME);
-						
-            NextState = Paired_Waiting4Key;
-          } 
-        } else {
-						NextState = Waiting2Pair;
-				} 
-    break;
-
-    case Paired_Waiting4Key: 
-				printf("Paired Waiting4Key \n\r");
-				if (ThisEvent.EventType == ES_ENCRYPTION_KEY_RECEIVED) {
-					DataPacket_Rx = GetDataPacket();
-					StoreEncryptionKey();
-					//start the lost-communications timer for 1s
-					ES_Timer_InitTimer(LOST_COMM_TIMER, LOST_COMM_TIME);
-					
-					//transmit status
-					TransmitStatus();
-					
-					//Start Tail Wag Service!!
-					StartWagging();
-					
-					NextState = Paired;
-				} else if ((ThisEvent.EventType == ES_UNPAIR) || (ThisEvent.EventType == ES_TIMEOUT 
-																						&& ThisEvent.EventParam == LOST_COMM_TIMER)) {
-						printf("Lost Comm Timer Timeout \n\r");
-						DeactivateHover();
-						NextState = Waiting2Pair;
-						StopWagging();
-				} else {
-					NextState = Paired_Waiting4Key;
-				}					
-    break;
-
-		case Paired:
-				printf("Paired \n\r");
-				if ( ThisEvent.EventType == ES_NEW_CMD_RECEIVED) {
-					DataPacket_Rx = GetDataPacket();
-					//start the lost-communications timer for 1s
-					ES_Timer_InitTimer(LOST_COMM_TIMER, LOST_COMM_TIME);
-          //decode
-					DecodeCommandMessage();
-				
-					//executed commands as required
-						DirectionSpeed = DecryptedFarmerCommands[1];
-						//printf("DECRYPTED Direction/Speed: %i \n\r", DirectionSpeed);
-						Turning = DecryptedFarmerCommands[2];
-						//printf("DECRYPTED Turning: %i \n\r", Turning);
-						//printf("DECRYPTED Digital: %i \n\r", DecryptedFarmerCommands[3]);
-						switch ((DecryptedFarmerCommands[3] & DIGITAL_MASK)) {
-							case 0x00:
-								Peripheral = OFF;
-								Brake = OFF;
-								break;
-							case 0x01:
-								Peripheral = ON;
-								Brake = OFF;
-								break;
-							case 0x02:
-								Peripheral = OFF;
-								Brake = ON;
-								break;
-							case 0x03:
-								Peripheral = ON;
-								Brake = ON;
-								break;
-							default:
-								Peripheral = OFF;
-								Brake = OFF;
-							break;
-						}
-						//printf("DECRYPTED Peripheral: %i \n\r", Peripheral);
-						//printf("DECRYPTED Brake: %i \n\r", Brake);
-						ActivateDirectionSpeed(DirectionSpeed, Turning);
-						ActivatePeripheral(Peripheral);
-						ActivateBrake(Brake);
-						
-						//tranmsit status message
-						TransmitStatus();
-/*
-					} else {
-						printf("Reset the encryption key \n\r");
-						//reset encryption
-						TransmitResetEncryption();
-						//reset the encryption key
-						EncryptionKey_Index = 0;
-						
-						ES_Timer_InitTimer(LOST_COMM_TIMER, LOST_COMM_TIME);
-					} */
-					
-					NextState = Paired;
-				} else if ((ThisEvent.EventType == ES_UNPAIR) || (ThisEvent.EventType == ES_TIMEOUT 
-																						&& ThisEvent.EventParam == LOST_COMM_TIMER)) {
-						printf("Lost Comm Timer Timeout \n\r");
-						DeactivateHover();
-						NextState = Waiting2Pair;
-						StopWagging();
-				} else {
-					NextState = Paired;
-				}					
-
-    break;
-		
-  }                                  // end switch on Current State
-  CurrentState = NextState;
+		ShowState();
+		ES_HSMDispatch(&DOGMachine, ThisEvent);
+	}
   return ReturnEvent;
 }
 
+/******Guards, actions, entry and exit functions******/
+static bool HasPacket(ES_Event ThisEvent) {
+	return ES_BufData(ThisEvent.Buffer) != NULL;
+}
+
+static bool IsLostCommTimeout(ES_Event ThisEvent) {
+	return ThisEvent.EventParam == LOST_COMM_TIMER;
+}
+
+static bool IsMyPairRequest(ES_Event ThisEvent) {
+	uint8_t* pPacket = ES_BufData(ThisEvent.Buffer);
+	return (pPacket != NULL) && (*(pPacket + DOG_TAG_BYTE_INDEX) == DogTag);
+}
+
+static void PairWithFarmer(ES_Event ThisEvent) {
+	DataPacket_Rx = ES_BufData(ThisEvent.Buffer);
+	PairedFarmer_MSB = *(DataPacket_Rx + SOURCE_ADDRESS_MSB_INDEX);
+	PairedFarmer_LSB = *(DataPacket_Rx + SOURCE_ADDRESS_LSB_INDEX);
+	
+	//Transmit an 0x02 PAIR_ACK message to FARMER
+	TransmitAck();
+}
+
+static void AcceptKey(ES_Event ThisEvent) {
+	DataPacket_Rx = ES_BufData(ThisEvent.Buffer);
+	StoreEncryptionKey();
+	//start the lost-communications timer for 1s
+	ES_Timer_InitTimer(LOST_COMM_TIMER, LOST_COMM_TIME);
+}
+
+static void ExecuteCommand(ES_Event ThisEvent) {
+	DataPacket_Rx = ES_BufData(ThisEvent.Buffer);
+	//start the lost-communications timer for 1s
+	ES_Timer_InitTimer(LOST_COMM_TIMER, LOST_COMM_TIME);
+	//Comm_Service decrypted the command in its buffer when it arrived
+	for (int i = 0; i < FARMER_CMD_LENGTH; i++) {
+		DecryptedFarmerCommands[i] = *(DataPacket_Rx + PACKET_TYPE_BYTE_INDEX_RX + i);
+	}
+
+	//executed commands as required
+	DirectionSpeed = DecryptedFarmerCommands[1];
+	Turning = DecryptedFarmerCommands[2];
+	switch ((DecryptedFarmerCommands[3] & DIGITAL_MASK)) {
+		case 0x01:
+			Peripheral = ON;
+			Brake = OFF;
+			break;
+		case 0x02:
+			Peripheral = OFF;
+			Brake = ON;
+			break;
+		case 0x03:
+			Peripheral = ON;
+			Brake = ON;
+			break;
+		default:
+			Peripheral = OFF;
+			Brake = OFF;
+			break;
+	}
+	ActivateDirectionSpeed(DirectionSpeed, Turning);
+	ActivatePeripheral(Peripheral);
+	ActivateBrake(Brake);
+	
+	//tranmsit status message
+	TransmitStatus();
+}
+
+static void EnterWaiting2Pair(void) {
+	//initialize encryption key index
+	EncryptionKey_Index = 0;
+	StopWagging();
+}
+
+static void EnterConnected(void) {
+	//turn the Lift Fan On
+	ActivateHover();
+	//start the lost-communications timer for 1s
+	ES_Timer_InitTimer(LOST_COMM_TIMER, LOST_COMM_TIME);
+}
+
+static void ExitConnected(void) {
+	DeactivateHover();
+}
+
+static void EnterPaired(void) {
+	uint32_t SavedPRIMASK;
+
+	//transmit status and start the Tail Wag Service together
+	SavedPRIMASK = ES_BeginPostBatch();
+	TransmitStatus();
+	StartWagging();
+	ES_EndPostBatch(SavedPRIMASK);
+}
+
 /******Helper function******/
 void StoreEncryptionKey(void) {
 	uint16_t DataIndex = PACKET_TYPE_BYTE_INDEX_RX + 1;
@@ -295,17 +365,20 @@ void StoreEncryptionKey(void) {
 	}
 }
 
-uint8_t GetHeader(void){
+uint8_t GetHeader(const uint8_t* pPacket){
 	uint8_t localindex = EncryptionKey_Index;
 	uint8_t local_decrypted = 0; 
-	local_decrypted = EncryptionKey[localindex] ^ (*(DataPacket_Rx + PACKET_TYPE_BYTE_INDEX_RX));
+	local_decrypted = EncryptionKey[localindex] ^ (*(pPacket + PACKET_TYPE_BYTE_INDEX_RX));
 	return local_decrypted;
 }
 	
 
-void DecodeCommandMessage(void) {
+/* decrypts a command packet in place, stepping through the key. Called by
+   Comm_Service as each packet arrives, so that the key stays in step with
+   the FARMER even if DOG_SM only gets to see the latest command */
+void DecryptCommand(uint8_t* pPacket) {
 	for (int i = 0; i < FARMER_CMD_LENGTH; i++) {
-		DecryptedFarmerCommands[i] = EncryptionKey[EncryptionKey_Index] ^ (*(DataPacket_Rx + PACKET_TYPE_BYTE_INDEX_RX + i));
+		*(pPacket + PACKET_TYPE_BYTE_INDEX_RX + i) ^= EncryptionKey[EncryptionKey_Index];
 		if (EncryptionKey_Index < 31) {
 				EncryptionKey_Index++;
 		} else {
@@ -380,5 +453,8 @@ uint8_t GetDogTag(void){
 }
 
 DOGState_t GetDOGState(void) {
-	return CurrentState;
+	if (DOGMachine.pCurrent == NULL) {
+		return Waiting2Pair;
+	}
+	return (DOGState_t)DOGMachine.pCurrent->Id;
 }
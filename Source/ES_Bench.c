@@ -0,0 +1,1245 @@
+/****************************************************************************
+ Module
+   ES_Bench.c
+
+ Revision
+   1.0.0
+
+ Description
+   Microbenchmarks for the dispatch path of the Events & Services
+   Framework: ES_PostToService from task and interrupt context,
+   ES_EnQueueFIFO/ES_DeQueue and their SPSC equivalents, ES_Run dispatch for 1 to 32 active services
+   at several queue depths, the latency from an interrupt posting an
+   event to the run function seeing it (with the framework idle, and with
+   a service of lower priority busy), restarting a timer and the
+   timer tick with 1 to 64 timers running, a state machine shaped like
+   DOG_SM written as nested switches and as tables for ES_HSM.c, the
+   throughput of the XBee frame parser in both API modes, and a pass of
+   the idle loop's ES_CheckUserEvents, checking that the rate limited
+   checker is only called when it is due, the armed ones only after the
+   Timer5A interrupt has armed them, and that an armed checker keeps the
+   tickless idle awake, or limits its sleep to the rest of its period.
+
+ Notes
+   This is a stand-alone program with its own main(). Build it with
+   ES_BENCH defined (which selects ES_BenchConfigure.h) in place of main.c
+   and the DOG services, i.e. with ES_Framework.c, ES_Queue.c,
+   ES_LookupTables.c, ES_Timers.c, ES_Port.c, ES_CheckEvents.c,
+   ES_Buffer.c, ES_Pool.c, ES_HSM.c and XBeeParser.c.
+   On the host:
+     gcc -std=gnu99 -O2 -Dhost -DES_BENCH -IHost -IHeaders -o es_bench
+         Host/HostSim.c Host/HostDriverlib.c Host/HostTermio.c
+         Source/ES_Bench.c Source/ES_Framework.c Source/ES_Queue.c
+         Source/ES_LookupTables.c Source/ES_Timers.c Source/ES_Port.c
+         Source/ES_CheckEvents.c Source/ES_Buffer.c Source/ES_Pool.c
+         Source/ES_HSM.c Source/XBeeParser.c
+   On the target, swap main.c for this file in a copy of the Keil project
+   and add ES_BENCH to the preprocessor defines. The interrupt benchmarks
+   use Timer5A, so the ShortTimerAHandler here replaces the one in
+   ES_ShortTimer.c (leave that file out).
+
+   Add -DBENCH_PREEMPTIVE to build the same benchmarks with ES_PREEMPTIVE,
+   for comparison with the cooperative ES_Run.
+
+   Times are in ns on the host and in CPU cycles (DWT_CYCCNT, 25ns each
+   at 40MHz) on the target. Every result is the mean over BENCH_REPS
+   repetitions, and includes the 1ms SysTick that the framework runs.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26               added the event checker benchmark
+ 10/17/26               added the XBee frame parser benchmark
+ 10/17/26               added the switch and ES_HSM state machine benchmarks
+ 10/17/26               dispatch with up to 32 services
+ 10/17/26               added the latency with a lower priority service busy,
+                        and BENCH_PREEMPTIVE
+ 10/17/26               added the memory pool benchmarks
+ 10/17/26               added the timer benchmarks
+ 10/17/26               added the SPSC queue primitives
+ 10/17/26               first pass
+****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_timer.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/interrupt.h"
+
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Port.h"
+#include "ES_Queue.h"
+#include "ES_Timers.h"
+#include "ES_CheckEvents.h"
+#include "ES_HSM.h"
+#include "ES_Bench.h"
+#include "XBeeParser.h"
+#include "termio.h"
+
+#if defined(host)
+#include "HostSim.h"
+#endif
+
+/*----------------------------- Module Defines ----------------------------*/
+#ifndef BENCH_REPS
+#define BENCH_REPS 1000
+#endif
+
+// the interrupt driven benchmarks need one timer interrupt per repetition
+#define ISR_REPS (BENCH_REPS / 10)
+
+// Timer5A reload (in 25ns ticks) used to raise the benchmark interrupt
+#define BENCH_TIMER_TICKS 400
+
+// how long the low priority service keeps the CPU when timing the latency
+// with it busy, in CPU cycles. Long enough to take in the Timer5A interrupt
+#define BENCH_BUSY_CYCLES 4000
+
+// EventParam of the event that makes a service busy, the ISR posts 0
+#define BENCH_BUSY 1
+
+// timer lengths, in ticks, long enough that none time out during a benchmark
+#define BENCH_TIMER_SHORT 100000UL
+#define BENCH_TIMER_LONG  200000UL
+
+#if defined(host)
+#define BENCH_UNITS "ns"
+#define BENCH_UNITS_PER_S 1000000000ULL
+#else
+#define BENCH_UNITS "cycles"
+#define BENCH_UNITS_PER_S ((uint64_t)SysCtlClockGet())
+#endif
+
+// how many ticks the event checker benchmark watches the periodic checker
+// for, BENCH_CHECK_PERIOD (ES_BenchConfigure.h) being its period
+#define BENCH_CHECK_TICKS (20 * BENCH_CHECK_PERIOD)
+
+// room for the frames that the parser benchmark runs through, escaped
+#define BENCH_STREAM_SIZE 256
+
+typedef enum { CountingDispatches, MeasuringLatency, MeasuringBusyLatency,
+               ArmingChecker }
+  BenchMode_t;
+
+// the states of the benchmark state machines, as in DOG_SM
+typedef enum { BenchUnpaired, BenchWaiting4Key, BenchPaired, BenchConnected }
+  BenchState_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+void ShortTimerAHandler(void);
+
+static uint32_t Now(void);
+static void InitBenchTimer(void);
+static void ArmBenchTimer(void);
+static uint32_t RunUntil(uint32_t NumDispatches);
+static void FillQueues(uint8_t NumServices, uint8_t Depth);
+static void BenchTaskPost(uint8_t Depth);
+static void BenchQueueOps(uint8_t Depth);
+static void BenchDispatch(uint8_t NumServices, uint8_t Depth);
+static void BenchISRPost(uint8_t Depth);
+static void BenchLatency(void);
+static void BenchBusyLatency(void);
+static void StartLatency(void);
+static bool NoteLatency(void);
+static void PostBusy(void);
+static void BenchTimers(uint8_t NumTimers);
+static void BenchPool(uint8_t InUse);
+static void BenchStateMachines(void);
+static void RunSwitchMachine(ES_Event ThisEvent);
+static bool IsBenchLostComm(ES_Event ThisEvent);
+static void BenchAction(ES_Event ThisEvent);
+static void BenchEntryExit(void);
+static void BenchXBeeParser(uint8_t APIMode);
+static void BenchEventCheckers(void);
+static uint32_t CheckPass(void);
+static void NoteCheckGap(uint32_t Calls, uint16_t *pLastTick,
+                         uint16_t *pMinGap);
+static void PrintCheckResult(const char *Name, uint64_t Total,
+                             uint32_t Count);
+static uint16_t BuildParserStream(uint8_t APIMode, uint32_t *pNumFrames);
+static void PrintResult(const char *Name, uint8_t Services, uint8_t Depth,
+                        uint64_t Total, uint32_t Count);
+static void PrintPoolResult(const char *Name, uint8_t InUse,
+                            uint64_t Total, uint32_t Count);
+static void PrintTimerResult(const char *Name, uint8_t NumTimers,
+                             uint64_t Total, uint32_t Count);
+static void PrintMachineResult(const char *Name, uint64_t Total,
+                               uint32_t Count);
+static void PrintParserResult(const char *Name, uint64_t Total,
+                              uint32_t Count);
+static void PrintLatency(const char *Name);
+
+/*---------------------------- Module Variables ---------------------------*/
+static BenchMode_t Mode = CountingDispatches;
+static uint32_t Dispatched;
+static uint32_t DispatchTarget;
+
+// ISR side of the interrupt benchmarks
+static volatile uint8_t ISRPostDepth;
+static volatile uint32_t ISRPostTime;
+static volatile bool ISRDone;
+static volatile uint32_t LatencyStart;
+
+static uint32_t LatencySamples;
+static uint64_t LatencyTotal;
+static uint32_t LatencyMin;
+static uint32_t LatencyMax;
+
+// a private queue for timing the queue primitives on their own
+static ES_Event BenchQueue[BENCH_QUEUE_SIZE + 1];
+
+static const uint8_t Depths[] = { 1, 4, 16 };
+static const uint8_t ServiceCounts[] = { 1, 2, 4, 8, 16, 32 };
+static const uint8_t TimerCounts[] = { 1, 8, 64 };
+static const uint8_t PoolInUse[] = { 0, ES_POOL0_NUM_BLOCKS - 1 };
+
+// timeouts seen by PostBenchTimer, none are expected
+static uint32_t TimeOuts;
+
+// calls of each event checker, and the times the ISR armed one
+static uint32_t EveryPassChecks;
+static uint32_t PeriodicChecks;
+static uint16_t LastPeriodicTick;
+static uint16_t MinPeriodicGap;   // fewest ticks between periodic calls
+static uint32_t ArmedPeriodicChecks;
+static uint16_t LastArmedPeriodicTick;
+static uint16_t MinArmedPeriodicGap;
+static uint32_t ArmedChecks;
+static volatile uint32_t ArmedByISR;
+
+// the events fed to the state machines over and over: pairing, the key,
+// four commands, an event that no state wants and losing the link
+static const ES_Event MachineScript[] = {
+  { ES_BENCH_PAIR, 0 }, { ES_BENCH_KEY, 0 }, { ES_BENCH_CMD, 0 },
+  { ES_BENCH_CMD, 0 }, { ES_BENCH_CMD, 0 }, { ES_BENCH_CMD, 0 },
+  { ES_BENCH_EVENT, 0 }, { ES_TIMEOUT, 0 }
+};
+
+// the state of the switch machine, and what the actions of both count
+static BenchState_t SwitchState;
+static volatile uint32_t MachineWork;
+
+// the same machine as tables for ES_HSM.c
+static const ES_HSMState_t BenchUnpairedState;
+static const ES_HSMState_t BenchConnectedState;
+static const ES_HSMState_t BenchWaiting4KeyState;
+static const ES_HSMState_t BenchPairedState;
+
+static const ES_HSMTransition_t BenchUnpairedTransitions[] = {
+  { ES_BENCH_PAIR, NULL, BenchAction, &BenchConnectedState }
+};
+static const ES_HSMTransition_t BenchConnectedTransitions[] = {
+  { ES_BENCH_UNPAIR, NULL, BenchAction, &BenchUnpairedState },
+  { ES_TIMEOUT, IsBenchLostComm, BenchAction, &BenchUnpairedState }
+};
+static const ES_HSMTransition_t BenchWaiting4KeyTransitions[] = {
+  { ES_BENCH_KEY, NULL, BenchAction, &BenchPairedState }
+};
+static const ES_HSMTransition_t BenchPairedTransitions[] = {
+  { ES_BENCH_CMD, NULL, BenchAction, NULL }
+};
+
+static const ES_HSMState_t BenchUnpairedState = {
+  NULL, NULL, BenchEntryExit, NULL, BenchUnpairedTransitions,
+  ARRAY_SIZE(BenchUnpairedTransitions), BenchUnpaired
+};
+static const ES_HSMState_t BenchConnectedState = {
+  NULL, &BenchWaiting4KeyState, BenchEntryExit, BenchEntryExit,
+  BenchConnectedTransitions, ARRAY_SIZE(BenchConnectedTransitions),
+  BenchConnected
+};
+static const ES_HSMState_t BenchWaiting4KeyState = {
+  &BenchConnectedState, NULL, NULL, NULL, BenchWaiting4KeyTransitions,
+  ARRAY_SIZE(BenchWaiting4KeyTransitions), BenchWaiting4Key
+};
+static const ES_HSMState_t BenchPairedState = {
+  &BenchConnectedState, NULL, BenchEntryExit, NULL, BenchPairedTransitions,
+  ARRAY_SIZE(BenchPairedTransitions), BenchPaired
+};
+
+static ES_HSM_t BenchMachine;
+
+// the frame data that the parser benchmark takes apart: a farmer's command
+// from an address that has to be escaped in API mode 2, a transmit status
+// and a pair request
+static const uint8_t ParserCommand[] = {
+  0x81, 0x7D, 0x13, 0x28, 0x00, 0x04, 0x11, 0x7E, 0x05
+};
+static const uint8_t ParserTxStatus[] = { 0x89, 0x01, 0x00 };
+static const uint8_t ParserPairRequest[] = {
+  0x81, 0x20, 0x8B, 0x28, 0x00, 0x01, 0x27
+};
+static const uint8_t * const ParserFrames[] = {
+  ParserCommand, ParserTxStatus, ParserPairRequest
+};
+static const uint8_t ParserFrameLengths[] = {
+  sizeof(ParserCommand), sizeof(ParserTxStatus), sizeof(ParserPairRequest)
+};
+
+static uint8_t ParserStream[BENCH_STREAM_SIZE];
+static uint8_t ParserBuffer[16];
+
+/*------------------------------ Module Code ------------------------------*/
+int main(void)
+{
+  uint8_t i;
+  uint8_t j;
+
+  // Set the clock to run at 40MhZ using the PLL and 16MHz external crystal
+  SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
+                 | SYSCTL_XTAL_16MHZ);
+  TERMIO_Init();
+  _HW_CycleCounter_Init();
+
+  printf("\r\nES dispatch benchmarks, %u services, queue size %u, "
+         "%u reps, times in " BENCH_UNITS "\r\n",
+         (unsigned)NUM_SERVICES, (unsigned)BENCH_QUEUE_SIZE,
+         (unsigned)BENCH_REPS);
+#ifdef ES_PREEMPTIVE
+  printf("preemptive scheduling (ES_PREEMPTIVE)\r\n");
+#else
+  printf("cooperative scheduling\r\n");
+#endif
+
+  if (ES_Initialize(ES_Timer_RATE_1mS) != Success)
+  {
+    printf("Failed Initialization\r\n");
+    for (;;)
+      ;
+  }
+  InitBenchTimer();
+
+  for (i = 0; i < sizeof(Depths); i++)
+  {
+    BenchTaskPost(Depths[i]);
+  }
+  for (i = 0; i < sizeof(Depths); i++)
+  {
+    BenchQueueOps(Depths[i]);
+  }
+  for (i = 0; i < sizeof(ServiceCounts); i++)
+  {
+    if (ServiceCounts[i] > NUM_SERVICES)
+    {
+      break;
+    }
+    for (j = 0; j < sizeof(Depths); j++)
+    {
+      BenchDispatch(ServiceCounts[i], Depths[j]);
+    }
+  }
+  for (i = 0; i < sizeof(Depths); i++)
+  {
+    BenchISRPost(Depths[i]);
+  }
+  BenchLatency();
+  BenchBusyLatency();
+  for (i = 0; i < sizeof(TimerCounts); i++)
+  {
+    BenchTimers(TimerCounts[i]);
+  }
+  for (i = 0; i < sizeof(PoolInUse); i++)
+  {
+    BenchPool(PoolInUse[i]);
+  }
+  BenchStateMachines();
+  BenchXBeeParser(XBEE_API_UNESCAPED);
+  BenchXBeeParser(XBEE_API_ESCAPED);
+  BenchEventCheckers();
+  if (TimeOuts != 0)
+  {
+    printf("%lu unexpected timeouts\r\n", (unsigned long)TimeOuts);
+  }
+
+  printf("done\r\n");
+#if defined(host)
+  return 0;
+#else
+  for (;;)
+    ;
+#endif
+}
+
+/****************************************************************************
+ Function
+     InitBenchService
+ Parameters
+     uint8_t : the priority of this service
+ Returns
+     bool, always true
+ Description
+     Every service in the benchmark build is this one. There is nothing to
+     set up and no ES_INIT is posted, so the queues start out empty.
+****************************************************************************/
+bool InitBenchService ( uint8_t Priority )
+{
+  (void)Priority;
+  return true;
+}
+
+/****************************************************************************
+ Function
+     RunBenchService
+ Parameters
+     ES_Event : the event to process
+ Returns
+     ES_Event, ES_ERROR once the current benchmark is finished, which makes
+     ES_Run return to the benchmark that called it
+ Description
+     Counts dispatches, or when timing interrupt latency records the time
+     since the ISR posted and re-arms the timer for the next sample. When
+     timing the latency with a service busy, the busy event arms the timer
+     and then keeps the CPU for BENCH_BUSY_CYCLES, and the ISR's event
+     records the latency and posts the next busy event.
+****************************************************************************/
+ES_Event RunBenchService( ES_Event ThisEvent )
+{
+  ES_Event ReturnEvent;
+  uint32_t Start;
+
+  ReturnEvent.EventType = ES_NO_EVENT;
+
+  if (Mode == MeasuringLatency)
+  {
+    if (NoteLatency())
+    {
+      ArmBenchTimer();
+    }
+    else
+    {
+      ReturnEvent.EventType = ES_ERROR;
+    }
+  }
+  else if (Mode == MeasuringBusyLatency)
+  {
+    if (ThisEvent.EventParam == BENCH_BUSY)
+    {
+      ArmBenchTimer();
+      // reading the cycle counter lets the host simulation take the
+      // interrupt, the same as any register access
+      Start = _HW_GetCycleCount();
+      while ((_HW_GetCycleCount() - Start) < BENCH_BUSY_CYCLES)
+      {
+      }
+    }
+    else if (NoteLatency())
+    {
+      PostBusy();
+    }
+    else
+    {
+      ReturnEvent.EventType = ES_ERROR;
+    }
+  }
+  else if (++Dispatched >= DispatchTarget)
+  {
+    ReturnEvent.EventType = ES_ERROR;
+  }
+  return ReturnEvent;
+}
+
+bool PostBenchTimer( ES_Event ThisEvent )
+{
+  (void)ThisEvent;
+  TimeOuts++;
+  return true;
+}
+
+bool Check4BenchEvents(void)
+{
+  EveryPassChecks++;
+  return false;
+}
+
+bool Check4BenchPeriodic(void)
+{
+  NoteCheckGap(PeriodicChecks++, &LastPeriodicTick, &MinPeriodicGap);
+  return false;
+}
+
+bool Check4BenchArmed(void)
+{
+  ArmedChecks++;
+  return false;
+}
+
+bool Check4BenchArmedPeriodic(void)
+{
+  NoteCheckGap(ArmedPeriodicChecks++, &LastArmedPeriodicTick,
+               &MinArmedPeriodicGap);
+  return false;
+}
+
+/****************************************************************************
+ Function
+     ShortTimerAHandler
+ Description
+     Timer5A timeout. Posts ISRPostDepth events to service 0, timing the
+     posts, or when timing latency stamps the time and posts one, to the
+     highest priority service if a lower one is meant to be busy. For the
+     event checker benchmark it arms Check4BenchArmed and
+     Check4BenchArmedPeriodic instead.
+****************************************************************************/
+void ShortTimerAHandler(void)
+{
+  ES_Event ThisEvent;
+  uint32_t Start;
+  uint8_t i;
+
+  TimerIntClear(TIMER5_BASE, TIMER_TIMA_TIMEOUT);
+
+  ThisEvent.EventType = ES_BENCH_EVENT;
+  ThisEvent.EventParam = 0;
+  if (Mode == MeasuringLatency)
+  {
+    LatencyStart = Now();
+    ES_PostToService(0, ThisEvent);
+  }
+  else if (Mode == MeasuringBusyLatency)
+  {
+    LatencyStart = Now();
+    ES_PostToService(NUM_SERVICES - 1, ThisEvent);
+  }
+  else if (Mode == ArmingChecker)
+  {
+    ES_ArmEventChecker(CHECK_Check4BenchArmed);
+    ES_ArmEventChecker(CHECK_Check4BenchArmedPeriodic);
+    ArmedByISR++;
+    ISRDone = true;
+  }
+  else
+  {
+    Start = Now();
+    for (i = 0; i < ISRPostDepth; i++)
+    {
+      ES_PostToService(0, ThisEvent);
+    }
+    ISRPostTime = Now() - Start;
+    ISRDone = true;
+  }
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+static uint32_t Now(void)
+{
+#if defined(host)
+  return (uint32_t)HostSim_Now();
+#else
+  return _HW_GetCycleCount();
+#endif
+}
+
+static void InitBenchTimer(void)
+{
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER5);
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER5))
+  {
+  }
+  TimerConfigure(TIMER5_BASE, TIMER_CFG_SPLIT_PAIR | TIMER_CFG_A_ONE_SHOT);
+  TimerPrescaleSet(TIMER5_BASE, TIMER_A, 0);
+  TimerIntEnable(TIMER5_BASE, TIMER_TIMA_TIMEOUT);
+  IntEnable(INT_TIMER5A_TM4C123);
+}
+
+static void ArmBenchTimer(void)
+{
+  TimerLoadSet(TIMER5_BASE, TIMER_A, BENCH_TIMER_TICKS);
+  TimerEnable(TIMER5_BASE, TIMER_A);
+}
+
+// runs the framework until the services have handled NumDispatches events,
+// returning how long that took
+static uint32_t RunUntil(uint32_t NumDispatches)
+{
+  uint32_t Start;
+
+  if (NumDispatches == 0)
+  {
+    return 0;
+  }
+  Mode = CountingDispatches;
+  Dispatched = 0;
+  DispatchTarget = NumDispatches;
+  Start = Now();
+  ES_Run();
+  return Now() - Start;
+}
+
+static void FillQueues(uint8_t NumServices, uint8_t Depth)
+{
+  ES_Event ThisEvent;
+  uint8_t Service;
+  uint8_t i;
+
+  ThisEvent.EventType = ES_BENCH_EVENT;
+  ThisEvent.EventParam = 0;
+  for (Service = 0; Service < NumServices; Service++)
+  {
+    for (i = 0; i < Depth; i++)
+    {
+      ES_PostToService(Service, ThisEvent);
+    }
+  }
+}
+
+// ES_PostToService from task level, into a queue Depth events deep
+static void BenchTaskPost(uint8_t Depth)
+{
+  ES_Event ThisEvent;
+  uint64_t Total = 0;
+  uint32_t Start;
+  uint32_t Rep;
+  uint8_t i;
+
+  ThisEvent.EventType = ES_BENCH_EVENT;
+  ThisEvent.EventParam = 0;
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    Start = Now();
+    for (i = 0; i < Depth; i++)
+    {
+      ES_PostToService(0, ThisEvent);
+    }
+    Total += Now() - Start;
+    RunUntil(Depth);
+  }
+  PrintResult("ES_PostToService (task)", 1, Depth, Total,
+              (uint32_t)BENCH_REPS * Depth);
+}
+
+// the queue primitives on their own, without the Ready bookkeeping
+static void BenchQueueOps(uint8_t Depth)
+{
+  ES_Event ThisEvent;
+  uint64_t EnQueueTotal = 0;
+  uint64_t DeQueueTotal = 0;
+  uint32_t Start;
+  uint32_t Rep;
+  uint8_t i;
+
+  ES_InitQueue(BenchQueue, BENCH_QUEUE_SIZE + 1);
+  ThisEvent.EventType = ES_BENCH_EVENT;
+  ThisEvent.EventParam = 0;
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    Start = Now();
+    for (i = 0; i < Depth; i++)
+    {
+      ES_EnQueueFIFO(BenchQueue, ThisEvent);
+    }
+    EnQueueTotal += Now() - Start;
+    Start = Now();
+    for (i = 0; i < Depth; i++)
+    {
+      ES_DeQueue(BenchQueue, &ThisEvent);
+    }
+    DeQueueTotal += Now() - Start;
+  }
+  PrintResult("ES_EnQueueFIFO", 1, Depth, EnQueueTotal,
+              (uint32_t)BENCH_REPS * Depth);
+  PrintResult("ES_DeQueue", 1, Depth, DeQueueTotal,
+              (uint32_t)BENCH_REPS * Depth);
+
+  // and the same for the lock-free SPSC queue, if BENCH_QUEUE_SIZE allows
+  if (ES_InitSPSCQueue(BenchQueue, BENCH_QUEUE_SIZE + 1) == 0)
+  {
+    return;
+  }
+  EnQueueTotal = 0;
+  DeQueueTotal = 0;
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    Start = Now();
+    for (i = 0; i < Depth; i++)
+    {
+      ES_EnQueueSPSC(BenchQueue, ThisEvent);
+    }
+    EnQueueTotal += Now() - Start;
+    Start = Now();
+    for (i = 0; i < Depth; i++)
+    {
+      ES_DeQueueSPSC(BenchQueue, &ThisEvent);
+    }
+    DeQueueTotal += Now() - Start;
+  }
+  PrintResult("ES_EnQueueSPSC", 1, Depth, EnQueueTotal,
+              (uint32_t)BENCH_REPS * Depth);
+  PrintResult("ES_DeQueueSPSC", 1, Depth, DeQueueTotal,
+              (uint32_t)BENCH_REPS * Depth);
+}
+
+// ES_Run, from Depth events waiting in each of NumServices queues until
+// they have all been handled. Reported per dispatch
+static void BenchDispatch(uint8_t NumServices, uint8_t Depth)
+{
+  uint64_t Total = 0;
+  uint32_t Rep;
+
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    FillQueues(NumServices, Depth);
+    Total += RunUntil((uint32_t)NumServices * Depth);
+  }
+  PrintResult("ES_Run dispatch", NumServices, Depth, Total,
+              (uint32_t)BENCH_REPS * NumServices * Depth);
+}
+
+// ES_PostToService from the Timer5A interrupt
+static void BenchISRPost(uint8_t Depth)
+{
+  uint64_t Total = 0;
+  uint32_t Rep;
+
+  Mode = CountingDispatches;
+  ISRPostDepth = Depth;
+  for (Rep = 0; Rep < ISR_REPS; Rep++)
+  {
+    ISRDone = false;
+    ArmBenchTimer();
+    while (!ISRDone)
+    {
+      _HW_Process_Pending_Ints();
+    }
+    Total += ISRPostTime;
+    RunUntil(Depth);
+  }
+  PrintResult("ES_PostToService (ISR)", 1, Depth, Total,
+              (uint32_t)ISR_REPS * Depth);
+}
+
+// from the ISR posting to RunBenchService seeing the event
+static void BenchLatency(void)
+{
+  StartLatency();
+  Mode = MeasuringLatency;
+  ArmBenchTimer();
+  ES_Run();
+  Mode = CountingDispatches;
+  PrintLatency("ISR to RunFunc latency");
+}
+
+// the same, but posting to the highest priority service while service 0
+// is in the middle of a long run function. Cooperative scheduling has to
+// wait for that to return, ES_PREEMPTIVE should not
+static void BenchBusyLatency(void)
+{
+  if (NUM_SERVICES < 2)
+  {
+    return;
+  }
+  StartLatency();
+  Mode = MeasuringBusyLatency;
+  PostBusy();
+  ES_Run();
+  Mode = CountingDispatches;
+  PrintLatency("ISR to RunFunc, svc 0 busy");
+}
+
+static void StartLatency(void)
+{
+  LatencySamples = 0;
+  LatencyTotal = 0;
+  LatencyMin = UINT32_MAX;
+  LatencyMax = 0;
+}
+
+// records the time since the ISR posted, returning true if more samples
+// are wanted
+static bool NoteLatency(void)
+{
+  uint32_t Latency = Now() - LatencyStart;
+
+  LatencyTotal += Latency;
+  if (Latency < LatencyMin)
+  {
+    LatencyMin = Latency;
+  }
+  if (Latency > LatencyMax)
+  {
+    LatencyMax = Latency;
+  }
+  return (++LatencySamples < ISR_REPS);
+}
+
+// gives service 0 a busy event
+static void PostBusy(void)
+{
+  ES_Event ThisEvent;
+
+  ThisEvent.EventType = ES_BENCH_EVENT;
+  ThisEvent.EventParam = BENCH_BUSY;
+  ES_PostToService(0, ThisEvent);
+}
+
+// ES_Timer_InitTimer restarting timer 0 with NumTimers - 1 others running,
+// both when it becomes the last timer to expire (the way RECEIVE_TIMER is
+// restarted on every byte) and the first, and then ES_Timer_Tick_Resp
+// on a tick when no timer expires
+static void BenchTimers(uint8_t NumTimers)
+{
+  uint64_t LastTotal = 0;
+  uint64_t FirstTotal = 0;
+  uint64_t TickTotal = 0;
+  uint32_t Start;
+  uint32_t Rep;
+  uint8_t i;
+
+  for (i = 1; i < NumTimers; i++)
+  {
+    ES_Timer_InitTimer(i, BENCH_TIMER_SHORT + i);
+  }
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    Start = Now();
+    ES_Timer_InitTimer(0, BENCH_TIMER_LONG);
+    LastTotal += Now() - Start;
+    Start = Now();
+    ES_Timer_InitTimer(0, BENCH_TIMER_SHORT / 2);
+    FirstTotal += Now() - Start;
+    Start = Now();
+    ES_Timer_Tick_Resp();
+    TickTotal += Now() - Start;
+  }
+  for (i = 0; i < NumTimers; i++)
+  {
+    ES_Timer_StopTimer(i);
+  }
+  PrintTimerResult("ES_Timer_InitTimer (last)", NumTimers, LastTotal,
+                   BENCH_REPS);
+  PrintTimerResult("ES_Timer_InitTimer (first)", NumTimers, FirstTotal,
+                   BENCH_REPS);
+  PrintTimerResult("ES_Timer_Tick_Resp", NumTimers, TickTotal, BENCH_REPS);
+}
+
+// ES_PoolAlloc and ES_PoolFree of one block from pool 0 with InUse of its
+// other blocks already allocated, which should make no difference
+static void BenchPool(uint8_t InUse)
+{
+  void *Held[ES_POOL0_NUM_BLOCKS];
+  void *pBlock;
+  uint64_t AllocTotal = 0;
+  uint64_t FreeTotal = 0;
+  uint32_t Start;
+  uint32_t Rep;
+  uint8_t i;
+
+  for (i = 0; i < InUse; i++)
+  {
+    Held[i] = ES_PoolAlloc(ES_POOL0_BLOCK_SIZE);
+  }
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    Start = Now();
+    pBlock = ES_PoolAlloc(ES_POOL0_BLOCK_SIZE);
+    AllocTotal += Now() - Start;
+    Start = Now();
+    ES_PoolFree(pBlock);
+    FreeTotal += Now() - Start;
+  }
+  for (i = 0; i < InUse; i++)
+  {
+    ES_PoolFree(Held[i]);
+  }
+  PrintPoolResult("ES_PoolAlloc", InUse, AllocTotal, BENCH_REPS);
+  PrintPoolResult("ES_PoolFree", InUse, FreeTotal, BENCH_REPS);
+}
+
+// the events of MachineScript dispatched to the nested switch machine and
+// to the same machine run by ES_HSMDispatch, timed over the whole script so
+// that reading the clock is not counted for each event
+static void BenchStateMachines(void)
+{
+  uint64_t SwitchTotal = 0;
+  uint64_t HSMTotal = 0;
+  uint32_t Start;
+  uint32_t Rep;
+  uint8_t i;
+
+  SwitchState = BenchUnpaired;
+  ES_HSMStart(&BenchMachine, &BenchUnpairedState);
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    Start = Now();
+    for (i = 0; i < ARRAY_SIZE(MachineScript); i++)
+    {
+      RunSwitchMachine(MachineScript[i]);
+    }
+    SwitchTotal += Now() - Start;
+    Start = Now();
+    for (i = 0; i < ARRAY_SIZE(MachineScript); i++)
+    {
+      ES_HSMDispatch(&BenchMachine, MachineScript[i]);
+    }
+    HSMTotal += Now() - Start;
+  }
+  PrintMachineResult("state machine, switch", SwitchTotal,
+                     (uint32_t)BENCH_REPS * ARRAY_SIZE(MachineScript));
+  PrintMachineResult("state machine, ES_HSM", HSMTotal,
+                     (uint32_t)BENCH_REPS * ARRAY_SIZE(MachineScript));
+}
+
+// the machine as DOG_SM had it, with the entry and exit actions written
+// into each case that changes state
+static void RunSwitchMachine(ES_Event ThisEvent)
+{
+  switch (SwitchState)
+  {
+    case BenchUnpaired:
+      if (ThisEvent.EventType == ES_BENCH_PAIR)
+      {
+        BenchAction(ThisEvent);
+        BenchEntryExit();
+        SwitchState = BenchWaiting4Key;
+      }
+      break;
+
+    case BenchWaiting4Key:
+      if (ThisEvent.EventType == ES_BENCH_KEY)
+      {
+        BenchAction(ThisEvent);
+        BenchEntryExit();
+        SwitchState = BenchPaired;
+      }
+      else if ((ThisEvent.EventType == ES_BENCH_UNPAIR) ||
+               IsBenchLostComm(ThisEvent))
+      {
+        BenchEntryExit();
+        BenchAction(ThisEvent);
+        BenchEntryExit();
+        SwitchState = BenchUnpaired;
+      }
+      break;
+
+    case BenchPaired:
+      if (ThisEvent.EventType == ES_BENCH_CMD)
+      {
+        BenchAction(ThisEvent);
+      }
+      else if ((ThisEvent.EventType == ES_BENCH_UNPAIR) ||
+               IsBenchLostComm(ThisEvent))
+      {
+        BenchEntryExit();
+        BenchAction(ThisEvent);
+        BenchEntryExit();
+        SwitchState = BenchUnpaired;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+static bool IsBenchLostComm(ES_Event ThisEvent)
+{
+  return (ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam == 0);
+}
+
+static void BenchAction(ES_Event ThisEvent)
+{
+  MachineWork += ThisEvent.EventType;
+}
+
+static void BenchEntryExit(void)
+{
+  MachineWork++;
+}
+
+// XBeeParser_Byte over a stream of frames, timed over the whole stream and
+// reported per byte and as the bytes per second that it could keep up with
+static void BenchXBeeParser(uint8_t APIMode)
+{
+  XBeeParser_t Parser;
+  uint64_t Total = 0;
+  uint32_t NumFrames;
+  uint32_t Frames = 0;
+  uint32_t Start;
+  uint32_t Rep;
+  uint16_t Length;
+  uint16_t i;
+
+  Length = BuildParserStream(APIMode, &NumFrames);
+  XBeeParser_Init(&Parser, APIMode, ParserBuffer, sizeof(ParserBuffer));
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    Start = Now();
+    for (i = 0; i < Length; i++)
+    {
+      if (XBeeParser_Byte(&Parser, ParserStream[i]) == XBEE_PARSE_FRAME)
+      {
+        Frames++;
+      }
+    }
+    Total += Now() - Start;
+  }
+  PrintParserResult((APIMode == XBEE_API_ESCAPED) ?
+                    "XBeeParser_Byte, API mode 2" :
+                    "XBeeParser_Byte, API mode 1",
+                    Total, (uint32_t)BENCH_REPS * Length);
+  if (Frames != NumFrames * BENCH_REPS)
+  {
+    printf("XBeeParser found %lu of %lu frames\r\n", (unsigned long)Frames,
+           (unsigned long)(NumFrames * BENCH_REPS));
+  }
+}
+
+// ES_CheckUserEvents as the idle loop calls it, timed with nothing armed,
+// and then for BENCH_CHECK_TICKS ticks while the Timer5A interrupt arms
+// Check4BenchArmed and Check4BenchArmedPeriodic ISR_REPS times. The rate
+// limited checkers should never be called less than their period after
+// the last time (on the host they may be called late, if the process was
+// not running when they were due), and Check4BenchArmed once for each time
+// it was armed. Until the armed checker has been called ES_CheckersPending
+// should keep the tickless idle awake. Last of all Check4BenchArmedPeriodic
+// is armed just after being called, when it should limit the sleep to the
+// rest of its period instead
+static void BenchEventCheckers(void)
+{
+  uint64_t Total = 0;
+  uint32_t Passes = 0;
+  uint32_t Calls;
+  uint32_t Ticks;
+  uint32_t SleepTicks;
+  uint16_t StartTick;
+  uint32_t Start;
+  uint32_t Rep;
+  bool Wrong = false;
+
+  Mode = ArmingChecker;
+  ArmedChecks = 0;
+  ArmedPeriodicChecks = 0;
+  ArmedByISR = 0;
+  for (Rep = 0; Rep < BENCH_REPS; Rep++)
+  {
+    Start = Now();
+    ES_CheckUserEvents();
+    Total += Now() - Start;
+  }
+  PrintCheckResult("ES_CheckUserEvents", Total, BENCH_REPS);
+  if ((ArmedChecks != 0) || (ArmedPeriodicChecks != 0) ||
+      ES_CheckersPending())
+  {
+    printf("armed checkers called or pending before they were armed\r\n");
+  }
+
+  // the periodic checker is counted from a tick on which it was called
+  Calls = PeriodicChecks;
+  while (PeriodicChecks == Calls)
+  {
+    CheckPass();
+  }
+  StartTick = ES_Timer_GetTime();
+  EveryPassChecks = 0;
+  PeriodicChecks = 0;
+  MinPeriodicGap = UINT16_MAX;
+  MinArmedPeriodicGap = UINT16_MAX;
+  for (Rep = 0; Rep < ISR_REPS; Rep++)
+  {
+    ISRDone = false;
+    ArmBenchTimer();
+    while (!ISRDone)
+    {
+      _HW_Process_Pending_Ints();
+    }
+    // the idle loop must not sleep now, or it would sleep through it
+    if (!ES_CheckersPending())
+    {
+      Wrong = true;
+    }
+    Passes += CheckPass();
+  }
+  while ((uint16_t)(ES_Timer_GetTime() - StartTick) < BENCH_CHECK_TICKS)
+  {
+    Passes += CheckPass();
+  }
+  Ticks = (uint16_t)(ES_Timer_GetTime() - StartTick);
+
+  // arm Check4BenchArmedPeriodic just after a call, so that it is armed
+  // but not yet due
+  ES_ArmEventChecker(CHECK_Check4BenchArmedPeriodic);
+  Calls = ArmedPeriodicChecks;
+  while (ArmedPeriodicChecks == Calls)
+  {
+    Passes += CheckPass();
+  }
+  ES_ArmEventChecker(CHECK_Check4BenchArmedPeriodic);
+  SleepTicks = ES_GetTicksToNextCheck();
+  if ((SleepTicks > BENCH_ARMED_CHECK_PERIOD) ||
+      ((SleepTicks == 0) != ES_CheckersPending()))
+  {
+    Wrong = true;
+  }
+  while (ArmedPeriodicChecks == Calls + 1)
+  {
+    Passes += CheckPass();
+  }
+  Mode = CountingDispatches;
+
+  printf("event checkers, %lu passes: %lu periodic in %lu ticks "
+         "(%u apart at least), %lu armed for %lu arms, %lu armed periodic "
+         "(%u apart at least)\r\n",
+         (unsigned long)Passes, (unsigned long)PeriodicChecks,
+         (unsigned long)Ticks, (unsigned)MinPeriodicGap,
+         (unsigned long)ArmedChecks, (unsigned long)ArmedByISR,
+         (unsigned long)ArmedPeriodicChecks, (unsigned)MinArmedPeriodicGap);
+  if (Wrong || (EveryPassChecks != Passes) || (PeriodicChecks == 0) ||
+      (PeriodicChecks > Ticks / BENCH_CHECK_PERIOD) ||
+      (MinPeriodicGap < BENCH_CHECK_PERIOD) ||
+      (ArmedChecks != ArmedByISR) || (ArmedByISR != ISR_REPS) ||
+      (MinArmedPeriodicGap < BENCH_ARMED_CHECK_PERIOD) ||
+      ES_CheckersPending())
+  {
+    printf("event checkers called out of turn\r\n");
+  }
+}
+
+// keeps the fewest ticks between calls of a rate limited checker
+static void NoteCheckGap(uint32_t Calls, uint16_t *pLastTick,
+                         uint16_t *pMinGap)
+{
+  uint16_t Tick = ES_Timer_GetTime();
+
+  if ((Calls != 0) && ((uint16_t)(Tick - *pLastTick) < *pMinGap))
+  {
+    *pMinGap = Tick - *pLastTick;
+  }
+  *pLastTick = Tick;
+}
+
+// a pass of the idle loop: take the interrupts, then check for events
+static uint32_t CheckPass(void)
+{
+  _HW_Process_Pending_Ints();
+  ES_CheckUserEvents();
+  return 1;
+}
+
+// fills ParserStream with as many of ParserFrames as fit, as they would be
+// on the wire in APIMode, returning the number of bytes and of frames
+static uint16_t BuildParserStream(uint8_t APIMode, uint32_t *pNumFrames)
+{
+  uint8_t Frame[3 + 16];
+  uint16_t Length = 0;
+  uint8_t FrameLength;
+  uint8_t Sum;
+  uint8_t i;
+  uint8_t j;
+
+  *pNumFrames = 0;
+  for (i = 0; ; i = (i + 1) % ARRAY_SIZE(ParserFrames))
+  {
+    // the length, the data and the checksum, before any escaping
+    FrameLength = 0;
+    Sum = 0;
+    Frame[FrameLength++] = 0;
+    Frame[FrameLength++] = ParserFrameLengths[i];
+    for (j = 0; j < ParserFrameLengths[i]; j++)
+    {
+      Frame[FrameLength++] = ParserFrames[i][j];
+      Sum += ParserFrames[i][j];
+    }
+    Frame[FrameLength++] = 0xFF - Sum;
+
+    // stop once the frame might not fit, with every byte escaped
+    if (Length + 1 + 2 * FrameLength > BENCH_STREAM_SIZE)
+    {
+      return Length;
+    }
+    ParserStream[Length++] = XBEE_START_DELIMITER;
+    for (j = 0; j < FrameLength; j++)
+    {
+      if ((APIMode == XBEE_API_ESCAPED) && XBee_NeedsEscape(Frame[j]))
+      {
+        ParserStream[Length++] = XBEE_ESCAPE;
+        ParserStream[Length++] = Frame[j] ^ XBEE_ESCAPE_XOR;
+      }
+      else
+      {
+        ParserStream[Length++] = Frame[j];
+      }
+    }
+    (*pNumFrames)++;
+  }
+}
+
+// prints the mean time per operation, to a tenth of a unit
+static void PrintResult(const char *Name, uint8_t Services, uint8_t Depth,
+                        uint64_t Total, uint32_t Count)
+{
+  uint64_t Tenths = (Total * 10 + Count / 2) / Count;
+
+  printf("%-28s %2u svc %2u deep %6lu.%lu " BENCH_UNITS "\r\n", Name,
+         (unsigned)Services, (unsigned)Depth,
+         (unsigned long)(Tenths / 10), (unsigned long)(Tenths % 10));
+}
+
+// the same for the pool benchmarks, which have a count of blocks in use
+static void PrintPoolResult(const char *Name, uint8_t InUse,
+                            uint64_t Total, uint32_t Count)
+{
+  uint64_t Tenths = (Total * 10 + Count / 2) / Count;
+
+  printf("%-28s %2u in use     %6lu.%lu " BENCH_UNITS "\r\n", Name,
+         (unsigned)InUse, (unsigned long)(Tenths / 10),
+         (unsigned long)(Tenths % 10));
+}
+
+// the same for the timer benchmarks, which have a timer count instead
+static void PrintTimerResult(const char *Name, uint8_t NumTimers,
+                             uint64_t Total, uint32_t Count)
+{
+  uint64_t Tenths = (Total * 10 + Count / 2) / Count;
+
+  printf("%-28s %2u timers     %6lu.%lu " BENCH_UNITS "\r\n", Name,
+         (unsigned)NumTimers, (unsigned long)(Tenths / 10),
+         (unsigned long)(Tenths % 10));
+}
+
+// the same for the state machine benchmarks, per event
+static void PrintMachineResult(const char *Name, uint64_t Total,
+                               uint32_t Count)
+{
+  uint64_t Tenths = (Total * 10 + Count / 2) / Count;
+
+  printf("%-28s per event     %6lu.%lu " BENCH_UNITS "\r\n", Name,
+         (unsigned long)(Tenths / 10), (unsigned long)(Tenths % 10));
+}
+
+// the same for the parser benchmark, per byte, with the bytes per second
+static void PrintParserResult(const char *Name, uint64_t Total,
+                              uint32_t Count)
+{
+  uint64_t Tenths = (Total * 10 + Count / 2) / Count;
+
+  printf("%-28s per byte      %6lu.%lu " BENCH_UNITS " %10lu bytes/s\r\n",
+         Name, (unsigned long)(Tenths / 10), (unsigned long)(Tenths % 10),
+         (unsigned long)(Count * BENCH_UNITS_PER_S / Total));
+}
+
+// the same for the event checker benchmark, per pass of the idle loop
+static void PrintCheckResult(const char *Name, uint64_t Total,
+                             uint32_t Count)
+{
+  uint64_t Tenths = (Total * 10 + Count / 2) / Count;
+
+  printf("%-28s per pass      %6lu.%lu " BENCH_UNITS "\r\n", Name,
+         (unsigned long)(Tenths / 10), (unsigned long)(Tenths % 10));
+}
+
+// the latency samples, from StartLatency on
+static void PrintLatency(const char *Name)
+{
+  printf("%-28s           min %lu avg %lu max %lu " BENCH_UNITS "\r\n",
+         Name, (unsigned long)LatencyMin,
+         (unsigned long)(LatencyTotal / LatencySamples),
+         (unsigned long)LatencyMax);
+}
@@ -0,0 +1,220 @@
+/****************************************************************************
+ Module
+     ES_Buffer.c
+
+ Description
+     This is a module implementing reference counted packet buffers that
+     events can carry from service to service, so that a frame can be handed
+     along without copying it and without a later frame overwriting it.
+
+ Notes
+     A buffer is allocated with a count of 1, which belongs to whoever
+     allocated it. Posting an event with ES_PostWithBuffer adds a reference
+     for the queued event, and ES_Run drops that reference once the run
+     function that the event was dispatched to returns. Any service that
+     wants to keep the buffer past that point calls ES_BufRetain, and
+     ES_BufRelease when it is done with it. The buffer goes back to the pool
+     when the last reference is released.
+     The memory of each buffer is a block from the ES_Pool pools, sized for
+     what was asked for, so there are ES_NUM_BUFFERS handles but the RAM is
+     set by the pool sizes.
+     Handles start at 1 so that ES_NO_BUFFER (0) is never a valid handle.
+     All of the functions may be called from interrupt responses.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                take the memory from ES_Pool
+ 10/17/26                started coding
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_General.h"
+#include "ES_Port.h"
+#include "ES_Pool.h"
+#include "ES_Buffer.h"
+
+/*--------------------------- External Variables --------------------------*/
+
+/*----------------------------- Module Defines ----------------------------*/
+#if (ES_NUM_BUFFERS < 1) || (ES_NUM_BUFFERS > 254)
+#error ES_NUM_BUFFERS must be between 1 and 254
+#endif
+
+// the most references that a buffer can have
+#define MAX_REF_COUNT 0xFF
+
+/*------------------------------ Module Types -----------------------------*/
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+static uint8_t *BufData[ES_NUM_BUFFERS];
+static uint8_t RefCount[ES_NUM_BUFFERS];
+
+// the free buffers are kept in a list linked through NextFree
+static ES_BufHandle_t NextFree[ES_NUM_BUFFERS];
+static ES_BufHandle_t FreeHead;
+static uint8_t NumFree;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_InitBuffers
+ Parameters
+   None
+ Returns
+   None
+ Description
+   puts every buffer into the free list
+ Notes
+   called by ES_Initialize after ES_PoolInit, any buffers still allocated
+   are lost
+****************************************************************************/
+void ES_InitBuffers( void )
+{
+  uint8_t i;
+
+  EnterCritical();
+  for ( i = 0; i < ES_NUM_BUFFERS; i++ ){
+    RefCount[i] = 0;
+    BufData[i] = NULL;
+    NextFree[i] = i + 2; // the handle of the next buffer
+  }
+  NextFree[ES_NUM_BUFFERS - 1] = ES_NO_BUFFER;
+  FreeHead = 1;
+  NumFree = ES_NUM_BUFFERS;
+  ExitCritical();
+}
+
+/****************************************************************************
+ Function
+   ES_BufAlloc
+ Parameters
+   uint16_t : the number of bytes needed
+ Returns
+   ES_BufHandle_t : the handle of the buffer, ES_NO_BUFFER if there are no
+   handles left or the pool for that size is empty
+ Description
+   takes a buffer of at least Size bytes, with a reference count of 1
+ Notes
+   the contents of the buffer are whatever its last user left there
+****************************************************************************/
+ES_BufHandle_t ES_BufAlloc( uint16_t Size )
+{
+  ES_BufHandle_t Buffer;
+  uint8_t *pData;
+
+  // ES_PoolAlloc has its own critical section, so it can't go inside ours
+  pData = ES_PoolAlloc( Size );
+  if ( pData == NULL )
+    return ES_NO_BUFFER;
+
+  EnterCritical();
+  Buffer = FreeHead;
+  if ( Buffer != ES_NO_BUFFER ){
+    FreeHead = NextFree[Buffer - 1];
+    RefCount[Buffer - 1] = 1;
+    BufData[Buffer - 1] = pData;
+    NumFree--;
+  }
+  ExitCritical();
+
+  if ( Buffer == ES_NO_BUFFER )
+    ES_PoolFree( pData );
+  return Buffer;
+}
+
+/****************************************************************************
+ Function
+   ES_BufRetain
+ Parameters
+   ES_BufHandle_t : the buffer
+ Returns
+   bool : false if the handle is not that of an allocated buffer, or the
+   buffer already has as many references as it can count
+ Description
+   adds a reference to a buffer
+****************************************************************************/
+bool ES_BufRetain( ES_BufHandle_t Buffer )
+{
+  bool ReturnVal = false;
+
+  if ( (Buffer == ES_NO_BUFFER) || (Buffer > ES_NUM_BUFFERS) )
+    return false;
+  EnterCritical();
+  if ( (RefCount[Buffer - 1] != 0) && (RefCount[Buffer - 1] != MAX_REF_COUNT) ){
+    RefCount[Buffer - 1]++;
+    ReturnVal = true;
+  }
+  ExitCritical();
+  return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+   ES_BufRelease
+ Parameters
+   ES_BufHandle_t : the buffer
+ Returns
+   None
+ Description
+   drops a reference to a buffer, returning it to the pool if that was the
+   last one
+ Notes
+   ES_NO_BUFFER and handles of buffers that are not allocated are ignored
+****************************************************************************/
+void ES_BufRelease( ES_BufHandle_t Buffer )
+{
+  uint8_t *pData = NULL;
+
+  if ( (Buffer == ES_NO_BUFFER) || (Buffer > ES_NUM_BUFFERS) )
+    return;
+  EnterCritical();
+  if ( RefCount[Buffer - 1] != 0 ){
+    if ( --RefCount[Buffer - 1] == 0 ){
+      pData = BufData[Buffer - 1];
+      BufData[Buffer - 1] = NULL;
+      NextFree[Buffer - 1] = FreeHead;
+      FreeHead = Buffer;
+      NumFree++;
+    }
+  }
+  ExitCritical();
+
+  if ( pData != NULL )
+    ES_PoolFree( pData );
+}
+
+/****************************************************************************
+ Function
+   ES_BufData
+ Parameters
+   ES_BufHandle_t : the buffer
+ Returns
+   uint8_t * : the bytes of the buffer, NULL if the handle is not that of
+   an allocated buffer
+****************************************************************************/
+uint8_t * ES_BufData( ES_BufHandle_t Buffer )
+{
+  if ( (Buffer == ES_NO_BUFFER) || (Buffer > ES_NUM_BUFFERS) ||
+       (RefCount[Buffer - 1] == 0) )
+    return NULL;
+  return BufData[Buffer - 1];
+}
+
+/****************************************************************************
+ Function
+   ES_BufNumFree
+ Parameters
+   None
+ Returns
+   uint8_t : the number of buffer handles that are not in use
+****************************************************************************/
+uint8_t ES_BufNumFree( void )
+{
+  return NumFree;
+}
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
@@ -5,9 +5,21 @@
      source file for the module to call the User event checking routines
  Notes
      Users should not modify the contents of this file.
+     The checkers are registered in EVENT_CHECK_LIST (ES_Configure.h), each
+     with the least number of ticks between calls and whether it has to be
+     armed, normally by the interrupt that produces what it looks for
+     (ES_ArmEventChecker), before it is called. ES_CheckUserEvents only
+     calls the checkers that are due, so a slow or rarely needed checker
+     costs the idle loop next to nothing the rest of the time.
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                added ES_CheckersPending; an armed checker with a
+                         period limits the tickless sleep; the list size is
+                         checked against ArmedCheckers at compile time
+ 10/17/26                the checkers are registered with a period and
+                         whether they must be armed, and only those that are
+                         due are called
                 jec     out all user modifications into ES_Configure
  10/16/11 12:32 jec      started coding
 *****************************************************************************/
@@ -15,6 +27,8 @@
 #include "ES_Configure.h"
 #include "ES_Events.h"
 #include "ES_General.h"
+#include "ES_Port.h"
+#include "ES_Timers.h"
 #include "ES_CheckEvents.h"
 
 // Include the header files for the module(s) with your event checkers. 
@@ -22,10 +36,32 @@
 
 #include EVENT_CHECK_HEADER
 
-// Fill in this array with the names of your event checking functions
+/*----------------------------- Module Defines ----------------------------*/
+#define ES_CHECKER_DESC(Function, PeriodTicks, Armed) \
+  { Function, PeriodTicks, Armed },
 
-static CheckFunc * const ES_EventList[]={EVENT_CHECK_LIST };
+/*------------------------------ Module Types -----------------------------*/
+typedef struct {
+  CheckFunc *pFunc;
+  uint16_t PeriodTicks;   // fewest ticks between calls, 0 for no limit
+  bool Armed;             // only called after ES_ArmEventChecker
+} ES_CheckerDesc_t;
 
+/*---------------------------- Module Variables ---------------------------*/
+// the event checking functions, from EVENT_CHECK_LIST
+static ES_CheckerDesc_t const ES_EventList[] = {
+  EVENT_CHECK_LIST(ES_CHECKER_DESC)
+};
+
+// a compile time check that ArmedCheckers has a bit for every checker, the
+// size going negative if it does not
+typedef char ES_CheckerListCheck_t[(ARRAY_SIZE(ES_EventList) <= 32) ? 1 : -1];
+
+// when each checker was last called (ES_Timer_GetTime)
+static uint16_t LastCall[ARRAY_SIZE(ES_EventList)];
+
+// a bit for each checker that has been armed and not yet called
+static volatile uint32_t ArmedCheckers;
 
 // Implementation for public functions
 
@@ -38,6 +74,8 @@ static CheckFunc * const ES_EventList[]={EVENT_CHECK_LIST };
    bool: true if any of the user event checkers returned true, false otherwise
  Description
    loop through the EF_EventList array executing the event checking functions
+   that are due: their period has gone by since they were last called, and
+   if they need arming, they have been armed
  Notes
    
  Author
@@ -45,16 +83,112 @@ static CheckFunc * const ES_EventList[]={EVENT_CHECK_LIST };
 ****************************************************************************/
 bool ES_CheckUserEvents( void ) 
 {
+  uint16_t Now = ES_Timer_GetTime();
   uint8_t i;
   // loop through the array executing the event checking functions
   for ( i=0; i< ARRAY_SIZE(ES_EventList); i++) {
-    if ( ES_EventList[i]() == true )
-      break; // found a new event, so process it first
+    if ( (uint16_t)(Now - LastCall[i]) < ES_EventList[i].PeriodTicks )
+      continue; // not due yet
+    if ( ES_EventList[i].Armed ){
+      if ( (ArmedCheckers & (1UL << i)) == 0 )
+        continue; // nothing has happened for it to look at
+      ES_AtomicClrBit( &ArmedCheckers, i );
+    }
+    LastCall[i] = Now;
+    if ( ES_EventList[i].pFunc() == true )
+      return(true); // found a new event, so process it first
+  }
+  return (false);
+}
+
+/****************************************************************************
+ Function
+   ES_ArmEventChecker
+ Parameters
+   uint8_t : the checker, CHECK_Function after its EVENT_CHECK_LIST entry
+ Returns
+   None
+ Description
+   has the checker called the next time ES_CheckUserEvents finds it due
+ Notes
+   meant for interrupt responses: the interrupt also wakes the tickless
+   idle, so an armed checker needs no polling at all
+****************************************************************************/
+void ES_ArmEventChecker( uint8_t WhichChecker )
+{
+  if ( WhichChecker < ARRAY_SIZE(ES_EventList) )
+    ES_AtomicSetBit( &ArmedCheckers, WhichChecker );
+}
+
+/****************************************************************************
+ Function
+   ES_CheckersPending
+ Parameters
+   None
+ Returns
+   bool : true if a checker has been armed and is due to be called
+ Description
+   for the tickless idle, which must not sleep with an armed checker
+   waiting: the interrupt that armed it may have come after
+   ES_CheckUserEvents looked, and won't come again to wake the CPU
+ Notes
+   call with interrupts off, together with the test of the ready set. An
+   armed checker whose period has yet to run out is left to
+   ES_GetTicksToNextCheck, which wakes the CPU when it is due
+****************************************************************************/
+bool ES_CheckersPending( void )
+{
+  uint32_t Armed = ArmedCheckers;
+  uint16_t Now;
+  uint8_t i;
+
+  if ( Armed == 0 )
+    return false;
+  Now = ES_Timer_GetTime();
+  for ( i=0; i< ARRAY_SIZE(ES_EventList); i++) {
+    if ( (Armed & (1UL << i)) &&
+         ((uint16_t)(Now - LastCall[i]) >= ES_EventList[i].PeriodTicks) )
+      return true;
+  }
+  return false;
+}
+
+/****************************************************************************
+ Function
+   ES_GetTicksToNextCheck
+ Parameters
+   None
+ Returns
+   uint32_t : ticks until the first of the periodic checkers is due,
+              0xFFFFFFFF if none are
+ Description
+   how long the tickless idle (_HW_Sleep) may sleep without making a
+   checker late
+ Notes
+   checkers without a period are called whenever the idle loop runs, and
+   those that wait to be armed by an interrupt are woken by it, so neither
+   limits the sleep. An armed checker that has been armed but whose period
+   has yet to run out does, as nothing else may wake the CPU when it is due
+   (ES_CheckersPending keeps the CPU awake once it is)
+****************************************************************************/
+uint32_t ES_GetTicksToNextCheck( void )
+{
+  uint16_t Now = ES_Timer_GetTime();
+  uint32_t Ticks = 0xFFFFFFFFUL;
+  uint16_t Since;
+  uint8_t i;
+
+  for ( i=0; i< ARRAY_SIZE(ES_EventList); i++) {
+    if ( (ES_EventList[i].PeriodTicks == 0) ||
+         (ES_EventList[i].Armed && ((ArmedCheckers & (1UL << i)) == 0)) )
+      continue;
+    Since = (uint16_t)(Now - LastCall[i]);
+    if ( Since >= ES_EventList[i].PeriodTicks )
+      return 0;
+    if ( (uint32_t)(ES_EventList[i].PeriodTicks - Since) < Ticks )
+      Ticks = ES_EventList[i].PeriodTicks - Since;
   }
-  if ( i == ARRAY_SIZE(ES_EventList) ) // if no new events
-    return (false);
-  else
-    return(true);
+  return Ticks;
 }
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
@@ -11,7 +11,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
- 
+ 10/17/26                added ES_DeferEvent to keep hold of an event's buffer
+                         while it is deferred
  10/11/14 14:58 jec     converted RecallEvent to RecallEvents to pull all
                         deferred events off the deferral queue
  11/02/13 16:38 jec      Began Coding
@@ -35,6 +36,32 @@
 /*---------------------------- Module Variables ---------------------------*/
 
 /*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+     ES_DeferEvent
+ Parameters
+      ES_Event * pBlock, pointer to the block of memory that implements the
+        Defer/Recall queue
+      ES_Event Event2Add, the event to defer
+ Returns
+     bool true if the event was deferred, false if the queue was full
+ Description
+     adds the event to the deferral queue. If it carries a buffer, the
+     deferral queue takes a reference to it so that it outlives the run
+     function that deferred it.
+ Notes
+     uses ES_EnQueueLIFO, as the macro that this replaced did
+****************************************************************************/
+bool ES_DeferEvent( ES_Event * pBlock, ES_Event Event2Add ){
+  if ( (Event2Add.Buffer != ES_NO_BUFFER) &&
+       (ES_BufRetain( Event2Add.Buffer ) == false) )
+    return false;
+  if ( ES_EnQueueLIFO( pBlock, Event2Add ) == true )
+    return true;
+  ES_BufRelease( Event2Add.Buffer );
+  return false;
+}
+
 /****************************************************************************
  Function
      ES_RecallEvents
@@ -49,7 +76,8 @@
      something in the queue, then it posts it LIFO fashion to the queue 
      indicated by WhichService
  Notes
-     None.
+     The deferral queue's reference to an event's buffer passes to the
+     service's queue, or is released if the event can't be posted.
  Author
      J. Edward Carryer, 11/20/13 16:49
 ****************************************************************************/
@@ -61,7 +89,8 @@ bool ES_RecallEvents( uint8_t WhichService, ES_Event * pBlock ){
 	{	
 		ES_DeQueue( pBlock, &RecalledEvent );
 		if (RecalledEvent.EventType != ES_NO_EVENT){
-			ES_PostToServiceLIFO( WhichService, RecalledEvent);
+			if ( ES_PostToServiceLIFO( WhichService, RecalledEvent) == false )
+				ES_BufRelease( RecalledEvent.Buffer );
 			WereEventsPulled = true;
 		}
   }while(RecalledEvent.EventType != ES_NO_EVENT);
@@ -8,6 +8,41 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                the tickless idle doesn't sleep with an armed event
+                         checker waiting (ES_CheckersPending)
+ 10/17/26                overflow policies (ES_OVERFLOW_POLICIES): a full
+                         queue can push out its oldest event or report the
+                         post to ES_OVERFLOW_HANDLER, with both counted in
+                         the service statistics
+ 10/17/26                added ES_Multicast, which reports the services that
+                         dropped the event
+ 10/17/26                batched posts (ES_PostBatch, ES_PostMulti), which
+                         ES_PostAll now uses, with Ready set once per batch
+ 10/17/26                posts and run functions are recorded in the trace
+                         (ES_TRACE_SIZE), which ES_Run sends out when idle
+                         with ES_TRACE_DRAIN
+ 10/17/26                ServDescList, the queues and the budgets are
+                         generated from ES_SERVICE_LIST, and the statistics
+                         keep the queue size each service needed
+ 10/17/26                run function budgets (ES_RUN_BUDGETS), with overruns
+                         counted in the service statistics, and the hardware
+                         watchdog (ES_WATCHDOG_MS)
+ 10/17/26                optional preemptive scheduling (ES_PREEMPTIVE), the
+                         dispatch of one event moved out of ES_Run into
+                         Dispatch
+ 10/17/26                queue policies (ES_QUEUE_POLICIES) for coalescing
+                         events, counted in the service statistics
+ 10/17/26                ES_Initialize sets up the memory pools (ES_Pool)
+ 10/17/26                events can carry a packet buffer (ES_PostWithBuffer),
+                         released by ES_Run after the run function returns
+ 10/17/26                ES_Run sleeps between events when ES_TICKLESS is
+                         defined
+ 10/17/26                Ready is now 32 bits, updated atomically and searched
+                         with CLZ (ES_GetMSBitSet32), for up to 32 services
+ 10/17/26                added SERV_x_QUEUE_SPSC to select the lock-free
+                         single producer/single consumer queue per service
+ 10/17/26                added the optional per-service statistics
+                         (ES_SERVICE_STATS)
  11/02/13 17:05 jec      added PostToServiceLIFO function
  10/21/13 17:50 jec      added entries to expand number of possible services to 
                          16
@@ -36,6 +71,40 @@
 
 
 /*----------------------------- Module Defines ----------------------------*/
+#if MAX_NUM_SERVICES > 32
+#error the Ready variable can only handle 32 services
+#endif
+#if defined(ES_RUN_BUDGETS) && !defined(ES_SERVICE_STATS)
+#error ES_RUN_BUDGETS needs ES_SERVICE_STATS to time the run functions
+#endif
+#if defined(ES_OVERRUN_LIMIT) && \
+    (!defined(ES_RUN_BUDGETS) || !defined(ES_WATCHDOG_MS))
+#error ES_OVERRUN_LIMIT needs ES_RUN_BUDGETS and ES_WATCHDOG_MS
+#endif
+#if defined(ES_OVERRUN_LIMIT) && ((ES_OVERRUN_LIMIT < 1) || (ES_OVERRUN_LIMIT > 255))
+#error ES_OVERRUN_LIMIT must be between 1 and 255
+#endif
+
+// the tables for the services are generated from ES_SERVICE_LIST in
+// ES_Configure.h, with these making the entries. Each queue has room for
+// its header as well as QueueSize events
+#define ES_SERVICE_DESC(Name, InitFunc, RunFunc, QueueSize, SPSC, BudgetUS) \
+  { InitFunc, RunFunc },
+#define ES_SERVICE_QUEUE(Name, InitFunc, RunFunc, QueueSize, SPSC, BudgetUS) \
+  static ES_Event Queue_##Name[(QueueSize)+1];
+#define ES_SERVICE_QUEUE_DESC(Name, InitFunc, RunFunc, QueueSize, SPSC, \
+                              BudgetUS) \
+  { Queue_##Name, ARRAY_SIZE(Queue_##Name), SPSC },
+#define ES_SERVICE_BUDGET(Name, InitFunc, RunFunc, QueueSize, SPSC, BudgetUS) \
+  (BudgetUS) * ES_CYCLES_PER_US,
+
+// the bits of the services with each overflow policy, from
+// ES_OVERFLOW_POLICIES in ES_Configure.h
+#define ES_OVERWRITE_BIT(Name, Policy) \
+  (((Policy) == ES_OVERFLOW_DROP_OLDEST) ? (1UL << SERV_##Name) : 0) |
+#define ES_ESCALATE_BIT(Name, Policy) \
+  (((Policy) == ES_OVERFLOW_ESCALATE) ? (1UL << SERV_##Name) : 0) |
+
 typedef bool InitFunc_t( uint8_t Priority );
 typedef ES_Event RunFunc_t( ES_Event ThisEvent );
 
@@ -52,176 +121,192 @@ typedef struct {
 typedef struct {
     ES_Event *pMem;       // pointer to the memory
     uint8_t Size;      // how big is it
+    bool IsSPSC;       // lock-free single producer/single consumer queue?
 }ES_QueueDesc_t;
 
-/*---------------------------- Module Functions ---------------------------*/
-//static bool CheckSystemEvents( void );
-
-/*---------------------------- Module Variables ---------------------------*/
-/****************************************************************************/
-// You fill in this array with the names of the service init & run functions
-// for each service that you use.
-// The order is: InitFunction, RunFunction
-// The first entry, at index 0, is the lowest priority, with increasing
-// priority with higher indices
+#ifdef ES_SERVICE_STATS
+// the running totals behind ES_ServiceStats_t
+typedef struct {
+    uint32_t Dispatches;
+    uint32_t MinRunTime;
+    uint32_t MaxRunTime;
+    uint64_t TotalRunTime;
+    uint32_t RejectedPosts;
+    uint32_t Coalesced;
+    uint32_t Overwritten;
+    uint32_t Escalated;
+    uint32_t Overruns;
+    ES_EventTyp_t OverrunEvent;
+    uint8_t OverrunsInARow;
+    uint8_t HighWater;
+    uint8_t Unqueued;   // posts rejected since the queue was last empty
+    uint8_t Needed;
+}ES_ServStats_t;
 
-static ES_ServDesc_t const ServDescList[] =
-{ {SERV_0_INIT, SERV_0_RUN } /* lowest priority  always present */
-#if NUM_SERVICES > 1
-  ,{SERV_1_INIT, SERV_1_RUN }
-#endif
-#if NUM_SERVICES > 2
-  ,{SERV_2_INIT, SERV_2_RUN }
-#endif
-#if NUM_SERVICES > 3
-  ,{SERV_3_INIT, SERV_3_RUN }
-#endif
-#if NUM_SERVICES > 4
-  ,{SERV_4_INIT, SERV_4_RUN }
-#endif
-#if NUM_SERVICES > 5
-  ,{SERV_5_INIT, SERV_5_RUN }
-#endif
-#if NUM_SERVICES > 6
-  ,{SERV_6_INIT, SERV_6_RUN }
-#endif
-#if NUM_SERVICES > 7
-  ,{SERV_7_INIT, SERV_7_RUN }
-#endif
-#if NUM_SERVICES > 8
-  ,{SERV_8_INIT, SERV_8_RUN }
+// start byte and version for ES_DumpServiceStats
+#define STATS_DUMP_START    0x7E
+#define STATS_DUMP_VERSION  5
 #endif
-#if NUM_SERVICES > 9
-  ,{SERV_9_INIT, SERV_9_RUN }
-#endif
-#if NUM_SERVICES > 10
-  ,{SERV_10_INIT, SERV_10_RUN }
+
+// a bit for each service, as in Ready (ES_PostAll)
+#define ALL_SERVICES ((uint32_t)(0xFFFFFFFFUL >> (32 - NUM_SERVICES)))
+
+#ifdef ES_PREEMPTIVE
+// values of RunningPriority when no run function is running: in ES_Run's own
+// loop, where anything that is ready can run, and outside ES_Run (during
+// ES_Initialize or after ES_Run has returned), where nothing is run
+#define BASE_PRIORITY (-1)
+#define NOT_RUNNING   ((int8_t)MAX_NUM_SERVICES)
 #endif
-#if NUM_SERVICES > 11
-  ,{SERV_11_INIT, SERV_11_RUN }
+
+#ifdef ES_QUEUE_POLICIES
+// an entry in the table of queue policies
+typedef struct {
+    uint8_t WhichService;
+    ES_EventTyp_t EventType;
+    ES_QueuePolicy_t Policy;
+}ES_PolicyDesc_t;
 #endif
-#if NUM_SERVICES > 12
-  ,{SERV_12_INIT, SERV_12_RUN }
+
+/*---------------------------- Module Functions ---------------------------*/
+//static bool CheckSystemEvents( void );
+static bool EnQueue( uint8_t WhichService, ES_Event TheEvent );
+static void MarkReady( uint8_t WhichService );
+static bool Dispatch( uint8_t WhichService );
+#ifdef ES_WATCHDOG_MS
+static void FeedWatchdog( void );
 #endif
-#if NUM_SERVICES > 13
-  ,{SERV_13_INIT, SERV_13_RUN }
+static uint8_t DeQueue( uint8_t WhichService, ES_Event *pReturnEvent );
+static uint8_t NumEntries( uint8_t WhichService );
+#ifdef ES_QUEUE_POLICIES
+static bool EnQueueWithPolicy( uint8_t WhichService, ES_Event TheEvent );
 #endif
-#if NUM_SERVICES > 14
-  ,{SERV_14_INIT, SERV_14_RUN }
+#ifdef ES_OVERFLOW_POLICIES
+static bool Overflow( uint8_t WhichService, ES_Event TheEvent );
 #endif
-#if NUM_SERVICES > 15
-  ,{SERV_15_INIT, SERV_15_RUN }
+#ifdef ES_SERVICE_STATS
+static void NotePosted( uint8_t WhichService );
+static void NoteRejected( uint8_t WhichService );
+static void NoteDepth( uint8_t WhichService, bool Rejected );
+static void NoteCoalesced( uint8_t WhichService );
+static void NoteOverwritten( uint8_t WhichService );
+static void NoteEscalated( uint8_t WhichService );
+static void NoteDispatched( uint8_t WhichService, uint32_t RunTime,
+                            ES_EventTyp_t EventType );
+static uint8_t DumpWord( uint32_t Word, uint8_t Sum, uint8_t NumBytes );
 #endif
 
+/*---------------------------- Module Variables ---------------------------*/
+/****************************************************************************/
+// a compile time check on the number of services in ES_SERVICE_LIST, the
+// size going negative if there are none or too many
+
+typedef char ES_ServiceListCheck_t[((NUM_SERVICES >= 1) &&
+                                    (NUM_SERVICES <= MAX_NUM_SERVICES)) ?
+                                   1 : -1];
+
+/****************************************************************************/
+// The init & run functions for each service, from ES_SERVICE_LIST.
+// The first entry, at index 0, is the lowest priority, with increasing
+// priority with higher indices
+
+static ES_ServDesc_t const ServDescList[NUM_SERVICES] =
+{
+  ES_SERVICE_LIST(ES_SERVICE_DESC)
 };
 
+#ifdef ES_RUN_BUDGETS
+/****************************************************************************/
+// the budgets, in CPU cycles, indexed like ServDescList
+
+static uint32_t const Budgets[NUM_SERVICES] =
+{
+  ES_SERVICE_LIST(ES_SERVICE_BUDGET)
+};
+#endif
 
 /****************************************************************************/
 // The queues for the services
 
-static ES_Event Queue0[SERV_0_QUEUE_SIZE+1];
-#if NUM_SERVICES > 1
-static ES_Event Queue1[SERV_1_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 2
-static ES_Event Queue2[SERV_2_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 3
-static ES_Event Queue3[SERV_3_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 4
-static ES_Event Queue4[SERV_4_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 5
-static ES_Event Queue5[SERV_5_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 6
-static ES_Event Queue6[SERV_6_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 7
-static ES_Event Queue7[SERV_7_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 8
-static ES_Event Queue8[SERV_8_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 9
-static ES_Event Queue9[SERV_9_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 10
-static ES_Event Queue10[SERV_10_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 11
-static ES_Event Queue11[SERV_11_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 12
-static ES_Event Queue12[SERV_12_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 13
-static ES_Event Queue13[SERV_13_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 14
-static ES_Event Queue14[SERV_14_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 15
-static ES_Event Queue15[SERV_15_QUEUE_SIZE+1];
-#endif
+ES_SERVICE_LIST(ES_SERVICE_QUEUE)
 
 /****************************************************************************/
 // array of queue descriptors for posting by priority level
 
-static ES_QueueDesc_t const EventQueues[NUM_SERVICES] = { 
-  { Queue0, ARRAY_SIZE(Queue0) } 
-#if NUM_SERVICES > 1
-, { Queue1, ARRAY_SIZE(Queue1) }
-#endif
-#if NUM_SERVICES > 2
-, { Queue2, ARRAY_SIZE(Queue2) }
-#endif
-#if NUM_SERVICES > 3
-, { Queue3, ARRAY_SIZE(Queue3) }
-#endif
-#if NUM_SERVICES > 4
-, { Queue4, ARRAY_SIZE(Queue4) }
-#endif
-#if NUM_SERVICES > 5
-, { Queue5, ARRAY_SIZE(Queue5) }
-#endif
-#if NUM_SERVICES > 6
-, { Queue6, ARRAY_SIZE(Queue6) }
-#endif
-#if NUM_SERVICES > 7
-, { Queue7, ARRAY_SIZE(Queue7) }
-#endif
-#if NUM_SERVICES > 8
-, { Queue8, ARRAY_SIZE(Queue8) }
-#endif
-#if NUM_SERVICES > 9
-, { Queue9, ARRAY_SIZE(Queue9) }
-#endif
-#if NUM_SERVICES > 10
-, { Queue10, ARRAY_SIZE(Queue10) }
-#endif
-#if NUM_SERVICES > 11
-, { Queue11, ARRAY_SIZE(Queue11) }
-#endif
-#if NUM_SERVICES > 12
-, { Queue12, ARRAY_SIZE(Queue12) }
+static ES_QueueDesc_t const EventQueues[NUM_SERVICES] =
+{
+  ES_SERVICE_LIST(ES_SERVICE_QUEUE_DESC)
+};
+
+/****************************************************************************/
+// Variable used to keep track of which queues have events in them. Bits are
+// only ever changed with ES_AtomicSetBit/ES_AtomicClrBit, so that posts
+// from interrupts cannot be lost
+
+volatile uint32_t Ready;
+
+/****************************************************************************/
+// the buffer that ES_PostWithBuffer is attaching to the event that it is
+// posting. ES_PostToService & ES_PostAll put this in every event they post,
+// which keeps whatever was left in the Buffer field of an event out of the
+// queues
+
+static ES_BufHandle_t PostingBuffer = ES_NO_BUFFER;
+
+/****************************************************************************/
+// the services posted to in the batch that is open (ES_BeginPostBatch),
+// which are marked ready all at once when it ends. Interrupts are off while
+// a batch is open, so these need no protection
+
+static uint8_t BatchDepth;
+static uint32_t BatchReady;
+
+#ifdef ES_PREEMPTIVE
+/****************************************************************************/
+// the priority of the service whose run function is running (the innermost
+// one when services have been preempted), and whether any run function has
+// failed since ES_Run started. Only services of higher priority than
+// RunningPriority may be started
+
+static volatile int8_t RunningPriority = NOT_RUNNING;
+static volatile bool RunFailed;
 #endif
-#if NUM_SERVICES > 13
-, { Queue13, ARRAY_SIZE(Queue13) }
+
+#ifdef ES_SERVICE_STATS
+/****************************************************************************/
+// statistics for each of the services, indexed like ServDescList
+
+static ES_ServStats_t ServStats[NUM_SERVICES];
 #endif
-#if NUM_SERVICES > 14
-, { Queue14, ARRAY_SIZE(Queue14) }
+
+#ifdef ES_OVERRUN_LIMIT
+/****************************************************************************/
+// a bit for each service that has overrun its budget ES_OVERRUN_LIMIT times
+// in a row. While any are set the watchdog is not fed
+
+static uint32_t OverLimit;
 #endif
-#if NUM_SERVICES > 15
-, { Queue15, ARRAY_SIZE(Queue15) }
+
+#ifdef ES_QUEUE_POLICIES
+/****************************************************************************/
+// the queue policies from ES_Configure.h, and a bit for each service that
+// has any, so that the others go straight to ES_EnQueueFIFO
+
+static ES_PolicyDesc_t const PolicyList[] = { ES_QUEUE_POLICIES };
+static uint32_t PolicyServices;
 #endif
-};
 
+#ifdef ES_OVERFLOW_POLICIES
 /****************************************************************************/
-// Variable used to keep track of which queues have events in them
+// the services whose full queues push out their oldest event, and those
+// whose full queues are reported to ES_OVERFLOW_HANDLER. The rest reject
+// the post
 
-uint16_t Ready;
+static uint32_t const OverwriteServices =
+  (uint32_t)(ES_OVERFLOW_POLICIES(ES_OVERWRITE_BIT) 0);
+static uint32_t const EscalateServices =
+  (uint32_t)(ES_OVERFLOW_POLICIES(ES_ESCALATE_BIT) 0);
+#endif
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -242,13 +327,54 @@ uint16_t Ready;
 ES_Return_t ES_Initialize( TimerRate_t NewRate ){
   uint8_t i;
   ES_Timer_Init( NewRate); // start up the timer subsystem
+  ES_PoolInit(); // the buffers take their memory from the pools
+  ES_InitBuffers();
+#if defined(ES_SERVICE_STATS) || defined(ES_TRACE_SIZE)
+  _HW_CycleCounter_Init(); // run times are measured in CPU cycles
+#endif
+#ifdef ES_SERVICE_STATS
+  ES_ResetServiceStats();
+#endif
+#ifdef ES_PREEMPTIVE
+  _HW_PreemptInit(); // PendSV below every interrupt
+#endif
+#ifdef ES_WATCHDOG_MS
+  _HW_Watchdog_Init( ES_WATCHDOG_MS ); // after ES_Timer_Init, see ES_Port.c
+#endif
+#ifdef ES_QUEUE_POLICIES
+  // the policies are only for ordinary queues, not the lock-free ones
+  PolicyServices = 0;
+  for ( i=0; i< ARRAY_SIZE(PolicyList); i++) {
+    if ( (PolicyList[i].WhichService >= ARRAY_SIZE(EventQueues)) ||
+         EventQueues[PolicyList[i].WhichService].IsSPSC )
+      return FailedInit;
+    PolicyServices |= (1UL << PolicyList[i].WhichService);
+  }
+#endif
+#ifdef ES_OVERFLOW_POLICIES
+  // only an ordinary queue can have its oldest event pushed out, and an
+  // escalation needs somewhere to go
+  for ( i=0; i< ARRAY_SIZE(EventQueues); i++) {
+    if ( EventQueues[i].IsSPSC && (OverwriteServices & (1UL << i)) )
+      return FailedInit;
+  }
+#ifndef ES_OVERFLOW_HANDLER
+  if ( EscalateServices != 0 )
+    return FailedInit;
+#endif
+#endif
   // loop through the list testing for NULL pointers and
   for ( i=0; i< ARRAY_SIZE(ServDescList); i++) {
     if ( (ServDescList[i].InitFunc == (pInitFunc)0) ||
          (ServDescList[i].RunFunc == (pRunFunc)0) )
       return FailedPointer; // protect against NULL pointers
     // and initializing the event queues (must happen before running inits)  
-    ES_InitQueue( EventQueues[i].pMem, EventQueues[i].Size );
+    if ( EventQueues[i].IsSPSC ){
+      if ( ES_InitSPSCQueue( EventQueues[i].pMem, EventQueues[i].Size ) == 0 )
+        return FailedInit; // SPSC queue size is not a power of 2
+    }else{
+      ES_InitQueue( EventQueues[i].pMem, EventQueues[i].Size );
+    }
    // executing the init functions
     if ( ServDescList[i].InitFunc(i) != true )
       return FailedInit; // this is a failed initialization
@@ -269,36 +395,120 @@ ES_Return_t ES_Initialize( TimerRate_t NewRate ){
    state machine to process the event in its queue.
    while all the queues are empty, it searches for system generated or
    user generated events.
+   When the run function returns, the reference to the event's buffer (if
+   it has one) that the queue held is released.
+   With ES_TICKLESS defined, if there are none of those either it puts the
+   CPU to sleep until the next interrupt (_HW_Sleep in ES_Port.c).
+   With ES_PREEMPTIVE defined the services are run through ES_Preempt, so
+   that a service can be preempted by one of higher priority.
+   With ES_WATCHDOG_MS defined the watchdog is fed before every run function
+   and each time around the idle loop.
+   With ES_TRACE_DRAIN defined a trace record is sent each time around the
+   idle loop, and the CPU does not sleep while there are more to send.
  Notes
    this function only returns in case of an error
  Author
    J. Edward Carryer, 10/23/11,
 ****************************************************************************/
 ES_Return_t ES_Run( void ){
-  // make these static to improve speed
-  uint8_t HighestPrior;
-  static ES_Event ThisEvent;
-  
+#ifdef ES_PREEMPTIVE
+  uint32_t SavedPRIMASK;
+
+  RunFailed = false;
+  RunningPriority = BASE_PRIORITY; // from here on posts can start services
+#endif
+
   while(1){ // stay here unless we detect an error condition
 
     // loop through the list executing the run functions for services
     // with a non-empty queue. Process any pending ints before testing
     // Ready
     while( (_HW_Process_Pending_Ints()) && (Ready != 0)){
-      HighestPrior =  ES_GetMSBitSet(Ready);
-      if ( ES_DeQueue( EventQueues[HighestPrior].pMem, &ThisEvent ) == 0 ){
-        Ready &= BitNum2ClrMask[HighestPrior]; // mark queue as now empty
-      }
-      if( ServDescList[HighestPrior].RunFunc(ThisEvent).EventType != 
-                                                              ES_NO_EVENT) {
+#ifdef ES_PREEMPTIVE
+      SavedPRIMASK = CPUgetPRIMASK_cpsid();
+      ES_Preempt();
+      CPUsetPRIMASK( SavedPRIMASK );
+      if( RunFailed )
+        break;
+#else
+      if( Dispatch( ES_GetMSBitSet32(Ready) ) == false ) {
               return FailedRun;
       }
+#endif
     }
+#ifdef ES_PREEMPTIVE
+    // the run function may have failed in here or when run from PendSV
+    if( RunFailed ) {
+            RunningPriority = NOT_RUNNING;
+            return FailedRun;
+    }
+#endif
 
+#ifdef ES_WATCHDOG_MS
+    FeedWatchdog(); // nothing to run is as good as finishing on time
+#endif
+#ifdef ES_TRACE_DRAIN
+    if ( ES_TraceDrain() ){
+      ES_CheckUserEvents(); // but no sleeping with records still to send
+      continue;
+    }
+#endif
     // all the queues are empty, so look for new user detected events
+#ifdef ES_TICKLESS
+    // and if there are none, sleep until an interrupt comes along. Ready and
+    // the armed checkers are tested again with interrupts off so that an
+    // event posted, or a checker armed, by an ISR since the tests above
+    // can't be left waiting through the sleep
+    if ( ES_CheckUserEvents() == false ){
+      EnterCritical();
+      if ( (Ready == 0) && !ES_CheckersPending() )
+        _HW_Sleep();
+      ExitCritical(); // the interrupt that woke us is taken here
+    }
+#else
     ES_CheckUserEvents();
+#endif
+  }
+}
+
+#ifdef ES_PREEMPTIVE
+/****************************************************************************
+ Function
+   ES_Preempt
+ Parameters
+   None
+ Returns
+   None
+ Description
+   runs, highest priority first, every service that is ready and of higher
+   priority than the one whose run function is running, which is the one
+   that they preempt. Any of them can in turn be preempted by a service of
+   higher priority still, through PendSV.
+ Notes
+   Call with interrupts off. They are turned on around each run function
+   and are off again when this returns. PendSV (ES_Port.c) calls this in
+   thread mode, after the interrupt that made the post has returned, and
+   ES_Run calls it for everything above the idle loop. A run function that
+   fails is noted in RunFailed for ES_Run to return, since there is no one
+   else to tell.
+****************************************************************************/
+void ES_Preempt( void ){
+  int8_t Preempted = RunningPriority;
+  uint8_t HighestPrior;
+
+  while ( Ready != 0 ){
+    HighestPrior = ES_GetMSBitSet32(Ready);
+    if ( (int8_t)HighestPrior <= Preempted )
+      break; // the rest wait for the service that was preempted
+    RunningPriority = HighestPrior;
+    CPUsetPRIMASK( 0 );
+    if ( Dispatch( HighestPrior ) == false )
+      RunFailed = true;
+    CPUgetPRIMASK_cpsid();
   }
+  RunningPriority = Preempted;
 }
+#endif
 
 /****************************************************************************
  Function
@@ -310,26 +520,141 @@ ES_Return_t ES_Run( void ){
  Description
    posts to all of the services' queues 
  Notes
+   each queued copy of the event holds its own reference to the buffer
+   attached by ES_PostWithBuffer. Posted as one batch (see ES_Multicast),
+   so a full queue no longer stops the post to the services after it
 
  Author
    J. Edward Carryer, 01/15/12,
 ****************************************************************************/
 bool ES_PostAll( ES_Event ThisEvent){
+  return ES_PostMulti( ALL_SERVICES, ThisEvent );
+}
+
+/****************************************************************************
+ Function
+   ES_PostMulti
+ Parameters
+   uint32_t : the services to post to, bit n for service n
+   ES_Event : The Event to be posted
+ Returns
+   boolean : False if any of the services didn't take it, or isn't there
+ Description
+   posts the same event to a set of services as one batch (ES_Multicast)
+****************************************************************************/
+bool ES_PostMulti( uint32_t Services, ES_Event ThisEvent ){
+  return ( ES_Multicast( Services, ThisEvent ) == 0 );
+}
 
+/****************************************************************************
+ Function
+   ES_Multicast
+ Parameters
+   uint32_t : the services to post to, bit n for service n, e.g. the
+              ES_DIST_MASKn of a distribution list
+   ES_Event : The Event to be posted
+ Returns
+   uint32_t : the services that didn't take it, 0 if they all did
+ Description
+   posts the same event to a set of services in one pass over their bits,
+   as one batch: interrupts are off while it goes into each queue, and the
+   services are marked ready together at the end. A full queue doesn't stop
+   the post to the others
+ Notes
+   each queued copy of the event holds its own reference to the buffer
+   attached by ES_PostWithBuffer. Bits for services that don't exist come
+   back set
+****************************************************************************/
+uint32_t ES_Multicast( uint32_t Services, ES_Event ThisEvent ){
+  uint32_t SavedPRIMASK;
+  uint32_t Dropped = Services & ~ALL_SERVICES;
+  uint32_t ToPost = Services & ALL_SERVICES;
   uint8_t i;
-  // loop through the list executing the post functions
-  for ( i=0; i< ARRAY_SIZE(EventQueues); i++) {
-    if ( ES_EnQueueFIFO( EventQueues[i].pMem, ThisEvent ) != true ){
-      break; // this is a failed post
-    }else{
-      Ready |= BitNum2SetMask[i]; // show queue as non-empty
-    }
+
+  ThisEvent.Buffer = PostingBuffer;
+  SavedPRIMASK = ES_BeginPostBatch();
+  while ( ToPost != 0 ){
+    i = ES_GetMSBitSet32( ToPost );
+    ToPost &= ~(1UL << i);
+    if ( EnQueue( i, ThisEvent ) != true )
+      Dropped |= (1UL << i);
   }
-  if ( i == ARRAY_SIZE(EventQueues) ){ // if no failures
-    return (true);
-  }else{
-    return(false);
+  ES_EndPostBatch( SavedPRIMASK );
+  return Dropped;
+}
+
+/****************************************************************************
+ Function
+   ES_PostBatch
+ Parameters
+   const ES_PostEntry_t * : the posts to make, each a service and an event
+   uint8_t : how many of them there are
+ Returns
+   boolean : False if any of the posts failed
+ Description
+   makes a set of posts as one batch, in order: no interrupt can come in
+   between them, and the services are marked ready together at the end so
+   that none of them runs (ES_PREEMPTIVE) before all have been posted
+ Notes
+   a failed post doesn't stop the ones after it
+****************************************************************************/
+bool ES_PostBatch( const ES_PostEntry_t *pPosts, uint8_t NumPosts ){
+  uint32_t SavedPRIMASK;
+  bool ReturnVal = true;
+  uint8_t i;
+
+  SavedPRIMASK = ES_BeginPostBatch();
+  for ( i=0; i< NumPosts; i++) {
+    if ( ES_PostToService( pPosts[i].WhichService, pPosts[i].Event ) != true )
+      ReturnVal = false;
   }
+  ES_EndPostBatch( SavedPRIMASK );
+  return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+   ES_BeginPostBatch
+ Parameters
+   None
+ Returns
+   uint32_t : the interrupt mask to hand to ES_EndPostBatch
+ Description
+   turns interrupts off and starts holding back the Ready bits of the
+   services posted to, until the matching ES_EndPostBatch
+ Notes
+   batches may be nested, the services are marked ready when the outermost
+   one ends. Keep the posts in between short, interrupts are off
+****************************************************************************/
+uint32_t ES_BeginPostBatch( void ){
+  // not EnterCritical, the queue functions use that
+  uint32_t SavedPRIMASK = CPUgetPRIMASK_cpsid();
+
+  BatchDepth++;
+  return SavedPRIMASK;
+}
+
+/****************************************************************************
+ Function
+   ES_EndPostBatch
+ Parameters
+   uint32_t : what the matching ES_BeginPostBatch returned
+ Returns
+   None
+ Description
+   ends a batch of posts, marking the services that were posted to as ready
+   in one go if it is the outermost batch, and puts the interrupt mask back
+****************************************************************************/
+void ES_EndPostBatch( uint32_t SavedPRIMASK ){
+  if ( (--BatchDepth == 0) && (BatchReady != 0) ){
+    Ready |= BatchReady;
+#ifdef ES_PREEMPTIVE
+    if ( (int8_t)ES_GetMSBitSet32(BatchReady) > RunningPriority )
+      _HW_PendSV();
+#endif
+    BatchReady = 0;
+  }
+  CPUsetPRIMASK( SavedPRIMASK );
 }
 
 /****************************************************************************
@@ -344,16 +669,16 @@ bool ES_PostAll( ES_Event ThisEvent){
    posts to one of the services' queues
  Notes
    used by the timer library to associate a timer with a state machine
+   The event only carries a buffer when posted through ES_PostWithBuffer,
+   so to pass a buffer on use that rather than posting ThisEvent again.
  Author
    J. Edward Carryer, 01/16/12,
 ****************************************************************************/
 bool ES_PostToService( uint8_t WhichService, ES_Event TheEvent){
-  if ((WhichService < ARRAY_SIZE(EventQueues)) &&
-      (ES_EnQueueFIFO( EventQueues[WhichService].pMem, TheEvent) == 
-                                                                true )){
-    Ready |= BitNum2SetMask[WhichService]; // show queue as non-empty
-    return true;
-  } else
+  TheEvent.Buffer = PostingBuffer;
+  if (WhichService < ARRAY_SIZE(EventQueues))
+    return EnQueue( WhichService, TheEvent );
+  else
     return false;
 }
 
@@ -368,23 +693,540 @@ bool ES_PostToService( uint8_t WhichService, ES_Event TheEvent){
  Description
    Posts, using LIFO strategy, to one of the services' queues
  Notes
-   used by the Defer/Recall event capability
+   used by the Defer/Recall event capability. Always fails for a service
+   with an SPSC queue. The event keeps its buffer, with the reference that
+   the deferral queue held passing to the service's queue
  Author
    J. Edward Carryer, 11/02/13
 ****************************************************************************/
 bool ES_PostToServiceLIFO( uint8_t WhichService, ES_Event TheEvent){
   if ((WhichService < ARRAY_SIZE(EventQueues)) &&
+      (EventQueues[WhichService].IsSPSC == false) &&
       (ES_EnQueueLIFO( EventQueues[WhichService].pMem, TheEvent) == 
                                                                 true )){
-    Ready |= BitNum2SetMask[WhichService]; // show queue as non-empty
+    MarkReady( WhichService ); // show queue as non-empty
+#ifdef ES_SERVICE_STATS
+    NotePosted(WhichService);
+#endif
+    ES_TRACE( ES_TRACE_POST, WhichService, ES_TRACE_EVENT(TheEvent) );
     return true;
-  } else
+  } else {
+#ifdef ES_SERVICE_STATS
+    if (WhichService < ARRAY_SIZE(EventQueues))
+      NoteRejected(WhichService);
+#endif
+    ES_TRACE( ES_TRACE_REJECT, WhichService, ES_TRACE_EVENT(TheEvent) );
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_PostWithBuffer
+ Parameters
+   pPostFunc : the post function to use, e.g. PostDOG_SM or ES_PostList00
+   ES_Event : The Event to be posted
+   ES_BufHandle_t : the buffer to go with it
+ Returns
+   boolean : whatever the post function returned
+ Description
+   posts an event that carries a packet buffer. Each queue that the event
+   is posted to takes a reference to the buffer, which ES_Run releases
+   once the service's run function has returned, so the caller still has
+   to release its own reference.
+ Notes
+   interrupts are off while the post function runs, so that no post from
+   an ISR can pick up the buffer
+****************************************************************************/
+bool ES_PostWithBuffer( pPostFunc PostFunc, ES_Event ThisEvent,
+                        ES_BufHandle_t Buffer ){
+  uint32_t SavedPRIMASK;
+  bool ReturnVal;
+
+  SavedPRIMASK = CPUgetPRIMASK_cpsid();
+  PostingBuffer = Buffer;
+  ReturnVal = PostFunc( ThisEvent );
+  PostingBuffer = ES_NO_BUFFER;
+  CPUsetPRIMASK( SavedPRIMASK );
+  return ReturnVal;
+}
+
+#ifdef ES_SERVICE_STATS
+/****************************************************************************
+ Function
+   ES_GetServiceStats
+ Parameters
+   uint8_t : Which service (index into ServDescList)
+   ES_ServiceStats_t * : where to put a copy of its statistics
+ Returns
+   boolean : False if there is no such service
+ Description
+   takes a consistent snapshot of one service's statistics
+ Notes
+   run times are in CPU cycles and include any interrupts taken while the
+   run function was executing, and with ES_PREEMPTIVE any services that
+   preempted it
+****************************************************************************/
+bool ES_GetServiceStats( uint8_t WhichService, ES_ServiceStats_t *pStats ){
+  ES_ServStats_t Snapshot;
+
+  if (WhichService >= ARRAY_SIZE(ServStats))
     return false;
+
+  EnterCritical();
+  Snapshot = ServStats[WhichService];
+  ExitCritical();
+
+  pStats->Dispatches = Snapshot.Dispatches;
+  pStats->MinRunTime = (Snapshot.Dispatches != 0) ? Snapshot.MinRunTime : 0;
+  pStats->AvgRunTime = (Snapshot.Dispatches != 0) ?
+              (uint32_t)(Snapshot.TotalRunTime / Snapshot.Dispatches) : 0;
+  pStats->MaxRunTime = Snapshot.MaxRunTime;
+  pStats->RejectedPosts = Snapshot.RejectedPosts;
+  pStats->Coalesced = Snapshot.Coalesced;
+  pStats->Overwritten = Snapshot.Overwritten;
+  pStats->Escalated = Snapshot.Escalated;
+#ifdef ES_RUN_BUDGETS
+  pStats->Budget = Budgets[WhichService];
+#else
+  pStats->Budget = 0;
+#endif
+  pStats->Overruns = Snapshot.Overruns;
+  pStats->OverrunEvent = Snapshot.OverrunEvent;
+  pStats->HighWater = Snapshot.HighWater;
+  pStats->Needed = Snapshot.Needed;
+  pStats->QueueSize = EventQueues[WhichService].Size - 1;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_ResetServiceStats
+ Parameters
+   None
+ Returns
+   None
+ Description
+   zeroes the statistics for all of the services
+ Notes
+   the high water marks and the queue sizes needed start again from the
+   current queue depths
+****************************************************************************/
+void ES_ResetServiceStats( void ){
+  uint8_t i;
+
+  for ( i=0; i< ARRAY_SIZE(ServStats); i++) {
+    EnterCritical();
+    ServStats[i].Dispatches = 0;
+    ServStats[i].MinRunTime = UINT32_MAX;
+    ServStats[i].MaxRunTime = 0;
+    ServStats[i].TotalRunTime = 0;
+    ServStats[i].RejectedPosts = 0;
+    ServStats[i].Coalesced = 0;
+    ServStats[i].Overwritten = 0;
+    ServStats[i].Escalated = 0;
+    ServStats[i].Overruns = 0;
+    ServStats[i].OverrunEvent = ES_NO_EVENT;
+    ServStats[i].OverrunsInARow = 0;
+    ServStats[i].HighWater = NumEntries(i);
+    ServStats[i].Unqueued = 0;
+    ServStats[i].Needed = ServStats[i].HighWater;
+    ExitCritical();
+  }
 }
 
+/****************************************************************************
+ Function
+   ES_PrintServiceStats
+ Parameters
+   None
+ Returns
+   None
+ Description
+   prints a table of the statistics for all of the services on the
+   console (the debug UART)
+ Notes
+
+****************************************************************************/
+void ES_PrintServiceStats( void ){
+  uint8_t i;
+  ES_ServiceStats_t Stats;
+
+  printf("Svc Dispatches   Min cyc   Avg cyc   Max cyc Queue Need Rejected"
+         " Escalated Overwrote Coalesced  Budget cyc Overruns Event\r\n");
+  for ( i=0; i< ARRAY_SIZE(ServStats); i++) {
+    ES_GetServiceStats( i, &Stats );
+    printf("%2u  %10lu %9lu %9lu %9lu %2u/%-2u %4u %8lu %9lu %9lu %9lu %11lu"
+           " %8lu %5u\r\n",
+           (unsigned)i,
+           (unsigned long)Stats.Dispatches, (unsigned long)Stats.MinRunTime,
+           (unsigned long)Stats.AvgRunTime, (unsigned long)Stats.MaxRunTime,
+           (unsigned)Stats.HighWater, (unsigned)Stats.QueueSize,
+           (unsigned)Stats.Needed, (unsigned long)Stats.RejectedPosts,
+           (unsigned long)Stats.Escalated, (unsigned long)Stats.Overwritten,
+           (unsigned long)Stats.Coalesced, (unsigned long)Stats.Budget,
+           (unsigned long)Stats.Overruns, (unsigned)Stats.OverrunEvent);
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_DumpServiceStats
+ Parameters
+   None
+ Returns
+   None
+ Description
+   writes the statistics for all of the services to the console (the
+   debug UART) as one binary record, for capture by a program on the PC
+   such as Host/QueueSizer.c
+ Notes
+   The record is
+     0x7E, version (5), number of services,
+     then for each service, in priority order:
+       Dispatches, MinRunTime, AvgRunTime, MaxRunTime, RejectedPosts,
+         Coalesced, Budget, Overruns (4 bytes each, least significant
+         byte first), OverrunEvent (1 byte),
+       HighWater, Needed, QueueSize (1 byte each),
+       Overwritten, Escalated (4 bytes each)
+     then a checksum: 0xFF minus the 8 bit sum of the bytes after the 0x7E
+****************************************************************************/
+void ES_DumpServiceStats( void ){
+  uint8_t i;
+  uint8_t Sum;
+  ES_ServiceStats_t Stats;
+
+  TERMIO_PutChar(STATS_DUMP_START);
+  Sum = DumpWord( STATS_DUMP_VERSION, 0, 1 );
+  Sum = DumpWord( ARRAY_SIZE(ServStats), Sum, 1 );
+  for ( i=0; i< ARRAY_SIZE(ServStats); i++) {
+    ES_GetServiceStats( i, &Stats );
+    Sum = DumpWord( Stats.Dispatches, Sum, 4 );
+    Sum = DumpWord( Stats.MinRunTime, Sum, 4 );
+    Sum = DumpWord( Stats.AvgRunTime, Sum, 4 );
+    Sum = DumpWord( Stats.MaxRunTime, Sum, 4 );
+    Sum = DumpWord( Stats.RejectedPosts, Sum, 4 );
+    Sum = DumpWord( Stats.Coalesced, Sum, 4 );
+    Sum = DumpWord( Stats.Budget, Sum, 4 );
+    Sum = DumpWord( Stats.Overruns, Sum, 4 );
+    Sum = DumpWord( Stats.OverrunEvent, Sum, 1 );
+    Sum = DumpWord( Stats.HighWater, Sum, 1 );
+    Sum = DumpWord( Stats.Needed, Sum, 1 );
+    Sum = DumpWord( Stats.QueueSize, Sum, 1 );
+    Sum = DumpWord( Stats.Overwritten, Sum, 4 );
+    Sum = DumpWord( Stats.Escalated, Sum, 4 );
+  }
+  TERMIO_PutChar(0xFF - Sum);
+}
+#endif
+
 //*********************************
 // private functions
 //*********************************
+// adds the event to the end of a service's queue and marks it as ready. The
+// queued event takes a reference to its buffer, if it has one
+static bool EnQueue( uint8_t WhichService, ES_Event TheEvent ){
+  bool Posted;
+
+  if ( (TheEvent.Buffer != ES_NO_BUFFER) &&
+       (ES_BufRetain( TheEvent.Buffer ) == false) )
+    Posted = false; // not a buffer that can be handed on
+  else{
+    if ( EventQueues[WhichService].IsSPSC )
+      Posted = ES_EnQueueSPSC( EventQueues[WhichService].pMem, TheEvent );
+#ifdef ES_QUEUE_POLICIES
+    else if ( PolicyServices & (1UL << WhichService) )
+      Posted = EnQueueWithPolicy( WhichService, TheEvent );
+#endif
+    else
+      Posted = ES_EnQueueFIFO( EventQueues[WhichService].pMem, TheEvent );
+#ifdef ES_OVERFLOW_POLICIES
+    if ( Posted == false )
+      Posted = Overflow( WhichService, TheEvent ); // the queue was full
+#endif
+    if ( Posted )
+      MarkReady( WhichService ); // show queue as non-empty
+    else if ( TheEvent.Buffer != ES_NO_BUFFER )
+      ES_BufRelease( TheEvent.Buffer );
+  }
+#ifdef ES_SERVICE_STATS
+  if ( Posted )
+    NotePosted(WhichService);
+  else
+    NoteRejected(WhichService);
+#endif
+  ES_TRACE( Posted ? ES_TRACE_POST : ES_TRACE_REJECT, WhichService,
+            ES_TRACE_EVENT(TheEvent) );
+  return Posted;
+}
+
+// sets a service's bit in Ready, or in BatchReady while a batch is open.
+// With ES_PREEMPTIVE, if the service is of higher priority than the run
+// function that is running, PendSV runs it as soon as the poster returns
+// from its interrupt or turns interrupts back on
+static void MarkReady( uint8_t WhichService ){
+  if ( BatchDepth != 0 ){
+    BatchReady |= (1UL << WhichService);
+    return;
+  }
+  ES_AtomicSetBit( &Ready, WhichService );
+#ifdef ES_PREEMPTIVE
+  if ( (int8_t)WhichService > RunningPriority )
+    _HW_PendSV();
+#endif
+}
+
+// takes the next event from a service's queue and runs the service's run
+// function with it, returning false if the run function failed. Call with
+// the service's bit set in Ready
+static bool Dispatch( uint8_t WhichService ){
+  ES_Event ThisEvent;
+  ES_Event RunResult;
+#ifdef ES_SERVICE_STATS
+  uint32_t RunStart;
+#endif
+
+  if ( DeQueue( WhichService, &ThisEvent ) == 0 ){
+    ES_AtomicClrBit( &Ready, WhichService ); // mark queue as now empty
+    // unless an interrupt posted to it since we emptied it
+    if ( NumEntries( WhichService ) != 0 )
+      ES_AtomicSetBit( &Ready, WhichService );
+#ifdef ES_SERVICE_STATS
+    // the rejected posts would have come off a bigger queue after the rest,
+    // so they are taken as gone by the time this one is empty. That makes
+    // Needed an underestimate if the posts keep coming
+    ServStats[WhichService].Unqueued = 0;
+#endif
+  }
+#ifdef ES_WATCHDOG_MS
+  FeedWatchdog(); // this run function gets the whole watchdog period
+#endif
+  ES_TRACE( ES_TRACE_BEGIN, WhichService, ES_TRACE_EVENT(ThisEvent) );
+#ifdef ES_SERVICE_STATS
+  RunStart = _HW_GetCycleCount();
+  RunResult = ServDescList[WhichService].RunFunc(ThisEvent);
+  NoteDispatched( WhichService, _HW_GetCycleCount() - RunStart,
+                  ThisEvent.EventType );
+#else
+  RunResult = ServDescList[WhichService].RunFunc(ThisEvent);
+#endif
+  ES_TRACE( ES_TRACE_END, WhichService, RunResult.EventType );
+  // the queue's reference to the event's buffer goes with the event
+  if( ThisEvent.Buffer != ES_NO_BUFFER )
+    ES_BufRelease( ThisEvent.Buffer );
+  return ( RunResult.EventType == ES_NO_EVENT );
+}
+
+#ifdef ES_WATCHDOG_MS
+// restarts the watchdog's count, unless a service has gone over its budget
+// too many times in a row (ES_OVERRUN_LIMIT), in which case it is left to
+// reset the MCU
+static void FeedWatchdog( void ){
+#ifdef ES_OVERRUN_LIMIT
+  if ( OverLimit != 0 )
+    return;
+#endif
+  _HW_Watchdog_Feed();
+}
+#endif
+
+#ifdef ES_QUEUE_POLICIES
+// adds the event to a service's queue according to the policy for its type.
+// An event that the policy displaced no longer needs its buffer reference
+static bool EnQueueWithPolicy( uint8_t WhichService, ES_Event TheEvent ){
+  ES_QueuePolicy_t Policy = ES_QUEUE_FIFO;
+  ES_Event Displaced;
+  bool Posted;
+  uint8_t i;
+
+  for ( i=0; i< ARRAY_SIZE(PolicyList); i++) {
+    if ( (PolicyList[i].WhichService == WhichService) &&
+         (PolicyList[i].EventType == TheEvent.EventType) ) {
+      Policy = PolicyList[i].Policy;
+      break;
+    }
+  }
+  Posted = ES_EnQueuePolicy( EventQueues[WhichService].pMem, TheEvent,
+                             Policy, &Displaced );
+  if ( Displaced.EventType != ES_NO_EVENT ){
+    ES_BufRelease( Displaced.Buffer );
+#ifdef ES_SERVICE_STATS
+    NoteCoalesced(WhichService);
+#endif
+  }
+  return Posted;
+}
+#endif
+
+#ifdef ES_OVERFLOW_POLICIES
+// deals with an event that found a service's queue full, according to the
+// service's policy in ES_OVERFLOW_POLICIES. Returns true if the event went
+// in after all. The handler is called with the event's buffer still held,
+// so it can look at the data but must not keep the buffer
+static bool Overflow( uint8_t WhichService, ES_Event TheEvent ){
+  ES_Event Displaced;
+
+  if ( OverwriteServices & (1UL << WhichService) ){
+    if ( ES_EnQueuePolicy( EventQueues[WhichService].pMem, TheEvent,
+                           ES_QUEUE_DROP_HEAD, &Displaced ) == false )
+      return false;
+    // the run function may have made room in the meantime
+    if ( Displaced.EventType != ES_NO_EVENT ){
+      ES_BufRelease( Displaced.Buffer );
+#ifdef ES_SERVICE_STATS
+      NoteOverwritten(WhichService);
+#endif
+    }
+    return true;
+  }
+#ifdef ES_OVERFLOW_HANDLER
+  if ( EscalateServices & (1UL << WhichService) ){
+#ifdef ES_SERVICE_STATS
+    NoteEscalated(WhichService);
+#endif
+    ES_OVERFLOW_HANDLER( WhichService, TheEvent );
+  }
+#endif
+  return false;
+}
+#endif
+
+// takes the next event from a service's queue, returning how many are left
+static uint8_t DeQueue( uint8_t WhichService, ES_Event *pReturnEvent ){
+  if ( EventQueues[WhichService].IsSPSC )
+    return ES_DeQueueSPSC( EventQueues[WhichService].pMem, pReturnEvent );
+  else
+    return ES_DeQueue( EventQueues[WhichService].pMem, pReturnEvent );
+}
+
+static uint8_t NumEntries( uint8_t WhichService ){
+  if ( EventQueues[WhichService].IsSPSC )
+    return ES_SPSCQueueNumEntries( EventQueues[WhichService].pMem );
+  else
+    return ES_QueueNumEntries( EventQueues[WhichService].pMem );
+}
+
+#ifdef ES_SERVICE_STATS
+// called after a successful post, from task or interrupt level. An SPSC
+// queue has only the one producer, so its counts need no lock
+static void NotePosted( uint8_t WhichService ){
+  if ( EventQueues[WhichService].IsSPSC ){
+    NoteDepth( WhichService, false );
+  }else{
+    EnterCritical();
+    NoteDepth( WhichService, false );
+    ExitCritical();
+  }
+}
+
+// called when a post found the queue full
+static void NoteRejected( uint8_t WhichService ){
+  if ( EventQueues[WhichService].IsSPSC ){
+    ServStats[WhichService].RejectedPosts++;
+    NoteDepth( WhichService, true );
+  }else{
+    EnterCritical();
+    ServStats[WhichService].RejectedPosts++;
+    NoteDepth( WhichService, true );
+    ExitCritical();
+  }
+}
+
+// updates the high water mark, and the queue size needed: the depth that the
+// queue would have if it had taken the posts that it rejected since it was
+// last empty
+static void NoteDepth( uint8_t WhichService, bool Rejected ){
+  ES_ServStats_t *pStats = &ServStats[WhichService];
+  uint16_t Depth = NumEntries( WhichService );
+
+  if ( Depth > pStats->HighWater )
+    pStats->HighWater = Depth;
+  if ( Rejected && (pStats->Unqueued != UINT8_MAX) )
+    pStats->Unqueued++;
+  Depth += pStats->Unqueued;
+  if ( Depth > UINT8_MAX )
+    Depth = UINT8_MAX;
+  if ( Depth > pStats->Needed )
+    pStats->Needed = Depth;
+}
+
+// called when a queue policy merged, replaced or pushed out an event. The
+// policies are only used with ordinary queues, so this always locks
+static void NoteCoalesced( uint8_t WhichService ){
+  EnterCritical();
+  ServStats[WhichService].Coalesced++;
+  ExitCritical();
+}
+
+// called when a full queue pushed out its oldest event. That event counts as
+// rejected for the queue size needed. Only ordinary queues overwrite
+static void NoteOverwritten( uint8_t WhichService ){
+  EnterCritical();
+  ServStats[WhichService].Overwritten++;
+  NoteDepth( WhichService, true );
+  ExitCritical();
+}
+
+// called before a post that found the queue full goes to
+// ES_OVERFLOW_HANDLER. NoteRejected counts it as well
+static void NoteEscalated( uint8_t WhichService ){
+  if ( EventQueues[WhichService].IsSPSC ){
+    ServStats[WhichService].Escalated++;
+  }else{
+    EnterCritical();
+    ServStats[WhichService].Escalated++;
+    ExitCritical();
+  }
+}
+
+// called by Dispatch after each run function returns, with the type of the
+// event that it ran with. Only the dispatch of the service itself writes
+// these fields, and a service never preempts itself, so there is no need to
+// lock them
+static void NoteDispatched( uint8_t WhichService, uint32_t RunTime,
+                            ES_EventTyp_t EventType ){
+  ES_ServStats_t *pStats = &ServStats[WhichService];
+
+  pStats->Dispatches++;
+  pStats->TotalRunTime += RunTime;
+  if ( RunTime < pStats->MinRunTime )
+    pStats->MinRunTime = RunTime;
+  if ( RunTime > pStats->MaxRunTime )
+    pStats->MaxRunTime = RunTime;
+#ifdef ES_RUN_BUDGETS
+  if ( Budgets[WhichService] == 0 )
+    return; // no budget to keep to
+  if ( RunTime > Budgets[WhichService] ){
+    pStats->Overruns++;
+    pStats->OverrunEvent = EventType;
+    if ( pStats->OverrunsInARow != UINT8_MAX )
+      pStats->OverrunsInARow++;
+#ifdef ES_OVERRUN_LIMIT
+    if ( pStats->OverrunsInARow >= ES_OVERRUN_LIMIT )
+      ES_AtomicSetBit( &OverLimit, WhichService );
+#endif
+  }else{
+    pStats->OverrunsInARow = 0;
+#ifdef ES_OVERRUN_LIMIT
+    ES_AtomicClrBit( &OverLimit, WhichService ); // it has recovered
+#endif
+  }
+#else
+  (void)EventType;
+#endif
+}
+
+// sends the low NumBytes of Word, LSB first, returning the updated sum
+static uint8_t DumpWord( uint32_t Word, uint8_t Sum, uint8_t NumBytes ){
+  while ( NumBytes-- > 0 ){
+    TERMIO_PutChar( (uint8_t)Word );
+    Sum += (uint8_t)Word;
+    Word >>= 8;
+  }
+  return Sum;
+}
+#endif
+
 #if 0
 /****************************************************************************
  Function
@@ -0,0 +1,224 @@
+/****************************************************************************
+ Module
+     ES_HSM.c
+
+ Description
+     This is a module implementing hierarchical state machines from const
+     tables (ES_HSM.h), so that a service's run function only has to hand
+     its events to ES_HSMDispatch, and the entry and exit actions of a state
+     are written once instead of in every case that leads into or out of it.
+
+ Notes
+     An event is looked up in the transition table of the current (leaf)
+     state first and then in those of its superstates, outermost last. The
+     state whose table has the transition is its source.
+     Taking a transition to a target state:
+       - exits the states from the current one up to, but not including,
+         the innermost state that holds both the source and the target
+         (counting a state as holding itself). A transition from a state to
+         itself leaves it and comes back in, running its exit and entry.
+       - runs the transition's action
+       - enters the states from there down to the target, outermost first,
+         and then the target's initial substates, down to a leaf
+     So a transition from a superstate to one of its substates, or back up
+     to the superstate, does not leave the superstate.
+     An internal transition (no target) only runs its action.
+     The tables are const, so they stay in flash on the target, and the
+     machine itself is the one pointer in ES_HSM_t.
+     A target nested deeper than ES_HSM_MAX_DEPTH is a mistake in the
+     tables, which would leave outer entry actions unrun, so entering one
+     stops the machine dead (TooDeep) rather than carrying on.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                trap a target nested deeper than ES_HSM_MAX_DEPTH
+ 10/17/26                started coding
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_General.h"
+#include "ES_HSM.h"
+#include "ES_Trace.h"
+#if defined(host)
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+/*--------------------------- External Variables --------------------------*/
+
+/*----------------------------- Module Defines ----------------------------*/
+
+/*------------------------------ Module Types -----------------------------*/
+
+/*---------------------------- Module Functions ---------------------------*/
+static bool Holds( const ES_HSMState_t *pOuter, const ES_HSMState_t *pState );
+static void EnterFrom( ES_HSM_t *pMachine, const ES_HSMState_t *pOuter,
+                       const ES_HSMState_t *pTarget );
+static void TooDeep( const ES_HSMState_t *pTarget );
+
+/*---------------------------- Module Variables ---------------------------*/
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_HSMStart
+ Parameters
+   ES_HSM_t * : the machine
+   const ES_HSMState_t * : the state to start in
+ Returns
+   None
+ Description
+   enters the state, running the entry actions of its superstates and then
+   its own, and goes on into its initial substates
+ Notes
+   call from the run function (on ES_INIT) rather than the init function
+   if the entry actions post to other services, whose queues are not set
+   up until their turn in ES_Initialize
+****************************************************************************/
+void ES_HSMStart( ES_HSM_t *pMachine, const ES_HSMState_t *pState )
+{
+  EnterFrom( pMachine, NULL, pState );
+}
+
+/****************************************************************************
+ Function
+   ES_HSMDispatch
+ Parameters
+   ES_HSM_t * : the machine
+   ES_Event : the event to process
+ Returns
+   bool : true if a transition was taken, false if the event was ignored
+ Description
+   finds the transition for the event in the current state or its
+   superstates and takes it, see the notes at the top of this file
+ Notes
+   the actions of the transition must not dispatch events to the same
+   machine
+****************************************************************************/
+bool ES_HSMDispatch( ES_HSM_t *pMachine, ES_Event ThisEvent )
+{
+  const ES_HSMState_t *pSource;
+  const ES_HSMState_t *pOuter;
+  const ES_HSMState_t *pState;
+  const ES_HSMTransition_t *pTran = NULL;
+  uint8_t i;
+
+  // the innermost state with a transition for the event
+  for ( pSource = pMachine->pCurrent; pSource != NULL;
+        pSource = pSource->pParent ){
+    for ( i = 0; i < pSource->NumTransitions; i++ ){
+      pTran = &pSource->pTransitions[i];
+      if ( (pTran->EventType == ThisEvent.EventType) &&
+           ((pTran->Guard == NULL) || pTran->Guard( ThisEvent )) )
+        break;
+    }
+    if ( i < pSource->NumTransitions )
+      break;
+  }
+  if ( pSource == NULL )
+    return false; // not started, or no state wants the event
+
+  if ( pTran->pTarget == NULL ){
+    if ( pTran->Action != NULL )
+      pTran->Action( ThisEvent );
+    return true;
+  }
+
+  // the innermost state that holds both ends stays as it is
+  if ( pTran->pTarget == pSource )
+    pOuter = pSource->pParent;
+  else
+    for ( pOuter = pSource; (pOuter != NULL) &&
+          !Holds( pOuter, pTran->pTarget ); pOuter = pOuter->pParent )
+      ;
+
+  for ( pState = pMachine->pCurrent; pState != pOuter;
+        pState = pState->pParent ){
+    if ( pState->Exit != NULL )
+      pState->Exit();
+  }
+  if ( pTran->Action != NULL )
+    pTran->Action( ThisEvent );
+  EnterFrom( pMachine, pOuter, pTran->pTarget );
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_HSMIsIn
+ Parameters
+   const ES_HSM_t * : the machine
+   const ES_HSMState_t * : a state
+ Returns
+   bool : true if the machine is in the state or one of its substates
+ Description
+   for code that cares about a superstate rather than the leaf state
+ Notes
+
+****************************************************************************/
+bool ES_HSMIsIn( const ES_HSM_t *pMachine, const ES_HSMState_t *pState )
+{
+  return (pMachine->pCurrent != NULL) && Holds( pState, pMachine->pCurrent );
+}
+
+/*---------------------------- Private Functions --------------------------*/
+// true if pState is pOuter or one of its substates
+static bool Holds( const ES_HSMState_t *pOuter, const ES_HSMState_t *pState )
+{
+  for ( ; pState != NULL; pState = pState->pParent ){
+    if ( pState == pOuter )
+      return true;
+  }
+  return false;
+}
+
+// enters the states from inside pOuter (which is already entered, NULL for
+// none) down to pTarget, outermost first, then pTarget's initial substates,
+// and leaves the machine in the leaf that that ends at
+static void EnterFrom( ES_HSM_t *pMachine, const ES_HSMState_t *pOuter,
+                       const ES_HSMState_t *pTarget )
+{
+  const ES_HSMState_t *Path[ES_HSM_MAX_DEPTH];
+  const ES_HSMState_t *pState;
+  uint8_t Depth = 0;
+
+  for ( pState = pTarget; pState != pOuter; pState = pState->pParent ){
+    if ( Depth == ARRAY_SIZE(Path) )
+      TooDeep( pTarget );
+    Path[Depth++] = pState;
+  }
+  while ( Depth > 0 ){
+    pTarget = Path[--Depth];
+    if ( pTarget->Entry != NULL )
+      pTarget->Entry();
+  }
+  while ( pTarget->pInitial != NULL ){
+    pTarget = pTarget->pInitial;
+    if ( pTarget->Entry != NULL )
+      pTarget->Entry();
+  }
+  pMachine->pCurrent = pTarget;
+}
+
+// the tables nest pTarget deeper than ES_HSM_MAX_DEPTH. Sends out whatever
+// is in the trace, then stops with the system state preserved for a
+// debugger, as HardFault_Handler does
+static void TooDeep( const ES_HSMState_t *pTarget )
+{
+#ifdef ES_TRACE_SIZE
+  ES_TraceDump();
+#endif
+#if defined(host)
+  printf("ES_HSM: state %u is nested deeper than ES_HSM_MAX_DEPTH\n",
+         (unsigned)pTarget->Id);
+  abort();
+#else
+  (void)pTarget;
+  for (;;)
+    ;
+#endif
+}
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
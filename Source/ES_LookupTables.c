@@ -18,6 +18,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                added the ES_GetMSBitSet32 fallback for compilers
+                         without a CLZ intrinsic
  10/20/13 17:03 jec      converted Byte2MSBitNum array to a Nybble sized array
                          (15 entries) and made function GetMSBitSet() to figure 
                          out the MSB set. This was done to facilitate moving to
@@ -33,6 +35,7 @@
 #include "ES_Types.h"
 #include "ES_General.h"
 #include "ES_Timers.h"
+#include "ES_LookupTables.h"
 #include "bitdefs.h"
 
 /*----------------------------- Module Defines ----------------------------*/
@@ -99,6 +102,15 @@ uint8_t ES_GetMSBitSet( uint16_t Val2Check) {
   return ReturnVal;  
 }
 
+#ifndef ES_CLZ
+uint8_t ES_GetMSBitSet32( uint32_t Val2Check) {
+  if ( (Val2Check >> 16) != 0 )
+    return ES_GetMSBitSet( (uint16_t)(Val2Check >> 16) ) + 16;
+  else
+    return ES_GetMSBitSet( (uint16_t)Val2Check );
+}
+#endif
+
 /***************************************************************************
  private functions
  ***************************************************************************/
@@ -0,0 +1,332 @@
+/****************************************************************************
+ Module
+     ES_Pool.c
+
+ Description
+     This is a module implementing fixed block memory pools for the Events
+     and Services framework. Each pool hands out blocks of one size, and
+     there can be several pools of different sizes (size classes), set up in
+     ES_Configure.h. A request is served from the smallest pool whose blocks
+     are big enough.
+
+ Notes
+     Allocating and freeing a block take the same short time no matter how
+     many blocks are in use: the free blocks of each pool are kept in a list
+     linked through their first word. Looking for the pool to use is a walk
+     over the ES_NUM_POOLS pools, which is fixed when the code is built.
+     A request is never served from a larger pool when its own pool is empty,
+     so the pool a block comes from only depends on the size asked for, and
+     the statistics for each pool describe exactly the requests of that size
+     class. The high water marks and failure counts are there so that the
+     number of blocks in each pool can be set from measurements.
+     All of the functions may be called from interrupt responses.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                started coding
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_General.h"
+#include "ES_Port.h"
+#include "ES_Pool.h"
+
+/*--------------------------- External Variables --------------------------*/
+
+/*----------------------------- Module Defines ----------------------------*/
+#if (ES_NUM_POOLS < 1) || (ES_NUM_POOLS > 4)
+#error ES_NUM_POOLS must be between 1 and 4
+#endif
+
+// the blocks are made of 32 bit words so that they are aligned for any use,
+// and a free block holds the number of the next free block in its first word
+#define POOL_WORDS(BlockSize) (((BlockSize) + 3) / 4)
+
+// marks the end of a free list
+#define NO_BLOCK 0xFFFF
+
+#if (ES_POOL0_BLOCK_SIZE < 1) || (ES_POOL0_NUM_BLOCKS < 1) || \
+    (ES_POOL0_NUM_BLOCKS >= NO_BLOCK)
+#error ES_POOL0_BLOCK_SIZE or ES_POOL0_NUM_BLOCKS is out of range
+#endif
+#if ES_NUM_POOLS > 1
+#if (ES_POOL1_BLOCK_SIZE <= ES_POOL0_BLOCK_SIZE) || \
+    (ES_POOL1_NUM_BLOCKS < 1) || (ES_POOL1_NUM_BLOCKS >= NO_BLOCK)
+#error ES_POOL1_BLOCK_SIZE or ES_POOL1_NUM_BLOCKS is out of range
+#endif
+#endif
+#if ES_NUM_POOLS > 2
+#if (ES_POOL2_BLOCK_SIZE <= ES_POOL1_BLOCK_SIZE) || \
+    (ES_POOL2_NUM_BLOCKS < 1) || (ES_POOL2_NUM_BLOCKS >= NO_BLOCK)
+#error ES_POOL2_BLOCK_SIZE or ES_POOL2_NUM_BLOCKS is out of range
+#endif
+#endif
+#if ES_NUM_POOLS > 3
+#if (ES_POOL3_BLOCK_SIZE <= ES_POOL2_BLOCK_SIZE) || \
+    (ES_POOL3_NUM_BLOCKS < 1) || (ES_POOL3_NUM_BLOCKS >= NO_BLOCK)
+#error ES_POOL3_BLOCK_SIZE or ES_POOL3_NUM_BLOCKS is out of range
+#endif
+#endif
+
+/*------------------------------ Module Types -----------------------------*/
+// the fixed description of a pool
+typedef struct {
+  uint32_t *pStart;     // the first block
+  uint16_t BlockSize;   // as configured, in bytes
+  uint16_t BlockWords;  // the space taken by each block, in words
+  uint16_t NumBlocks;
+} PoolDesc_t;
+
+// the changing state of a pool
+typedef struct {
+  uint16_t FreeHead;    // number of the first free block
+  uint16_t NumFree;
+  uint16_t HighWater;
+  uint16_t Failures;
+} PoolState_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+static uint32_t Pool0Blocks[ES_POOL0_NUM_BLOCKS *
+                            POOL_WORDS(ES_POOL0_BLOCK_SIZE)];
+#if ES_NUM_POOLS > 1
+static uint32_t Pool1Blocks[ES_POOL1_NUM_BLOCKS *
+                            POOL_WORDS(ES_POOL1_BLOCK_SIZE)];
+#endif
+#if ES_NUM_POOLS > 2
+static uint32_t Pool2Blocks[ES_POOL2_NUM_BLOCKS *
+                            POOL_WORDS(ES_POOL2_BLOCK_SIZE)];
+#endif
+#if ES_NUM_POOLS > 3
+static uint32_t Pool3Blocks[ES_POOL3_NUM_BLOCKS *
+                            POOL_WORDS(ES_POOL3_BLOCK_SIZE)];
+#endif
+
+static PoolDesc_t const PoolDescList[] = {
+  { Pool0Blocks, ES_POOL0_BLOCK_SIZE, POOL_WORDS(ES_POOL0_BLOCK_SIZE),
+    ES_POOL0_NUM_BLOCKS }
+#if ES_NUM_POOLS > 1
+ ,{ Pool1Blocks, ES_POOL1_BLOCK_SIZE, POOL_WORDS(ES_POOL1_BLOCK_SIZE),
+    ES_POOL1_NUM_BLOCKS }
+#endif
+#if ES_NUM_POOLS > 2
+ ,{ Pool2Blocks, ES_POOL2_BLOCK_SIZE, POOL_WORDS(ES_POOL2_BLOCK_SIZE),
+    ES_POOL2_NUM_BLOCKS }
+#endif
+#if ES_NUM_POOLS > 3
+ ,{ Pool3Blocks, ES_POOL3_BLOCK_SIZE, POOL_WORDS(ES_POOL3_BLOCK_SIZE),
+    ES_POOL3_NUM_BLOCKS }
+#endif
+};
+
+static PoolState_t PoolStates[ARRAY_SIZE(PoolDescList)];
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_PoolInit
+ Parameters
+   None
+ Returns
+   None
+ Description
+   puts every block of every pool into its pool's free list and zeroes the
+   statistics
+ Notes
+   called by ES_Initialize, any blocks still allocated are lost
+****************************************************************************/
+void ES_PoolInit( void )
+{
+  uint8_t i;
+  uint16_t Block;
+  PoolDesc_t const *pDesc;
+
+  for ( i = 0; i < ARRAY_SIZE(PoolDescList); i++ ){
+    pDesc = &PoolDescList[i];
+    EnterCritical();
+    for ( Block = 0; Block < pDesc->NumBlocks; Block++ ){
+      pDesc->pStart[Block * pDesc->BlockWords] = Block + 1;
+    }
+    pDesc->pStart[(pDesc->NumBlocks - 1) * pDesc->BlockWords] = NO_BLOCK;
+    PoolStates[i].FreeHead = 0;
+    PoolStates[i].NumFree = pDesc->NumBlocks;
+    PoolStates[i].HighWater = 0;
+    PoolStates[i].Failures = 0;
+    ExitCritical();
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_PoolAlloc
+ Parameters
+   uint16_t : the number of bytes needed
+ Returns
+   void * : the block, NULL if the pool for that size is empty or the size
+   is bigger than the blocks of the largest pool
+ Description
+   takes a block from the smallest pool whose blocks hold Size bytes
+ Notes
+   the block is aligned on a 4 byte boundary, its contents are whatever its
+   last user left there
+****************************************************************************/
+void * ES_PoolAlloc( uint16_t Size )
+{
+  uint8_t WhichPool;
+  uint16_t InUse;
+  uint32_t *pBlock = NULL;
+  PoolDesc_t const *pDesc;
+  PoolState_t *pState;
+
+  for ( WhichPool = 0; WhichPool < ARRAY_SIZE(PoolDescList); WhichPool++ ){
+    if ( Size <= PoolDescList[WhichPool].BlockSize )
+      break;
+  }
+  if ( WhichPool == ARRAY_SIZE(PoolDescList) )
+    return NULL;
+
+  pDesc = &PoolDescList[WhichPool];
+  pState = &PoolStates[WhichPool];
+  EnterCritical();
+  if ( pState->FreeHead == NO_BLOCK ){
+    if ( pState->Failures != UINT16_MAX )
+      pState->Failures++;
+  }else {
+    pBlock = &pDesc->pStart[pState->FreeHead * pDesc->BlockWords];
+    pState->FreeHead = (uint16_t)*pBlock;
+    pState->NumFree--;
+    InUse = pDesc->NumBlocks - pState->NumFree;
+    if ( InUse > pState->HighWater )
+      pState->HighWater = InUse;
+  }
+  ExitCritical();
+  return pBlock;
+}
+
+/****************************************************************************
+ Function
+   ES_PoolFree
+ Parameters
+   void * : a block from ES_PoolAlloc
+ Returns
+   bool : false if the pointer is not that of a block in one of the pools
+ Description
+   returns a block to the pool that it came from
+ Notes
+   freeing a block that is already free is not detected, and corrupts
+   that pool's free list
+****************************************************************************/
+bool ES_PoolFree( void *pBlock )
+{
+  uint8_t WhichPool;
+  uint32_t Offset;
+  PoolDesc_t const *pDesc;
+  PoolState_t *pState;
+
+  for ( WhichPool = 0; WhichPool < ARRAY_SIZE(PoolDescList); WhichPool++ ){
+    pDesc = &PoolDescList[WhichPool];
+    if ( ((uint32_t *)pBlock >= pDesc->pStart) &&
+         ((uint32_t *)pBlock <
+           &pDesc->pStart[pDesc->NumBlocks * pDesc->BlockWords]) )
+      break;
+  }
+  if ( WhichPool == ARRAY_SIZE(PoolDescList) )
+    return false;
+
+  Offset = (uint32_t)((uint32_t *)pBlock - pDesc->pStart);
+  if ( (Offset % pDesc->BlockWords) != 0 )
+    return false; // not the start of a block
+
+  pState = &PoolStates[WhichPool];
+  EnterCritical();
+  *(uint32_t *)pBlock = pState->FreeHead;
+  pState->FreeHead = (uint16_t)(Offset / pDesc->BlockWords);
+  pState->NumFree++;
+  ExitCritical();
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_PoolGetStats
+ Parameters
+   uint8_t : Which pool, 0 to ES_NUM_POOLS-1
+   ES_PoolStats_t * : where to put a copy of its statistics
+ Returns
+   bool : false if there is no such pool
+ Description
+   takes a consistent snapshot of one pool's occupancy
+****************************************************************************/
+bool ES_PoolGetStats( uint8_t WhichPool, ES_PoolStats_t *pStats )
+{
+  PoolState_t Snapshot;
+
+  if ( WhichPool >= ARRAY_SIZE(PoolDescList) )
+    return false;
+
+  EnterCritical();
+  Snapshot = PoolStates[WhichPool];
+  ExitCritical();
+
+  pStats->BlockSize = PoolDescList[WhichPool].BlockSize;
+  pStats->NumBlocks = PoolDescList[WhichPool].NumBlocks;
+  pStats->NumFree = Snapshot.NumFree;
+  pStats->HighWater = Snapshot.HighWater;
+  pStats->Failures = Snapshot.Failures;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_PoolResetStats
+ Parameters
+   None
+ Returns
+   None
+ Description
+   zeroes the failure counts of all of the pools
+ Notes
+   the high water marks start again from the number of blocks in use now
+****************************************************************************/
+void ES_PoolResetStats( void )
+{
+  uint8_t i;
+
+  for ( i = 0; i < ARRAY_SIZE(PoolDescList); i++ ){
+    EnterCritical();
+    PoolStates[i].HighWater = PoolDescList[i].NumBlocks - PoolStates[i].NumFree;
+    PoolStates[i].Failures = 0;
+    ExitCritical();
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_PoolPrintStats
+ Parameters
+   None
+ Returns
+   None
+ Description
+   prints a table of the occupancy of all of the pools on the console (the
+   debug UART)
+****************************************************************************/
+void ES_PoolPrintStats( void )
+{
+  uint8_t i;
+  ES_PoolStats_t Stats;
+
+  printf("Pool  Size Blocks  Free  High Failed\r\n");
+  for ( i = 0; i < ARRAY_SIZE(PoolDescList); i++ ){
+    ES_PoolGetStats( i, &Stats );
+    printf("%2u   %5u  %5u %5u %5u %6u\r\n", (unsigned)i,
+           (unsigned)Stats.BlockSize, (unsigned)Stats.NumBlocks,
+           (unsigned)Stats.NumFree, (unsigned)Stats.HighWater,
+           (unsigned)Stats.Failures);
+  }
+}
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
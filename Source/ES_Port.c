@@ -20,10 +20,23 @@
  03/05/14 13:20	joa		Began port for TM4C123G
  03/13/14 10:30	joa		Updated files to use with Cortex M4 processor core.
  	 	 	 	 	 	Specifically, this was tested on a TI TM4C123G mcu.
+ 10/17/26               added the host (Linux) simulation port, built with -Dhost
+ 10/17/26               added _HW_CycleCounter_Init & _HW_GetCycleCount
+ 10/17/26               added _HW_Sleep, the tickless idle
+ 10/17/26               added _HW_Watchdog_Init & _HW_Watchdog_Feed
+ 10/17/26               added the PendSV & SVC handlers for ES_PREEMPTIVE
+ 10/17/26               added HardFault_Handler, which sends out the trace,
+                        and the SysTick trace record
+ 10/17/26               _HW_Sleep wakes for the next periodic event checker
+ 10/17/26               added _HW_GetPendingTicks
 ****************************************************************************/
 #include <stdint.h>
 #include <stdbool.h>
+#include "inc/hw_types.h"
 #include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_watchdog.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/interrupt.h"
 #include "driverlib/uart.h"
@@ -31,29 +44,65 @@
 #include "driverlib/systick.h"
 #include "driverlib/gpio.h"
 #include "utils/uartstdio.h"
+#include "ES_Configure.h"
 #include "ES_Port.h"
 #include "ES_Types.h"
 #include "ES_Timers.h"
+#include "ES_Framework.h"
+#include "ES_CheckEvents.h"
+#if defined(host)
+#include "HostSim.h"
+#endif
 
 #define UART_PORT 		0
 #define UART_BAUD		115200UL
 #define SRC_CLK_FREQ	16000000UL
 #define CLK_FREQ		40000000UL
 
+// the data watchpoint & trace unit, which TivaWare has no header for
+#define DEMCR               0xE000EDFC
+#define DEMCR_TRCENA        0x01000000
+#define DWT_CTRL            0xE0001000
+#define DWT_CTRL_CYCCNTENA  0x00000001
+#define DWT_CYCCNT          0xE0001004
+
+// the largest value that SysTick can count down from
+#define SYSTICK_MAX_PERIOD  0x01000000UL
+
+// SysTick stopped & running, with the interrupt enabled
+#define SYSTICK_STOPPED     (NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_INTEN)
+#define SYSTICK_RUNNING     (SYSTICK_STOPPED | NVIC_ST_CTRL_ENABLE)
+
+// the lowest of the 8 priorities, in the top 3 bits of PendSV's byte of
+// NVIC_SYS_PRI3
+#define PENDSV_PRIORITY     0x00E00000
+
 // TickCount is used to track the number of timer ints that have occurred
-// since the last check. It should really never be more than 1, but just to
-// be sure, we increment it in the interrupt response rather than simply 
-// setting a flag. Using this variable and checking approach we remove the
+// since the last check. Without tickless idle it should really never be
+// more than 1, but just to be sure, we increment it in the interrupt
+// response rather than simply setting a flag. Using this variable and checking approach we remove the
 // need to post events from the interrupt response routine. This is necessary
 // for compilers like HTC for the midrange PICs which do not produce re-entrant
 // code so cannot post directly to the queues from within the interrupt resp.
-static volatile uint8_t TickCount;
+static volatile uint16_t TickCount;
 
 // Global tick count to monitor number of SysTick Interrupts
 // make uint16_t to maintain backwards compatibility and not overly burden
 // 8 and 16 bit processors
 static volatile uint16_t SysTickCounter = 0;
 
+#ifdef ES_TICKLESS
+// the SysTick period, in cycles, that _HW_Timer_Init set up
+static uint32_t TickPeriod;
+// the longest tickless sleep, in ticks
+static uint32_t MaxSleepTicks;
+// the number of ticks that the next SysTick interrupt stands for, more than
+// 1 while SysTick is stretched over a sleep
+static volatile uint16_t TicksThisInt = 1;
+// true while SysTick is not running at TickPeriod
+static volatile bool Stretched = false;
+#endif
+
 /****************************************************************************
  Function
      _HW_Timer_Init
@@ -73,6 +122,12 @@ static volatile uint16_t SysTickCounter = 0;
 ****************************************************************************/
 void _HW_Timer_Init(TimerRate_t Rate)
 {
+#ifdef ES_TICKLESS
+	TickPeriod = Rate;
+	MaxSleepTicks = (Rate == 0) ? 0 : (SYSTICK_MAX_PERIOD / Rate);
+	if (MaxSleepTicks > ES_TICKLESS_MAX_TICKS)
+		MaxSleepTicks = ES_TICKLESS_MAX_TICKS;
+#endif
 	SysTickPeriodSet(Rate);			/* Set the SysTick Interrupt Rate */
 	SysTickIntEnable();				/* Enable the SysTick Interrupt */
 	SysTickEnable();				/* Enable SysTick */
@@ -94,14 +149,29 @@ void _HW_Timer_Init(TimerRate_t Rate)
      As currently (8/13/13) implemented this does not actually post events
      but simply sets a flag to indicate that the interrupt has occurred.
      the framework response is handled below in _HW_Process_Pending_Ints
+     After a tickless sleep the interrupt may stand for several ticks, and
+     it puts SysTick back to the normal period.
  Author
     John Alabi, 03/05/14 13:50
 ****************************************************************************/
 void SysTickIntHandler(void)
 {
+	ES_TraceISR(FAULT_SYSTICK);
 	/* Interrupt automatically cleared by hardware */
+#ifdef ES_TICKLESS
+  TickCount += TicksThisInt;      /* flag that it occurred and needs a response */
+  SysTickCounter += TicksThisInt; // keep the free running time going
+  if (Stretched)
+  {
+    SysTickPeriodSet(TickPeriod);
+    HWREG(NVIC_ST_CURRENT) = 0;   // reload now rather than after the long count
+    TicksThisInt = 1;
+    Stretched = false;
+  }
+#else
   ++TickCount;          /* flag that it occurred and needs a response */
 	++SysTickCounter;     // keep the free running time going
+#endif
 #ifdef LED_DEBUG
 	BlinkLED();
 #endif
@@ -127,6 +197,116 @@ uint16_t _HW_GetTickCount(void)
    return (SysTickCounter);
 }
 
+/****************************************************************************
+ Function
+    _HW_GetPendingTicks()
+ Parameters
+    none
+ Returns
+    uint16_t   the ticks that have occurred but not been handed to
+               ES_Timer_Tick_Resp yet
+ Description
+    for ES_Timers, so that a timer started from an interrupt response
+    counts from now rather than from the last tick that was handled
+ Notes
+    after a tickless sleep (_HW_Sleep) there can be many of these waiting
+    when the interrupt that woke the CPU is taken
+****************************************************************************/
+uint16_t _HW_GetPendingTicks(void)
+{
+   return (TickCount);
+}
+
+/****************************************************************************
+ Function
+    _HW_CycleCounter_Init()
+ Parameters
+    none
+ Returns
+    none
+ Description
+    starts the free running CPU cycle counter in the DWT unit
+ Notes
+    the counter wraps every 107 seconds at 40MHz, so only differences
+    between two readings are meaningful
+****************************************************************************/
+void _HW_CycleCounter_Init(void)
+{
+   HWREG(DEMCR) |= DEMCR_TRCENA;
+   HWREG(DWT_CYCCNT) = 0;
+   HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+}
+
+/****************************************************************************
+ Function
+    _HW_GetCycleCount()
+ Parameters
+    none
+ Returns
+    uint32_t   the number of CPU cycles since _HW_CycleCounter_Init
+ Description
+    wrapper for access to the DWT cycle counter
+ Notes
+
+****************************************************************************/
+uint32_t _HW_GetCycleCount(void)
+{
+   return HWREG(DWT_CYCCNT);
+}
+
+#ifdef ES_WATCHDOG_MS
+/****************************************************************************
+ Function
+    _HW_Watchdog_Init
+ Parameters
+    uint32_t Milliseconds : how long the framework may go without feeding
+    the watchdog before it resets the processor
+ Returns
+    none
+ Description
+    starts watchdog 0 with reset enabled, stalled while the debugger has
+    the processor halted
+ Notes
+    the watchdog resets on its second time-out, so it is loaded with half
+    the time. Its interrupt is not enabled in the NVIC, the first time-out
+    only sets RIS. It is not locked, so that _HW_Watchdog_Feed can write ICR
+    without unlocking it each time.
+    Call after _HW_Timer_Init: with ES_TICKLESS the sleeps are cut to fit in
+    one watchdog period, since the idle loop feeds it between them.
+****************************************************************************/
+void _HW_Watchdog_Init(uint32_t Milliseconds)
+{
+   uint32_t Load = Milliseconds * (CLK_FREQ / 1000 / 2);
+
+   SysCtlPeripheralEnable(SYSCTL_PERIPH_WDOG0);
+   while (!SysCtlPeripheralReady(SYSCTL_PERIPH_WDOG0))
+      ;
+   HWREG(WATCHDOG0_BASE + WDT_O_TEST) |= WDT_TEST_STALL;
+   HWREG(WATCHDOG0_BASE + WDT_O_LOAD) = Load;
+   // setting INTEN starts the count, and it can only be cleared by a reset
+   HWREG(WATCHDOG0_BASE + WDT_O_CTL) = WDT_CTL_RESEN | WDT_CTL_INTEN;
+#ifdef ES_TICKLESS
+   if ((TickPeriod != 0) && (MaxSleepTicks > Load / TickPeriod))
+      MaxSleepTicks = Load / TickPeriod;
+#endif
+}
+
+/****************************************************************************
+ Function
+    _HW_Watchdog_Feed
+ Parameters
+    none
+ Returns
+    none
+ Description
+    reloads the watchdog count and clears its first time-out
+****************************************************************************/
+void _HW_Watchdog_Feed(void)
+{
+   HWREG(WATCHDOG0_BASE + WDT_O_ICR) = 1;
+}
+#endif
+
 /****************************************************************************
  Function
      _HW_Process_Pending_Ints
@@ -150,15 +330,310 @@ uint16_t _HW_GetTickCount(void)
 ****************************************************************************/
 bool _HW_Process_Pending_Ints( void )
 {
+#if defined(host)
+   // let the simulated peripherals catch up and take their interrupts
+   HostSim_Sync();
+#endif
    while (TickCount > 0)
    {
+      /* taken off first, as ES_Timer_Tick_Resp counts it in TMR_Ticks */
+      TickCount--;
       /* call the framework tick response to actually run the timers */
       ES_Timer_Tick_Resp();  
-      TickCount--;
    }
    return true; // always return true to allow loop test in ES_Run to proceed
 }
 
+#ifdef ES_TICKLESS
+/****************************************************************************
+ Function
+     _HW_Sleep
+ Parameters
+     none
+ Returns
+     none
+ Description
+     the tickless idle: sleeps (WFI) until the next interrupt, with the
+     SysTick period stretched out to the next ES_Timers deadline (or the
+     next periodic event checker, ES_GetTicksToNextCheck) so that no tick
+     interrupts are taken just to find that nothing has timed out.
+     The ticks that go by while asleep are added to TickCount and
+     SysTickCounter, so the timers and ES_Timer_GetTime carry on as if
+     every one had been taken.
+ Notes
+     Call with interrupts disabled, as ES_Run does, so that nothing can be
+     posted between finding the queues empty and going to sleep. The
+     interrupt that wakes the CPU is taken when they are enabled again.
+     Each stretch loses the few cycles it takes to reprogram SysTick.
+****************************************************************************/
+void _HW_Sleep(void)
+{
+  uint32_t Ticks;
+  uint32_t NextCheck;
+  uint32_t Stretch;
+  uint32_t Left;
+  uint32_t Passed;
+
+  // a tick that has not been handled yet means there is work to do
+  if ((TickCount != 0) || (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PENDSTSET))
+  {
+    return;
+  }
+  Ticks = ES_Timer_GetTicksToNextTimeout();
+  NextCheck = ES_GetTicksToNextCheck();
+  if (Ticks > NextCheck)
+  {
+    Ticks = NextCheck;
+  }
+  if (Ticks > MaxSleepTicks)
+  {
+    Ticks = MaxSleepTicks;
+  }
+  if (Ticks <= 1)
+  {
+    // the next tick is due soon enough, so just wait for it
+    ES_WaitForInterrupt();
+    return;
+  }
+
+  // stretch the tick in progress out to the last of the ticks to sleep
+  HWREG(NVIC_ST_CTRL) = SYSTICK_STOPPED;
+  if (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PENDSTSET)
+  {
+    // it ran out before it could be stopped
+    HWREG(NVIC_ST_CTRL) = SYSTICK_RUNNING;
+    return;
+  }
+  Left = SysTickValueGet();
+  Stretch = Left + (Ticks - 1) * TickPeriod;
+  SysTickPeriodSet(Stretch);
+  HWREG(NVIC_ST_CURRENT) = 0;
+  TicksThisInt = Ticks;
+  Stretched = true;
+  HWREG(NVIC_ST_CTRL) = SYSTICK_RUNNING;
+
+  ES_WaitForInterrupt();
+
+  HWREG(NVIC_ST_CTRL) = SYSTICK_STOPPED;
+  if (!(HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PENDSTSET))
+  {
+    // some other interrupt woke us early: count the ticks that have gone
+    // by and run out the one in progress. SysTickIntHandler restores the
+    // normal period after that
+    Left = SysTickValueGet();
+    if (Left == 0)
+    {
+      Left = Stretch;           // woke before the count had even started
+    }
+    Passed = Ticks - (Left + TickPeriod - 1) / TickPeriod;
+    TickCount += Passed;
+    SysTickCounter += Passed;
+    SysTickPeriodSet(((Left - 1) % TickPeriod) + 1);
+    HWREG(NVIC_ST_CURRENT) = 0;
+    TicksThisInt = 1;
+  }
+  HWREG(NVIC_ST_CTRL) = SYSTICK_RUNNING;
+}
+#endif
+
+#ifdef ES_PREEMPTIVE
+/****************************************************************************
+ Function
+     _HW_PreemptInit
+ Parameters
+     none
+ Returns
+     none
+ Description
+     puts PendSV at the lowest priority, below every interrupt, so that it
+     only runs the preempting services once all of the interrupts (the one
+     that made the post included) have returned
+ Notes
+     SVCall is left at its reset priority, the highest. SVC #0 is how
+     ES_PreemptThread gets back to the code that was preempted.
+****************************************************************************/
+void _HW_PreemptInit(void)
+{
+   HWREG(NVIC_SYS_PRI3) = (HWREG(NVIC_SYS_PRI3) & ~NVIC_SYS_PRI3_PENDSV_M) |
+                          PENDSV_PRIORITY;
+}
+
+/****************************************************************************
+ Function
+     _HW_PendSV
+ Parameters
+     none
+ Returns
+     none
+ Description
+     makes PendSV pending, to run the services of higher priority than the
+     one that is running (ES_Preempt)
+ Notes
+     From an interrupt response, PendSV is taken when it (and any other
+     interrupt that is pending) returns. From a run function, it is taken
+     straight away, or as soon as interrupts are enabled again.
+****************************************************************************/
+void _HW_PendSV(void)
+{
+   HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PEND_SV;
+#if defined(host)
+   // the simulation only acts on a register write at the next access
+   HostSim_Sync();
+#endif
+}
+
+#if defined(rvmdk) || defined(__ARMCC_VERSION)
+// where PendSV_Handler returns to
+void ES_PreemptThread(void);
+
+/****************************************************************************
+ Function
+     PendSV_Handler
+ Parameters
+     none
+ Returns
+     none
+ Description
+     the PendSV exception. It can't run the services itself, as they would
+     then block all of the interrupts at its priority, so it fakes an
+     exception frame and "returns" from the exception to ES_PreemptThread,
+     in thread mode on the same stack. The frame of the code that was
+     interrupted stays on the stack above, to be returned to through
+     SVC_Handler.
+ Notes
+     Interrupts are turned off here and stay off into ES_Preempt. The
+     EXC_RETURN that was in lr is saved (with r0, to keep the stack 8 byte
+     aligned) since it says whether the interrupted code's frame holds FPU
+     registers.
+****************************************************************************/
+__asm void PendSV_Handler(void)
+{
+    PRESERVE8
+    CPSID   i                       ; no interrupts until ES_Preempt
+    PUSH    {r0, lr}                ; the EXC_RETURN of the interrupted code
+    LDR     r2, =__cpp(ES_PreemptThread)
+    BIC     r2, r2, #1              ; the stacked PC has no Thumb bit
+    MOV     r3, #0x01000000         ; xPSR with just the Thumb bit set
+    SUB     sp, sp, #(8*4)          ; room for an 8 word exception frame
+    ADD     r0, sp, #(6*4)          ; which ends with PC and xPSR
+    STM     r0, {r2, r3}
+    MVN     r0, #6                  ; EXC_RETURN 0xFFFFFFF9: thread mode,
+    BX      r0                      ; main stack, no FPU registers
+}
+
+/****************************************************************************
+ Function
+     ES_PreemptThread
+ Parameters
+     none
+ Returns
+     doesn't
+ Description
+     where PendSV_Handler returns to. Runs ES_Preempt and then goes back to
+     the code that was preempted through SVC_Handler.
+ Notes
+     FPCA is cleared before the SVC so that its exception frame is always
+     the basic 8 words that SVC_Handler drops, whether or not the services
+     used the FPU. Interrupts have to be on for the SVC to be taken rather
+     than escalated to a hard fault.
+****************************************************************************/
+__asm void ES_PreemptThread(void)
+{
+    PRESERVE8
+    BL      __cpp(ES_Preempt)       ; returns with interrupts off
+    MRS     r0, CONTROL
+    BIC     r0, r0, #4              ; clear FPCA
+    MSR     CONTROL, r0
+    ISB
+    CPSIE   i
+    SVC     #0                      ; to SVC_Handler
+    B       .                       ; never gets here
+}
+
+/****************************************************************************
+ Function
+     SVC_Handler
+ Parameters
+     none
+ Returns
+     none
+ Description
+     throws away its own exception frame and the saved r0, and returns
+     from PendSV to the code that it preempted with the EXC_RETURN that
+     PendSV_Handler saved
+ Notes
+     The only SVC is the one in ES_PreemptThread.
+****************************************************************************/
+__asm void SVC_Handler(void)
+{
+    ADD     sp, sp, #(8*4)          ; drop the frame of the SVC
+    POP     {r0, lr}                ; the EXC_RETURN saved by PendSV
+    BX      lr
+}
+#elif defined(host)
+/****************************************************************************
+ Function
+     PendSV_Handler
+ Parameters
+     none
+ Returns
+     none
+ Description
+     The simulation takes PendSV in thread context, so this is what
+     ES_PreemptThread does on the target: run ES_Preempt with interrupts
+     off.
+****************************************************************************/
+void PendSV_Handler(void)
+{
+   uint32_t SavedPRIMASK;
+
+   SavedPRIMASK = CPUgetPRIMASK_cpsid();
+   ES_Preempt();
+   CPUsetPRIMASK(SavedPRIMASK);
+}
+#else
+#error ES_PREEMPTIVE needs PendSV_Handler & SVC_Handler for this compiler
+#endif
+
+#elif defined(rvmdk) || defined(__ARMCC_VERSION)
+// without ES_PREEMPTIVE neither of these is ever raised, they only stand in
+// for IntDefaultHandler in the vector table
+void PendSV_Handler(void)
+{
+   for (;;)
+      ;
+}
+
+void SVC_Handler(void)
+{
+   for (;;)
+      ;
+}
+#endif
+
+#if !defined(host)
+/****************************************************************************
+ Function
+     HardFault_Handler
+ Parameters
+     none
+ Returns
+     none
+ Description
+     sends out whatever is in the trace (ES_TRACE_SIZE), which shows what
+     led up to the fault, then stops with the system state preserved for
+     examination by a debugger, as the FaultISR in the startup code did
+****************************************************************************/
+void HardFault_Handler(void)
+{
+#ifdef ES_TRACE_SIZE
+   ES_TraceDump();
+#endif
+   for (;;)
+      ;
+}
+#endif
+
 /****************************************************************************
  Function
      ConsoleInit
@@ -273,3 +748,26 @@ inline void CPUsetFAULTMASK(uint32_t newFAULTMASK)
   }
 }
 #endif
+
+#if defined(host)
+uint32_t CPUgetPRIMASK_cpsid(void)
+{
+  return HostSim_DisableIRQ();
+}
+
+void CPUsetPRIMASK(uint32_t newPRIMASK)
+{
+  HostSim_SetPRIMASK(newPRIMASK);
+}
+
+// the simulation has no fault handlers, so FAULTMASK acts as PRIMASK
+uint32_t CPUgetFAULTMASK_cpsid(void)
+{
+  return HostSim_DisableIRQ();
+}
+
+void CPUsetFAULTMASK(uint32_t newFAULTMASK)
+{
+  HostSim_SetPRIMASK(newFAULTMASK);
+}
+#endif
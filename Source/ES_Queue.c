@@ -9,6 +9,12 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                ES_QUEUE_DROP_OLDEST only pushes out an event of the
+                         same type, added ES_QUEUE_DROP_HEAD
+ 10/17/26                added ES_EnQueuePolicy for coalescing events
+ 10/17/26                added the lock-free single producer/single consumer
+                         queue (ES_InitSPSCQueue etc.) and its host stress test
+ 10/17/26                added ES_QueueNumEntries for the service statistics
  01/15/12 09:34 jec      converted to use the new C99 types from types.h
  08/09/11 18:16 jec      started coding
 *****************************************************************************/
@@ -31,6 +37,20 @@ typedef struct {  uint8_t QueueSize;
 
 typedef ES_Queue_t * pQueue_t;
 
+// the single producer/single consumer (SPSC) queue header. Head is only
+// written by the producer and Tail only by the consumer. Both run freely
+// and are masked to index the block, so the size must be a power of 2 and
+// Head - Tail is always the number of entries
+typedef struct {  volatile uint8_t Head;
+                  volatile uint8_t Tail;
+                  uint8_t Mask;
+} ES_SPSCQueue_t;
+
+typedef ES_SPSCQueue_t * pSPSCQueue_t;
+
+// largest SPSC queue that the 8 bit Head & Tail can manage
+#define MAX_SPSC_QUEUE_SIZE 128
+
 /*---------------------------- Module Functions ---------------------------*/
 
 /*---------------------------- Module Variables ---------------------------*/
@@ -207,6 +227,290 @@ bool ES_IsQueueEmpty( ES_Event * pBlock )
    return(pThisQueue->NumEntries == 0);
 }
 
+/****************************************************************************
+ Function
+   ES_QueueNumEntries
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   uint8_t : the number of events currently in the Queue
+ Description
+   see above
+ Notes
+
+****************************************************************************/
+uint8_t ES_QueueNumEntries( ES_Event * pBlock )
+{
+   pQueue_t pThisQueue;
+
+   pThisQueue = (pQueue_t)pBlock;
+   return(pThisQueue->NumEntries);
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueuePolicy
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event Event2Add : event to be added to the Queue
+   ES_QueuePolicy_t Policy : how to add it
+   ES_Event * pDisplaced : used to return the event that the policy kept out
+                           of, or took out of, the Queue
+ Returns
+   bool : true if Event2Add is in the Queue or was merged with an event
+   that is, false if it would not fit
+ Description
+   adds Event2Add to the Queue according to Policy:
+   ES_QUEUE_FIFO        - the same as ES_EnQueueFIFO
+   ES_QUEUE_LATEST      - if an event of the same type is waiting, it is
+                          overwritten (and returned in *pDisplaced), so
+                          only the latest value of a state-like event is
+                          ever handled, at the place of the first one
+   ES_QUEUE_MERGE       - if an identical event (type, parameter and
+                          buffer) is waiting, Event2Add is not added but
+                          returned in *pDisplaced
+   ES_QUEUE_DROP_OLDEST - if the Queue is full, the oldest waiting event of
+                          the same type is taken out (and returned in
+                          *pDisplaced) to make room. If there is none,
+                          Event2Add is rejected, so events of other types
+                          are never pushed out by it
+   ES_QUEUE_DROP_HEAD   - if the Queue is full, the event at its head is
+                          taken out (and returned in *pDisplaced) to make
+                          room, whatever its type
+   Otherwise Event2Add goes on the end of the Queue, if there is room.
+ Notes
+   *pDisplaced is ES_NO_EVENT with no buffer if no event was displaced. The
+   caller is responsible for the buffer of a displaced event.
+   The search of the Queue is done with interrupts off, so this is meant
+   for the short queues that ES_Run uses.
+****************************************************************************/
+bool ES_EnQueuePolicy( ES_Event * pBlock, ES_Event Event2Add,
+                       ES_QueuePolicy_t Policy, ES_Event * pDisplaced )
+{
+   pQueue_t pThisQueue;
+   uint8_t i;
+   uint8_t Index;
+   bool ReturnVal = true;
+
+   pThisQueue = (pQueue_t)pBlock;
+   pDisplaced->EventType = ES_NO_EVENT;
+   pDisplaced->Buffer = ES_NO_BUFFER;
+   pDisplaced->EventParam = 0;
+
+   EnterCritical();   // save interrupt state, turn ints off
+   // look for an event that this one replaces or duplicates
+   if ( (Policy == ES_QUEUE_LATEST) || (Policy == ES_QUEUE_MERGE) )
+   {
+      Index = pThisQueue->CurrentIndex;
+      for ( i = 0; i < pThisQueue->NumEntries; i++ )
+      {
+         if ( (pBlock[1 + Index].EventType == Event2Add.EventType) &&
+              ((Policy == ES_QUEUE_LATEST) ||
+               ((pBlock[1 + Index].EventParam == Event2Add.EventParam) &&
+                (pBlock[1 + Index].Buffer == Event2Add.Buffer))) )
+         {
+            if ( Policy == ES_QUEUE_LATEST )
+            {
+               *pDisplaced = pBlock[1 + Index];
+               pBlock[1 + Index] = Event2Add;
+            }else
+            {
+               *pDisplaced = Event2Add;
+            }
+            ExitCritical();  // restore saved interrupt state
+            return(true);
+         }
+         if ( ++Index >= pThisQueue->QueueSize )
+            Index = 0;
+      }
+   }
+
+   if ( pThisQueue->NumEntries < pThisQueue->QueueSize )
+   {
+      pBlock[ 1 + ((pThisQueue->CurrentIndex + pThisQueue->NumEntries)
+               % pThisQueue->QueueSize)] = Event2Add;
+      pThisQueue->NumEntries++;
+   }else if ( Policy == ES_QUEUE_DROP_HEAD )
+   {  // the new event takes the slot of the one at the head
+      *pDisplaced = pBlock[ 1 + pThisQueue->CurrentIndex ];
+      pBlock[ 1 + pThisQueue->CurrentIndex ] = Event2Add;
+      if ( ++pThisQueue->CurrentIndex >= pThisQueue->QueueSize )
+         pThisQueue->CurrentIndex = 0;
+   }else if ( Policy == ES_QUEUE_DROP_OLDEST )
+   {  // find the oldest event of the same type
+      Index = pThisQueue->CurrentIndex;
+      for ( i = 0; i < pThisQueue->NumEntries; i++ )
+      {
+         if ( pBlock[1 + Index].EventType == Event2Add.EventType )
+            break;
+         if ( ++Index >= pThisQueue->QueueSize )
+            Index = 0;
+      }
+      if ( i < pThisQueue->NumEntries )
+      {  // close the gap it leaves, and put the new event on the end
+         *pDisplaced = pBlock[1 + Index];
+         for ( ; i < pThisQueue->NumEntries - 1; i++ )
+         {
+            uint8_t Next = Index + 1;
+
+            if ( Next >= pThisQueue->QueueSize )
+               Next = 0;
+            pBlock[1 + Index] = pBlock[1 + Next];
+            Index = Next;
+         }
+         pBlock[1 + Index] = Event2Add;
+      }else
+      {
+         ReturnVal = false;
+      }
+   }else
+   {
+      ReturnVal = false;
+   }
+   ExitCritical();  // restore saved interrupt state
+   return(ReturnVal);
+}
+
+/****************************************************************************
+ Function
+   ES_InitSPSCQueue
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory to use for the Queue
+   uint8_t BlockSize: size of the block pointed to by pBlock
+ Returns
+   max number of entries in the created queue, 0 if BlockSize - 1 is not a
+   power of 2 between 1 and 128
+ Description
+   Initializes a single producer/single consumer queue at the beginning of
+   the block of memory
+ Notes
+   As with ES_InitQueue, the header takes the first element of the block.
+   An SPSC queue must only ever be used with ES_EnQueueSPSC, ES_DeQueueSPSC
+   and the other SPSC functions.
+****************************************************************************/
+uint8_t ES_InitSPSCQueue( ES_Event * pBlock, uint8_t BlockSize )
+{
+   pSPSCQueue_t pThisQueue;
+   uint8_t QueueSize = BlockSize - 1;
+
+   if ( (BlockSize < 2) || (QueueSize > MAX_SPSC_QUEUE_SIZE) ||
+        ((QueueSize & (QueueSize - 1)) != 0) )
+      return(0);
+
+   pThisQueue = (pSPSCQueue_t)pBlock;
+   pThisQueue->Mask = QueueSize - 1;
+   pThisQueue->Head = 0;
+   pThisQueue->Tail = 0;
+   return(QueueSize);
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueueSPSC
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event Event2Add : event to be added to the Queue
+ Returns
+   bool : true if the add was successful, false if not
+ Description
+   if it will fit, adds Event2Add to the Queue without turning interrupts
+   off
+ Notes
+   Only one producer (a single ISR, or only task level code) may call this
+   for a given queue. The event is written before Head is advanced, so the
+   consumer never sees a half written entry.
+****************************************************************************/
+bool ES_EnQueueSPSC( ES_Event * pBlock, ES_Event Event2Add )
+{
+   pSPSCQueue_t pThisQueue;
+   uint8_t Head;
+
+   pThisQueue = (pSPSCQueue_t)pBlock;
+   Head = pThisQueue->Head;
+   if ( (uint8_t)(Head - pThisQueue->Tail) > pThisQueue->Mask )
+      return(false); // full
+
+   pBlock[ 1 + (Head & pThisQueue->Mask) ] = Event2Add;
+   ES_MemoryBarrier(); // the entry must be in place before it is published
+   pThisQueue->Head = Head + 1;
+   return(true);
+}
+
+/****************************************************************************
+ Function
+   ES_DeQueueSPSC
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event * pReturnEvent : used to return the event pulled from the queue
+ Returns
+   The number of entries remaining in the Queue
+ Description
+   pulls next available entry from Queue, ES_NO_EVENT if Queue was empty and
+   copies it to *pReturnEvent.
+ Notes
+   Only the one consumer (ES_Run) may call this for a given queue.
+****************************************************************************/
+uint8_t ES_DeQueueSPSC( ES_Event * pBlock, ES_Event * pReturnEvent )
+{
+   pSPSCQueue_t pThisQueue;
+   uint8_t Tail;
+
+   pThisQueue = (pSPSCQueue_t)pBlock;
+   Tail = pThisQueue->Tail;
+   if ( pThisQueue->Head == Tail )
+   {  // no items in the queue
+      (*pReturnEvent).EventType = ES_NO_EVENT;
+      (*pReturnEvent).EventParam = 0;
+      return(0);
+   }
+   ES_MemoryBarrier(); // read the entry only after seeing Head move past it
+   *pReturnEvent = pBlock[ 1 + (Tail & pThisQueue->Mask) ];
+   ES_MemoryBarrier(); // and finish reading it before handing the slot back
+   Tail++;
+   pThisQueue->Tail = Tail;
+   return((uint8_t)(pThisQueue->Head - Tail));
+}
+
+/****************************************************************************
+ Function
+   ES_IsSPSCQueueEmpty
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   bool : true if Queue is empty
+ Description
+   see above
+ Notes
+
+****************************************************************************/
+bool ES_IsSPSCQueueEmpty( ES_Event * pBlock )
+{
+   pSPSCQueue_t pThisQueue;
+
+   pThisQueue = (pSPSCQueue_t)pBlock;
+   return(pThisQueue->Head == pThisQueue->Tail);
+}
+
+/****************************************************************************
+ Function
+   ES_SPSCQueueNumEntries
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   uint8_t : the number of events currently in the Queue
+ Description
+   see above
+ Notes
+
+****************************************************************************/
+uint8_t ES_SPSCQueueNumEntries( ES_Event * pBlock )
+{
+   pSPSCQueue_t pThisQueue;
+
+   pThisQueue = (pSPSCQueue_t)pBlock;
+   return((uint8_t)(pThisQueue->Head - pThisQueue->Tail));
+}
+
 #if 0
 /****************************************************************************
  Function
@@ -253,6 +557,7 @@ void main(void){
   ES_InitQueue( TestQueue, ARRAY_SIZE(TestQueue) );
   MyEvent.EventType = 0;
   MyEvent.EventParam = 1;
+  MyEvent.Buffer = ES_NO_BUFFER;
   bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
   bReturn +=1; // keep that sily optimizer away
   
@@ -304,6 +609,127 @@ void main(void){
     ;
 }
 
+#endif
+
+#ifdef SPSC_TEST
+/****************************************************************************
+ Host stress test for the SPSC queue. One thread per queue stands in for an
+ ISR and posts a numbered sequence of events as fast as it can, while main()
+ plays ES_Run and drains all of the queues, checking that every event
+ arrives exactly once and in order. Build with
+   gcc -std=gnu99 -O2 -Dhost -DSPSC_TEST -IHost -IHeaders
+       Source/ES_Queue.c -lpthread
+****************************************************************************/
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "ES_General.h"
+
+#define SPSC_TEST_PRODUCERS 3
+#define SPSC_TEST_EVENTS    1000000UL
+
+static ES_Event SPSCTestQueues[SPSC_TEST_PRODUCERS][8+1];
+static uint32_t ProducerFull[SPSC_TEST_PRODUCERS];
+
+// the SPSC queue never masks interrupts, so nothing should call these
+uint32_t CPUgetPRIMASK_cpsid(void)
+{
+  return 0;
+}
+
+void CPUsetPRIMASK(uint32_t newPRIMASK)
+{
+  (void)newPRIMASK;
+}
+
+static void *Producer( void *pArg )
+{
+  uintptr_t Which = (uintptr_t)pArg;
+  ES_Event MyEvent;
+  uint32_t Sent = 0;
+
+  MyEvent.EventType = (ES_EventTyp_t)(ES_NO_EVENT + 1);
+  MyEvent.Buffer = ES_NO_BUFFER;
+  while ( Sent < SPSC_TEST_EVENTS )
+  {
+    MyEvent.EventParam = (uint16_t)Sent;
+    if ( ES_EnQueueSPSC( SPSCTestQueues[Which], MyEvent ) )
+    {
+      Sent++;
+      // vary the interleaving with the consumer now and then
+      if ( (Sent & 0x3ff) == 0 )
+        sched_yield();
+    }
+    else
+    {  // give the consumer a chance if we share a CPU with it
+      ProducerFull[Which]++;
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+int main(void)
+{
+  pthread_t Threads[SPSC_TEST_PRODUCERS];
+  uint32_t Received[SPSC_TEST_PRODUCERS] = { 0 };
+  uint32_t Errors = 0;
+  uint32_t Done = 0;
+  bool GotOne;
+  ES_Event MyEvent;
+  uintptr_t i;
+
+  for ( i = 0; i < SPSC_TEST_PRODUCERS; i++ )
+  {
+    if ( ES_InitSPSCQueue( SPSCTestQueues[i], ARRAY_SIZE(SPSCTestQueues[i]) )
+         == 0 )
+    {
+      printf("ES_InitSPSCQueue failed\n");
+      return 1;
+    }
+    pthread_create( &Threads[i], NULL, Producer, (void *)i );
+  }
+
+  while ( Done < SPSC_TEST_PRODUCERS )
+  {
+    Done = 0;
+    GotOne = false;
+    for ( i = 0; i < SPSC_TEST_PRODUCERS; i++ )
+    {
+      if ( Received[i] == SPSC_TEST_EVENTS )
+      {
+        Done++;
+        continue;
+      }
+      if ( ES_IsSPSCQueueEmpty( SPSCTestQueues[i] ) )
+        continue;
+      ES_DeQueueSPSC( SPSCTestQueues[i], &MyEvent );
+      GotOne = true;
+      if ( (MyEvent.EventType != (ES_EventTyp_t)(ES_NO_EVENT + 1)) ||
+           (MyEvent.EventParam != (uint16_t)Received[i]) )
+      {
+        if ( Errors++ < 10 )
+          printf("queue %u: expected %u, got %u\n", (unsigned)i,
+                 (unsigned)(uint16_t)Received[i],
+                 (unsigned)MyEvent.EventParam);
+      }
+      Received[i]++;
+    }
+    if ( !GotOne )
+      sched_yield();
+  }
+
+  for ( i = 0; i < SPSC_TEST_PRODUCERS; i++ )
+  {
+    pthread_join( Threads[i], NULL );
+    printf("queue %u: %lu events, producer found it full %lu times\n",
+           (unsigned)i, (unsigned long)Received[i],
+           (unsigned long)ProducerFull[i]);
+  }
+  printf("%s: %lu errors\n", (Errors == 0) ? "PASS" : "FAIL",
+         (unsigned long)Errors);
+  return (Errors == 0) ? 0 : 1;
+}
 #endif
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
@@ -21,6 +21,7 @@
  -------------- ---     --------
  10/11/15 10:30 jec     first pass
  10/11/15 18:10 jec     converted to post events to the framework
+ 10/17/26               the interrupts are recorded in the trace
  
 ****************************************************************************/
 // the common headers for I/O, C99 types 
@@ -134,6 +135,7 @@ void ES_ShortTimerStart( uint32_t Which, uint16_t TimeoutValue){
 void ShortTimerAHandler(void){
   ES_Event ThisEvent;
 
+  ES_TraceISR(INT_TIMER5A);
 // start by clearing the source of the interrupt
     TimerIntClear(TIMER5_BASE, TIMER_TIMA_TIMEOUT);
 #ifdef DEBUG
@@ -154,6 +156,7 @@ void ShortTimerAHandler(void){
 void ShortTimerBHandler(void){
   ES_Event ThisEvent;
 
+  ES_TraceISR(INT_TIMER5B);
 // start by clearing the source of the interrupt
     TimerIntClear(TIMER5_BASE, TIMER_TIMB_TIMEOUT);
 #ifdef DEBUG
@@ -3,16 +3,34 @@
      ES_Timers.c
 
  Description
-     This is a module implementing  8 16 bit timers all using the RTI
+     This is a module implementing 64 32 bit timers all using the RTI
      timebase
 
  Notes
      Everything is done in terms of RTI Ticks, which can change from
      application to application.
+     Rather than counting every active timer down on every tick, each active
+     timer holds the tick count at which it expires (its deadline) and sits
+     in a list sorted by deadline. A tick only has to look at the head of the
+     list, and since a restarted timer nearly always has the latest deadline
+     (e.g. a timeout restarted on every byte) the search for its place in
+     the list starts from the tail.
+     A timer counts from the latest tick, including any that have occurred
+     but not been responded to yet (_HW_GetPendingTicks), so that one
+     started by the interrupt that ends a tickless sleep isn't charged for
+     the ticks slept through.
 
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                timers count from the latest tick, not the latest
+                         one responded to
+ 10/17/26                expiries are recorded in the trace (ES_TRACE_SIZE)
+ 10/17/26                the response functions come from ES_TIMER_LIST
+ 10/17/26                added ES_Timer_GetTicksToNextTimeout for tickless
+                         idle
+ 10/17/26                replaced the 16 count-down timers with 64 timers in
+                         a deadline sorted list, durations now 32 bits
  10/27/14 14:02 jec      moved ticking of 'time' to ES_Port to allow it to tick
                          even while blocking. required change to ES_GetTime too
  10/20/13 10:48 jec      moved definition of BITS_PER_BYTE to ES_General.h
@@ -53,62 +71,51 @@
 /*--------------------------- External Variables --------------------------*/
 
 /*----------------------------- Module Defines ----------------------------*/
+// marks the end of the active list
+#define NO_TIMER 0xFF
 
-/*------------------------------ Module Types -----------------------------*/
+// the response function of a timer that is not in ES_TIMER_LIST
+#define TIMER_UNUSED ((pPostFunc)0)
 
-/*
-   the size of Tflag sets the number of timers, uint8 = 8, uint16 = 16 ...)
-   to add more timers, you will need to change the data type and modify
-   the initialization of TMR_TimerArray and TMR_MaskArray
-*/
+// an entry of Timer2PostFunc
+#define ES_TIMER_RESP_FUNC(Name, RespFunc) RespFunc,
 
-typedef uint16_t Tflag_t;
+/*------------------------------ Module Types -----------------------------*/
 
-typedef uint16_t Timer_t; // sets size of timers to 16 bits
+typedef uint32_t Timer_t; // sets size of timers to 32 bits
 
+typedef struct {
+    Timer_t Deadline;   // tick count at which an active timer expires
+    Timer_t Remaining;  // ticks left on a stopped timer
+    uint8_t Next;       // neighbours in the active list
+    uint8_t Prev;
+    bool IsActive;
+}ES_TimerDesc_t;
 
 /*---------------------------- Module Functions ---------------------------*/
+static void InsertActive(uint8_t Num);
+static void RemoveActive(uint8_t Num);
+static Timer_t CurrentTick(void);
 
 /*---------------------------- Module Variables ---------------------------*/
-static Timer_t TMR_TimerArray[sizeof(Tflag_t)*BITS_PER_BYTE]=
-                                            { 0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0, 
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0,
-                                              0x0 };
-
-static Tflag_t TMR_ActiveFlags;
-
-static pPostFunc const Timer2PostFunc[sizeof(Tflag_t)*BITS_PER_BYTE] = 
-                                            { TIMER0_RESP_FUNC,
-                                              TIMER1_RESP_FUNC,
-                                              TIMER2_RESP_FUNC,
-                                              TIMER3_RESP_FUNC,
-                                              TIMER4_RESP_FUNC,
-                                              TIMER5_RESP_FUNC,
-                                              TIMER6_RESP_FUNC,
-                                              TIMER7_RESP_FUNC, 
-                                              TIMER8_RESP_FUNC,
-                                              TIMER9_RESP_FUNC,
-                                              TIMER10_RESP_FUNC,
-                                              TIMER11_RESP_FUNC,
-                                              TIMER12_RESP_FUNC,
-                                              TIMER13_RESP_FUNC,
-                                              TIMER14_RESP_FUNC,
-                                              TIMER15_RESP_FUNC
-                                              };
-  
+static ES_TimerDesc_t TMR_Timers[ES_NUM_TIMERS];
+
+// the active timers, soonest deadline first
+static uint8_t TMR_Head = NO_TIMER;
+static uint8_t TMR_Tail = NO_TIMER;
+
+// ticks since ES_Timer_Init, the time base for the deadlines
+static Timer_t TMR_Ticks;
+
+// the response functions, in the order of ES_TIMER_LIST. The timers that are
+// not listed are left as TIMER_UNUSED
+static pPostFunc const Timer2PostFunc[ES_NUM_TIMERS] =
+                                  { ES_TIMER_LIST(ES_TIMER_RESP_FUNC) };
+
+// a compile time check that ES_TIMER_LIST fits in ES_NUM_TIMERS, the size
+// going negative if it does not
+typedef char ES_TimerListCheck_t[(ES_NUM_LISTED_TIMERS <= ES_NUM_TIMERS) ?
+                                 1 : -1];
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -138,26 +145,31 @@ void ES_Timer_Init(TimerRate_t Rate)
      ES_Timer_SetTimer
  Parameters
      unsigned char Num, the number of the timer to set.
-     unsigned int NewTime, the new time to set on that timer
+     uint32_t NewTime, the new time to set on that timer
  Returns
      ES_Timer_ERR if requested timer does not exist or has no service 
      ES_Timer_OK  otherwise
  Description
      sets the time for a timer, but does not make it active.
  Notes
-     None.
+     If the timer is running, it is stopped.
  Author
      J. Edward Carryer, 02/24/97 17:11
 ****************************************************************************/
-ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime)
+ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime)
 {
    /* tried to set a timer that doesn't exist */
-   if( (Num >= ARRAY_SIZE(TMR_TimerArray)) ||
+   if( (Num >= ARRAY_SIZE(TMR_Timers)) ||
    /* tried to set a timer without a service */
        (Timer2PostFunc[Num] == TIMER_UNUSED) ||
-       (NewTime == 0) ) /* no time being set */
+       (NewTime == 0) || /* no time being set */
+       (NewTime > ES_TIMER_MAX_TIME) )
       return ES_Timer_ERR;  
-   TMR_TimerArray[Num] = NewTime;
+   EnterCritical();
+   if ( TMR_Timers[Num].IsActive )
+      RemoveActive(Num);
+   TMR_Timers[Num].Remaining = NewTime;
+   ExitCritical();
    return ES_Timer_OK;
 }
 
@@ -169,8 +181,7 @@ ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime)
  Returns
      ES_Timer_ERR for error ES_Timer_OK for success
  Description
-     simply sets the active flag in TMR_ActiveFlags to (re)start a
-     stopped timer.
+     (re)starts a stopped timer with the time that it had left
  Notes
      None.
  Author
@@ -178,13 +189,23 @@ ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime)
 ****************************************************************************/
 ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num)
 {
+   ES_TimerReturn_t ReturnVal = ES_Timer_OK;
+
    /* tried to set a timer that doesn't exist */
-   if( (Num >= ARRAY_SIZE(TMR_TimerArray)) ||
-       /* tried to set a timer with no time on it */
-       (TMR_TimerArray[Num] == 0) )
+   if( Num >= ARRAY_SIZE(TMR_Timers) )
       return ES_Timer_ERR;  
-   TMR_ActiveFlags |= BitNum2SetMask[Num]; /* set timer as active */
-   return ES_Timer_OK;
+   EnterCritical();
+   if ( !TMR_Timers[Num].IsActive ){
+      /* tried to start a timer with no time on it */
+      if ( TMR_Timers[Num].Remaining == 0 )
+         ReturnVal = ES_Timer_ERR;
+      else{
+         TMR_Timers[Num].Deadline = CurrentTick() + TMR_Timers[Num].Remaining;
+         InsertActive(Num); /* set timer as active */
+      }
+   }
+   ExitCritical();
+   return ReturnVal;
 }
 
 /****************************************************************************
@@ -195,8 +216,8 @@ ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num)
  Returns
      ES_Timer_ERR for error (timer doesn't exist) ES_Timer_OK for success.
  Description
-     simply clears the bit in TMR_ActiveFlags associated with this
-     timer. This will cause it to stop counting.
+     takes the timer out of the active list, saving the time it had left so
+     that ES_Timer_StartTimer can resume it.
  Notes
      None.
  Author
@@ -204,9 +225,14 @@ ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num)
 ****************************************************************************/
 ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num)
 {
-   if( Num >= ARRAY_SIZE(TMR_TimerArray) )
+   if( Num >= ARRAY_SIZE(TMR_Timers) )
       return ES_Timer_ERR;  /* tried to set a timer that doesn't exist */
-   TMR_ActiveFlags &= BitNum2ClrMask[Num]; /* set timer as inactive */
+   EnterCritical();
+   if ( TMR_Timers[Num].IsActive ){
+      TMR_Timers[Num].Remaining = TMR_Timers[Num].Deadline - CurrentTick();
+      RemoveActive(Num); /* set timer as inactive */
+   }
+   ExitCritical();
    return ES_Timer_OK;
 }
 
@@ -215,28 +241,33 @@ ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num)
      ES_Timer_InitTimer
  Parameters
      unsigned char Num, the number of the timer to start
-     unsigned int NewTime, the number of ticks to be counted
+     uint32_t NewTime, the number of ticks to be counted
  Returns
      ES_Timer_ERR if the requested timer does not exist, ES_Timer_OK otherwise.
  Description
      sets the NewTime into the chosen timer and sets the timer active to 
      begin counting.
  Notes
-     None.
+     May be called from an interrupt response routine.
  Author
      J. Edward Carryer, 02/24/97 14:51
 ****************************************************************************/
-ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint16_t NewTime)
+ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime)
 {
    /* tried to set a timer that doesn't exist */
-   if( (Num >= ARRAY_SIZE(TMR_TimerArray)) ||
+   if( (Num >= ARRAY_SIZE(TMR_Timers)) ||
    /* tried to set a timer without a service */
        (Timer2PostFunc[Num] == TIMER_UNUSED) ||
        /* tried to set a timer without putting any time on it */
-       (NewTime == 0) )
+       (NewTime == 0) || (NewTime > ES_TIMER_MAX_TIME) )
       return ES_Timer_ERR;  
-   TMR_TimerArray[Num] = NewTime;
-   TMR_ActiveFlags |= BitNum2SetMask[Num]; /* set timer as active */
+   EnterCritical();
+   if ( TMR_Timers[Num].IsActive )
+      RemoveActive(Num);
+   TMR_Timers[Num].Remaining = NewTime;
+   TMR_Timers[Num].Deadline = CurrentTick() + NewTime;
+   InsertActive(Num); /* set timer as active */
+   ExitCritical();
    return ES_Timer_OK;
 }
 
@@ -262,6 +293,30 @@ uint16_t ES_Timer_GetTime(void)
    return (_HW_GetTickCount());
 }
 
+/****************************************************************************
+ Function
+     ES_Timer_GetTicksToNextTimeout
+ Parameters
+     None.
+ Returns
+     uint32_t, the number of ticks until the next timer times out, 0 if one
+     already has, ES_TIMER_MAX_TIME if no timer is running
+ Description
+     lets the tickless idle in ES_Port.c know how long it may sleep
+ Notes
+     Call with interrupts off and with all of the ticks that have occurred
+     already passed to ES_Timer_Tick_Resp.
+****************************************************************************/
+uint32_t ES_Timer_GetTicksToNextTimeout(void)
+{
+   int32_t Ticks;
+
+   if ( TMR_Head == NO_TIMER )
+      return ES_TIMER_MAX_TIME;
+   Ticks = (int32_t)(TMR_Timers[TMR_Head].Deadline - TMR_Ticks);
+   return (Ticks > 0) ? (uint32_t)Ticks : 0;
+}
+
 /****************************************************************************
  Function
      ES_Timer_Tick_Resp
@@ -271,45 +326,95 @@ uint16_t ES_Timer_GetTime(void)
      None.
  Description
      This is the new Tick response routine to support the timer module.
-     It will increment time, to maintain the functionality of the
-     GetTime() timer and it will check through the active timers,
-     decrementing each active timers count, if the count goes to 0, it
-     will post an event to the corresponding SM and clear the active flag to
-     prevent further counting.
+     It advances the timer time base and, for each timer whose deadline
+     has come, posts an ES_TIMEOUT event to the corresponding SM and takes
+     it out of the active list.
  Notes
      Called from _Timer_Int_Resp in ES_Port.c.
+     Only the head of the active list is looked at, so a tick on which no
+     timer expires costs the same however many timers are running.
  Author
      J. Edward Carryer, 02/24/97 15:06
 ****************************************************************************/
 void ES_Timer_Tick_Resp(void)
 {
-	static Tflag_t NeedsProcessing;
 	static uint8_t NextTimer2Process;
 	static ES_Event NewEvent;
 
-	if (TMR_ActiveFlags != 0) /* if !=0 , then at least 1 timer is active */
+	TMR_Ticks++;
+	for(;;)
 	{
-		// start by getting a list of all the active timers
-		NeedsProcessing = TMR_ActiveFlags;
-		do{
-			// find the MSB that is set
-			NextTimer2Process = ES_GetMSBitSet(NeedsProcessing);
-			/* decrement that timer, check if timed out */
-			if(--TMR_TimerArray[NextTimer2Process] == 0)
-			{
-				NewEvent.EventType = ES_TIMEOUT;
-				NewEvent.EventParam = NextTimer2Process;
-				/* post the timeout event to the right Service */
-				Timer2PostFunc[NextTimer2Process](NewEvent);
-				/* and stop counting */
-				TMR_ActiveFlags &= BitNum2ClrMask[NextTimer2Process];
-			}
-			// mark off the active timer that we just processed
-			NeedsProcessing &= BitNum2ClrMask[NextTimer2Process];
-		}while(NeedsProcessing != 0);
-      
+		EnterCritical();
+		NextTimer2Process = TMR_Head;
+		/* stop at the first timer that has not timed out */
+		if ((NextTimer2Process == NO_TIMER) ||
+		    ((int32_t)(TMR_Timers[NextTimer2Process].Deadline - TMR_Ticks) > 0))
+		{
+			ExitCritical();
+			break;
+		}
+		/* stop counting */
+		TMR_Timers[NextTimer2Process].Remaining = 0;
+		RemoveActive(NextTimer2Process);
+		ExitCritical();
+		ES_TRACE( ES_TRACE_TIMER, NextTimer2Process, 0 );
+
+		NewEvent.EventType = ES_TIMEOUT;
+		NewEvent.EventParam = NextTimer2Process;
+		/* post the timeout event to the right Service */
+		Timer2PostFunc[NextTimer2Process](NewEvent);
 	}
 }
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+// puts a timer with its Deadline set into the active list. Call with
+// interrupts off
+static void InsertActive(uint8_t Num)
+{
+   uint8_t Before = TMR_Tail;
+
+   // walk back from the tail to the last timer that expires no later
+   while ( (Before != NO_TIMER) &&
+           ((int32_t)(TMR_Timers[Before].Deadline -
+                      TMR_Timers[Num].Deadline) > 0) )
+      Before = TMR_Timers[Before].Prev;
+
+   TMR_Timers[Num].Prev = Before;
+   if ( Before == NO_TIMER ){
+      TMR_Timers[Num].Next = TMR_Head;
+      TMR_Head = Num;
+   }else{
+      TMR_Timers[Num].Next = TMR_Timers[Before].Next;
+      TMR_Timers[Before].Next = Num;
+   }
+   if ( TMR_Timers[Num].Next == NO_TIMER )
+      TMR_Tail = Num;
+   else
+      TMR_Timers[TMR_Timers[Num].Next].Prev = Num;
+   TMR_Timers[Num].IsActive = true;
+}
+
+// takes an active timer out of the active list. Call with interrupts off
+static void RemoveActive(uint8_t Num)
+{
+   if ( TMR_Timers[Num].Prev == NO_TIMER )
+      TMR_Head = TMR_Timers[Num].Next;
+   else
+      TMR_Timers[TMR_Timers[Num].Prev].Next = TMR_Timers[Num].Next;
+   if ( TMR_Timers[Num].Next == NO_TIMER )
+      TMR_Tail = TMR_Timers[Num].Prev;
+   else
+      TMR_Timers[TMR_Timers[Num].Next].Prev = TMR_Timers[Num].Prev;
+   TMR_Timers[Num].IsActive = false;
+}
+
+// the tick that a timer started now counts from
+static Timer_t CurrentTick(void)
+{
+   return TMR_Ticks + _HW_GetPendingTicks();
+}
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
 
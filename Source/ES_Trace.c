@@ -0,0 +1,235 @@
+/****************************************************************************
+ Module
+     ES_Trace.c
+
+ Description
+     This is a module implementing a binary trace of what the Events and
+     Services framework does: the posts, the start and end of each run
+     function, interrupt responses, timer expiries and the application's own
+     trace points, each as a fixed size record stamped with the CPU cycle
+     count. The records are kept in RAM and sent to the console as binary
+     frames, for Host/TraceDecoder.c to turn into a timeline.
+
+ Notes
+     Recording takes a few stores with interrupts off, so the trace shows
+     the interleaving of ISRs and run functions without the milliseconds
+     that a printf at 115200 baud would add to them.
+     The records go in a ring of ES_TRACE_SIZE (a power of 2). When it is
+     full the oldest record is overwritten, so that the ring always holds
+     what led up to a failure, and the number that were lost is sent before
+     the next one that goes out.
+     The records go out either a frame at a time while ES_Run is idle
+     (ES_TRACE_DRAIN, see ES_TraceDrain), or all at once when ES_TraceDump
+     is called: from the 'T' key (MapKeys.c), when ES_Run fails (main.c) and
+     from the hard fault handler (ES_Port.c).
+     Each record goes out as a frame of 10 bytes:
+       0xA5, Kind, Id, Data (2 bytes), Time (4 bytes), checksum
+     with the words least significant byte first and the checksum being 0xFF
+     minus the 8 bit sum of the 8 bytes between. Time is the cycle count
+     (_HW_GetCycleCount) when the record was made.
+     ES_TraceRecord may be called from interrupt responses.
+     With ES_TRACE_INPUTS the trace is a recording for HostSim to replay, so
+     it has to be complete from the start: instead of the oldest record
+     being overwritten the newest is dropped, and the number dropped goes
+     out after the records that were kept.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                ES_TRACE_INPUTS keeps the oldest records
+ 10/17/26                started coding
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_General.h"
+#include "ES_Port.h"
+#include "ES_Trace.h"
+
+#ifdef ES_TRACE_SIZE
+
+/*--------------------------- External Variables --------------------------*/
+
+/*----------------------------- Module Defines ----------------------------*/
+#if (ES_TRACE_SIZE < 2) || ((ES_TRACE_SIZE & (ES_TRACE_SIZE - 1)) != 0)
+#error ES_TRACE_SIZE must be a power of 2
+#endif
+
+#define TRACE_FRAME_START 0xA5
+
+/*------------------------------ Module Types -----------------------------*/
+typedef struct {
+  uint32_t Time;        // _HW_GetCycleCount when it was recorded
+  uint8_t Kind;         // ES_TraceKind_t
+  uint8_t Id;
+  uint16_t Data;
+} TraceRecord_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+static bool TakeRecord( TraceRecord_t *pRecord );
+static void SendRecord( const TraceRecord_t *pRecord );
+static uint8_t SendBytes( uint32_t Word, uint8_t Sum, uint8_t NumBytes );
+
+/*---------------------------- Module Variables ---------------------------*/
+static TraceRecord_t Trace[ES_TRACE_SIZE];
+
+// the number of records ever made, and ever taken out of the ring. The
+// difference is the number waiting, and the low bits index the ring
+static uint32_t Head;
+static uint32_t Tail;
+static uint16_t Lost;   // overwritten since the last record that went out
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_TraceRecord
+ Parameters
+   ES_TraceKind_t : what happened
+   uint8_t : the service, interrupt, timer or trace point it happened to
+   uint16_t : more about it, see ES_TraceKind_t
+ Returns
+   None
+ Description
+   adds a record to the trace, overwriting the oldest one if the ring is
+   full (with ES_TRACE_INPUTS, dropping this one instead)
+ Notes
+   normally called through ES_TRACE, ES_TraceISR or ES_TracePoint. The
+   cycle count is taken with interrupts off so that the records are in the
+   order of their times
+****************************************************************************/
+void ES_TraceRecord( ES_TraceKind_t Kind, uint8_t Id, uint16_t Data )
+{
+  uint32_t SavedPRIMASK;
+  TraceRecord_t *pRecord;
+
+  // not EnterCritical, as this is called from inside other critical regions
+  SavedPRIMASK = CPUgetPRIMASK_cpsid();
+#ifdef ES_TRACE_INPUTS
+  if ( (Head - Tail) >= ES_TRACE_SIZE ){
+    if ( Lost != 0xFFFF )
+      Lost++;
+    CPUsetPRIMASK( SavedPRIMASK );
+    return;
+  }
+#endif
+  pRecord = &Trace[Head & (ES_TRACE_SIZE - 1)];
+  pRecord->Time = _HW_GetCycleCount();
+  pRecord->Kind = Kind;
+  pRecord->Id = Id;
+  pRecord->Data = Data;
+  Head++;
+  if ( (Head - Tail) > ES_TRACE_SIZE ){
+    Tail++; // that one was just overwritten
+    if ( Lost != 0xFFFF )
+      Lost++;
+  }
+  CPUsetPRIMASK( SavedPRIMASK );
+}
+
+/****************************************************************************
+ Function
+   ES_TraceDrain
+ Parameters
+   None
+ Returns
+   bool : true if there are records still waiting to go out
+ Description
+   sends the oldest waiting record, if the console has sent everything it
+   was given before. The frame then fits in the UART's FIFO, so this never
+   waits for the console
+ Notes
+   called by ES_Run each time round its idle loop when ES_TRACE_DRAIN is
+   defined
+****************************************************************************/
+bool ES_TraceDrain( void )
+{
+  TraceRecord_t Record;
+
+  if ( Head == Tail )
+    return Lost != 0;
+  if ( TERMIO_TxEmpty() == 0 )
+    return true;
+  if ( TakeRecord( &Record ) )
+    SendRecord( &Record );
+  return (Head != Tail) || (Lost != 0);
+}
+
+/****************************************************************************
+ Function
+   ES_TraceDump
+ Parameters
+   None
+ Returns
+   None
+ Description
+   sends every record that is waiting, oldest first, waiting for the
+   console as it goes
+ Notes
+   safe to call from a fault handler: records made while it runs go out as
+   well, and it stops once the ring has been emptied
+****************************************************************************/
+void ES_TraceDump( void )
+{
+  TraceRecord_t Record;
+
+  while ( TakeRecord( &Record ) )
+    SendRecord( &Record );
+}
+
+/*---------------------------- Private Functions --------------------------*/
+// takes the next record to send out of the ring, or makes one saying how
+// many were lost before it (with ES_TRACE_INPUTS, after all of the ring).
+// Returns false if there is nothing to send
+static bool TakeRecord( TraceRecord_t *pRecord )
+{
+  uint32_t SavedPRIMASK;
+  bool ReturnVal = true;
+
+  SavedPRIMASK = CPUgetPRIMASK_cpsid();
+#ifdef ES_TRACE_INPUTS
+  if ( (Lost != 0) && (Head == Tail) ){
+#else
+  if ( Lost != 0 ){
+#endif
+    pRecord->Time = _HW_GetCycleCount();
+    pRecord->Kind = ES_TRACE_LOST;
+    pRecord->Id = 0;
+    pRecord->Data = Lost;
+    Lost = 0;
+  }else if ( Head != Tail ){
+    *pRecord = Trace[Tail & (ES_TRACE_SIZE - 1)];
+    Tail++;
+  }else{
+    ReturnVal = false;
+  }
+  CPUsetPRIMASK( SavedPRIMASK );
+  return ReturnVal;
+}
+
+static void SendRecord( const TraceRecord_t *pRecord )
+{
+  uint8_t Sum;
+
+  TERMIO_PutChar(TRACE_FRAME_START);
+  Sum = SendBytes( pRecord->Kind, 0, 1 );
+  Sum = SendBytes( pRecord->Id, Sum, 1 );
+  Sum = SendBytes( pRecord->Data, Sum, 2 );
+  Sum = SendBytes( pRecord->Time, Sum, 4 );
+  TERMIO_PutChar(0xFF - Sum);
+}
+
+// sends the low NumBytes bytes of a word, least significant first, and
+// returns Sum with them added in
+static uint8_t SendBytes( uint32_t Word, uint8_t Sum, uint8_t NumBytes )
+{
+  while ( NumBytes-- > 0 ){
+    TERMIO_PutChar( (uint8_t)Word );
+    Sum += (uint8_t)Word;
+    Word >>= 8;
+  }
+  return Sum;
+}
+
+#endif /* ES_TRACE_SIZE */
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
@@ -13,6 +13,9 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26                T key to send out the event trace
+ 10/17/26                M key for the memory pool statistics
+ 10/17/26                I, B & R keys for the framework service statistics
  02/06/14 14:44 jec      tweaked to be a more generic key-mapper
  02/07/12 00:00 jec      converted to service for use with E&S Gen2
  02/20/07 21:37 jec      converted to use enumerated type for events
@@ -134,6 +137,31 @@ ES_Event RunMapKeys( ES_Event ThisEvent )
 						case 'P' :
 							printf("PWM TEST \n\r");
 							ActivateDirectionSpeed(200, 100);
+						break;
+#ifdef ES_SERVICE_STATS
+						
+						case 'I' :
+							ES_PrintServiceStats();
+						break;
+						
+						case 'B' :
+							ES_DumpServiceStats();
+						break;
+						
+						case 'R' :
+							ES_ResetServiceStats();
+						break;
+#endif
+						
+						case 'M' :
+							ES_PoolPrintStats();
+						break;
+#ifdef ES_TRACE_SIZE
+						
+						case 'T' :
+							ES_TraceDump();
+						break;
+#endif
         }
     
     }
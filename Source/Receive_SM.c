@@ -8,6 +8,10 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26               has Comm_Service switch the XBee to XBEE_BAUD once
+                        UART4 is up, RECEIVE_TIMER's length is set in UART.c
+ 10/17/26               removed GetDataPacket, the frames come in packet
+                        buffers (UART.c)
  05/13/2017			SC
 ****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
@@ -21,8 +25,6 @@
 
 /*----------------------------- Module Defines ----------------------------*/
 
-#define RECEIVE_TIMER_LENGTH 10 // based off of 9600 baud rate (each character takes ~1.04ms to send)
-
 //#define MAX_FRAME_LENGTH 40 // max number of bytes we expect to receive for any data type 
 
 #define RECEIVE_TEST_PRINTS
@@ -136,6 +138,11 @@ ES_Event RunReceive_SM( ES_Event ThisEvent )
 						InitUART();
 
 						SetUARTState();
+						
+						// now the XBee can be switched to the link's rate
+						ES_Event NewEvent;
+						NewEvent.EventType = ES_SET_XBEE_BAUD;
+						PostComm_Service(NewEvent);
 					
             // set current state to Wait4Start 
             CurrentState = RunReceive;
@@ -286,22 +293,3 @@ ES_Event RunReceive_SM( ES_Event ThisEvent )
   return ReturnEvent;
 }
 
-
-/****************************************************************************
- Function
-    GetMessage
-
- Parameters
-   none
-
- Returns
-   pointer to array that has data packet received from Xbee
-
- Author
-   Sarah Cabreros
-****************************************************************************/
-/*uint8_t* GetDataPacket(void) {
-	return outgoingDataPacket;
-}
-
-*/
@@ -28,6 +28,7 @@
 #include "inc/hw_sysctl.h"
 #include "inc/hw_timer.h"
 #include "inc/hw_nvic.h"
+#include "inc/hw_ints.h"
 #include "inc/hw_ssi.h"
 
 // the headers to access the TivaWare Library
@@ -146,6 +147,7 @@ void SPI_Init( void ){
      R. MacPherson, 2/18/2017
 ****************************************************************************/
 void SPI_ISR( void ){
+	ES_TraceISR(INT_SSI1);
 	// clear the source of the interrupt
 	//HWREG(SSI0_BASE+SSI_O_ICR) = SSI_ICR_RTIC;
 	// disable interrupts
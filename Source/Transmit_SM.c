@@ -5,9 +5,26 @@
  Description
    Transmit state machine 
 
+ Notes
+   The frame to send comes in a packet buffer (ES_Buffer.c) with the
+   ES_START_XMIT event, and is held until it has been sent
+   With UART_WHOLE_FRAME_TX (UART.h) the first FIFO full of the frame is
+   written here, UART_ISR tops the FIFO up from the rest (RefillTxFIFO) each
+   time it empties, and one ES_FRAME_SENT comes back when it is all out. A
+   single TRANSMIT_TIMER covers the whole frame
+   In API mode 2 (XBEE_API_MODE, UART.h) the bytes after the start delimiter
+   are escaped as they go into the FIFO, so the frame in the buffer is the
+   same in either mode
+   Host/TransmitTest.c checks the bytes that either transmitter puts on the
+   wire, and compares what they cost per frame
+
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26               escapes the frame in API mode 2 (XBEE_API_MODE)
+ 10/17/26               TRANSMIT_TIMER follows the baud rate
+ 10/17/26               whole frame transmit (UART_WHOLE_FRAME_TX)
+ 10/17/26               send from the ES_START_XMIT event's packet buffer
  05/14/2017			SC
 ****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
@@ -27,11 +44,19 @@
 
 #include "Hardware.h"
 #include "Constants.h"
+#include "XBeeParser.h"
 
 /*----------------------------- Module Defines ----------------------------*/
-#define TRANSMIT_TIMER_LENGTH 10 // based off of 9600 baud rate (each character takes ~1.04ms to send)
+// the time for a byte or a frame of Bytes bytes at the current baud rate,
+// with a margin for the tick in progress and any delay in starting
+#define TRANSMIT_MARGIN_MS 9
+#define TRANSMIT_TIMER_LENGTH (UART_BytesToMS(1) + TRANSMIT_MARGIN_MS)
+// in API mode 2 every byte might be escaped, doubling the frame
+#define FRAME_TIMER_LENGTH(Bytes) (UART_BytesToMS((Bytes) * XBEE_API_MODE) + TRANSMIT_MARGIN_MS)
 
-#define MAX_FRAME_LENGTH 40 // max number of bytes we expect to receive for any data type (including frame overhead)
+#if (XBEE_API_MODE == XBEE_API_ESCAPED) && !defined(UART_WHOLE_FRAME_TX)
+#error API mode 2 needs UART_WHOLE_FRAME_TX (UART.h)
+#endif
 
 //#define XMIT_TEST_PRINTS
 
@@ -39,6 +64,7 @@
 /*---------------------------- Module Functions ---------------------------*/
 bool IsLastByte(void);
 static void SendByte(uint8_t DataByte);
+static void FillTxFIFO(void);
 
 /*---------------------------- Module Variables ---------------------------*/
 static TransmitState_t CurrentState;
@@ -46,10 +72,12 @@ static TransmitState_t CurrentState;
 static uint8_t MyPriority;
 
 
+static ES_BufHandle_t SendBuffer = ES_NO_BUFFER; // buffer holding the data packet
 static uint8_t* DataToSend; // pointer to array containing all bytes in data packet
 static uint8_t DataPacketLength = 0;
 static uint8_t index = 0;
 static bool LastByteFlag = 0;
+static bool EscapeSent = false; // the byte at index is to go XORed (API mode 2)
 
 
 /*------------------------------ Module Code ------------------------------*/
@@ -148,18 +176,31 @@ ES_Event RunTransmit_SM( ES_Event ThisEvent )
 
             // clear LastByteFlag
             LastByteFlag = 0;
-
-            // get pointer to array of message
-            DataToSend = GetDataPacket_Tx(); // function from Comm_Service
          }
     break;
 
     case Idle:      
 			// waiting to receive Start_Xmit event from Comm_Service
-			if ( ThisEvent.EventType == ES_START_XMIT ) {
+			if (( ThisEvent.EventType == ES_START_XMIT ) &&
+			    ((DataToSend = ES_BufData(ThisEvent.Buffer)) != NULL)) {
+				// hold on to the buffer until the whole packet is sent
+				ES_BufRetain(ThisEvent.Buffer);
+				SendBuffer = ThisEvent.Buffer;
+				
 				// get length of array 
 				DataPacketLength = ThisEvent.EventParam /*frame length*/ + HEADER_LENGTH + 1 /*checksum bit*/; 
 				
+#ifdef UART_WHOLE_FRAME_TX
+				// the interrupt from the end of the last frame is still pending
+				HWREG(UART4_BASE + UART_O_ICR) = UART_ICR_TXIC;
+				
+				// start the frame off, UART_ISR sends the rest
+				EscapeSent = false;
+				FillTxFIFO();
+				HWREG(UART4_BASE + UART_O_IM) |= UART_IM_TXIM; 
+				ES_Timer_InitTimer(TRANSMIT_TIMER, FRAME_TIMER_LENGTH(DataPacketLength));
+				CurrentState = SendingData;
+#else
 				// send first byte of array 
 				uint8_t CurrentByte = *(DataToSend+index);
 				SendByte(CurrentByte);
@@ -181,16 +222,40 @@ ES_Event RunTransmit_SM( ES_Event ThisEvent )
 				
 				//reset the lastbyte flag
 				LastByteFlag = 0;
+#endif
 			}
 			
     break;
 
 		case SendingData:      
 			if ( ThisEvent.EventType == ES_TIMEOUT && ThisEvent.EventParam == TRANSMIT_TIMER ) {
+#ifdef UART_WHOLE_FRAME_TX
+				// stop UART_ISR reading any more of it
+				HWREG(UART4_BASE + UART_O_IM) &= ~UART_IM_TXIM;
+#endif
+				// give up on the packet
+				ES_BufRelease(SendBuffer);
+				SendBuffer = ES_NO_BUFFER;
+				
+				// set index back to 0
+				index = 0;
+				
 				// go back to Idle
 				CurrentState = Idle;
 			}
 			
+#ifdef UART_WHOLE_FRAME_TX
+			if ( ThisEvent.EventType == ES_FRAME_SENT) { // from UART ISR
+				ES_Timer_StopTimer(TRANSMIT_TIMER);
+				
+				// done with the packet
+				ES_BufRelease(SendBuffer);
+				SendBuffer = ES_NO_BUFFER;
+				index = 0;
+				CurrentState = Idle;
+			}
+#endif
+			
 			if ( ThisEvent.EventType == ES_BYTE_SENT) { // from UART ISR
 				// if index = length of array, we are done sending data
 				if (index == (DataPacketLength)) {
@@ -200,6 +265,10 @@ ES_Event RunTransmit_SM( ES_Event ThisEvent )
 					// set LastByteFlag
 					LastByteFlag = 1;
 
+					// done with the packet
+					ES_BufRelease(SendBuffer);
+					SendBuffer = ES_NO_BUFFER;
+					
 					// set index back to 0
 					index = 0;
 					
@@ -239,6 +308,47 @@ static void SendByte(uint8_t DataByte) {
 	}	
 }
 
+/****************************************************************************
+ Function
+     RefillTxFIFO
+
+ Returns
+     bool, true if the frame had all been written already, so that it is out
+
+ Description
+     Writes as much of the rest of the frame as fits in the TX FIFO
+ Notes
+     called from UART_ISR when the TX FIFO has emptied (UART_WHOLE_FRAME_TX)
+****************************************************************************/
+bool RefillTxFIFO(void) {
+	if (index == DataPacketLength) return true;
+	FillTxFIFO();
+	return false;
+}
+
+// writes the frame from index on into the TX FIFO until it is full
+static void FillTxFIFO(void) {
+	while ((index < DataPacketLength) &&
+	       ((HWREG(UART4_BASE + UART_O_FR) & UART_FR_TXFF) == 0)) {
+		uint8_t CurrentByte = DataToSend[index];
+		
+#if XBEE_API_MODE == XBEE_API_ESCAPED
+		// the escape goes first, in a FIFO slot of its own
+		if ((index != START_BYTE_INDEX) && XBee_NeedsEscape(CurrentByte)) {
+			if (!EscapeSent) {
+				HWREG(UART4_BASE + UART_O_DR) = XBEE_ESCAPE;
+				EscapeSent = true;
+				continue;
+			}
+			CurrentByte ^= XBEE_ESCAPE_XOR;
+			EscapeSent = false;
+		}
+#endif
+		HWREG(UART4_BASE + UART_O_DR) = CurrentByte;
+		index++;
+	}
+}
+
 bool IsLastByte(void) {
 	if (LastByteFlag == 1) return true;
 	else return false;
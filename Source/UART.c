@@ -6,10 +6,36 @@
    UART Initialization and ISR functions
 
  Notes
+   Each frame is received straight into a packet buffer (ES_Buffer.c) that
+   is handed to Comm_Service with the ES_DATAPACKET_RECEIVED event, so a
+   frame that arrives while the last one is being decoded can't overwrite it
+   The RX FIFO is emptied through the frame parser (XBeeParser.c) each time
+   it reaches 8 bytes, and by the receive timeout (32 bit times of quiet
+   with bytes waiting), which also drops a frame that has stopped part way.
+   A frame only needs RECEIVE_TIMER when the FIFO was left empty part way
+   through it, as the receive timeout can't come until another byte does
+   With UART_WHOLE_FRAME_TX (UART.h) the TX FIFO is topped up from the
+   frame that Transmit_SM is sending each time it empties
 
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26               frames are taken apart by XBeeParser.c, which also
+                        handles API mode 2 (XBEE_API_MODE) and lengths over
+                        255 bytes
+ 10/17/26               the baud rate is set at run time (UART_SetBaud), and
+                        RECEIVE_TIMER's length follows it
+ 10/17/26               frames dropped for want of a buffer go in the trace
+ 10/17/26               empty the RX FIFO on its level or the receive
+                        timeout, instead of an interrupt and a RECEIVE_TIMER
+                        restart for each byte
+ 10/17/26               whole frame transmit through the TX FIFO
+                        (UART_WHOLE_FRAME_TX)
+ 10/17/26               each byte received goes in the trace, for replay
+                        (ES_TRACE_INPUTS)
+ 10/17/26               the API identifier goes in the trace (ES_TRACE_SIZE)
+                        instead of being printed from the ISR
+ 10/17/26               receive into ES packet buffers
 05/13/2017			SC	
 ****************************************************************************/
 
@@ -23,6 +49,7 @@
 #include "inc/hw_gpio.h"
 #include "inc/hw_sysctl.h"
 #include "inc/hw_nvic.h"
+#include "inc/hw_ints.h"
 #include "inc/hw_uart.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/pin_map.h"	// Define PART_TM4C123GH6PM in project
@@ -33,30 +60,33 @@
 #include "Transmit_SM.h"
 #include "Receive_SM.h"
 #include "UART.h"
+#include "XBeeParser.h"
 
 /*----------------------------- Module Defines ----------------------------*/
 // UART7 Rx: PE0
 // UART7 Tx: PE1
-#define RECEIVE_TIMER_LENGTH 10 // based off of 9600 baud rate (each character takes ~1.04ms to send)
+// the bytes that can come after the FIFO level interrupt (7) and the
+// receive timeout after them (32 bit times), so that a frame that ends in
+// the FIFO is never cut off by RECEIVE_TIMER
+#define RX_TIMEOUT_BYTES 11
+// for the tick in progress and the interrupt latency
+#define TIMEOUT_MARGIN_MS 8
+#define BITS_PER_CHAR 10 // 8N1
 
 /*---------------------------- Module Variables ---------------------------*/
 static uint8_t DataByte; 
-static UARTReceiveState_t CurrentState;
-static uint8_t LocalDataPacket[MAX_PACKET_LENGTH];
-static uint8_t ReadyDataPacket[MAX_PACKET_LENGTH];
-
-static uint8_t MSBLength = 0;
-static uint8_t LSBLength = 0;
-static uint8_t FrameLength = 0; // num bytes in data frame
-static uint8_t BytesLeft = 0;
-static uint8_t RunningSum = 0;
-static uint8_t ArrayIndex_UART = 0;
+static XBeeParser_t Parser;
+static ES_BufHandle_t RxBuffer = ES_NO_BUFFER; // the frame being received
 
 static uint8_t API_Identifier = 0;
+static bool TimerRunning = false; // RECEIVE_TIMER is waiting on a frame
+static uint32_t CurrentBaud = XBEE_DEFAULT_BAUD;
+static uint32_t ReceiveTimerLength; // ms, for CurrentBaud
 
 /*---------------------------- Module Function ---------------------------*/
 static void ProcessByte(uint8_t DataByte);
-static void CopyDataPacket(void);
+static ES_BufHandle_t DropFrame(void);
+static void SetDivisor(uint32_t Baud);
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -99,23 +129,28 @@ void InitUART(void) {
 	// 8. Disable UART (clear UARTEN bit in UARTCTL)
 	HWREG(UART4_BASE + UART_O_CTL) &= ~UART_CTL_UARTEN;
 	
-	// 9. Write integer portion of BRD to UARTIBRD (Baud rate 9600, Integer = 260, Fraction = 27)
-	HWREG(UART4_BASE + UART_O_IBRD) = 0x0104;
-
-	// 10. Write fractional portion of BRD to UARTFBRD
-	HWREG(UART4_BASE + UART_O_FBRD) = 0x1B;
+	// 9. & 10. Write the integer and fractional portions of BRD to UARTIBRD
+	// and UARTFBRD, for the rate that the XBee starts at
+	SetDivisor(XBEE_DEFAULT_BAUD);
 	
 	// 11. Write desired serial parameters to UARTLCRH
 	HWREG(UART4_BASE + UART_O_LCRH) |= (BIT5HI | BIT6HI); // 8-bit word length, all other bits zero
 	
+	// FIFOs on, RX interrupt at 8 bytes (the receive timeout gets the rest)
+	HWREG(UART4_BASE + UART_O_LCRH) |= UART_LCRH_FEN;
+	HWREG(UART4_BASE + UART_O_IFLS) = UART_IFLS_RX4_8 | UART_IFLS_TX1_8;
+	
 	// 12. Configure UART operation using UARTCTL register 
 	HWREG(UART4_BASE + UART_O_CTL) |= (UART_CTL_RXE | UART_CTL_TXE | UART_CTL_EOT); // Enable Receive and Transmit
 	
 	// 13. Enable UART by setting UARTEN bit in UARTCTL 
 	HWREG(UART4_BASE + UART_O_CTL) |= UART_CTL_UARTEN;
 
-	// locally enable RX interrupts
-	HWREG(UART4_BASE + UART_O_IM) |= UART_IM_RXIM; 
+	// locally enable RX and receive timeout interrupts
+	HWREG(UART4_BASE + UART_O_IM) |= (UART_IM_RXIM | UART_IM_RTIM); 
+	
+	// the frames get their buffers as they come in (ProcessByte)
+	XBeeParser_Init(&Parser, XBEE_API_MODE, NULL, 0);
 	
 	// set NVIC enable for UART4 (interrupt #60)
 	HWREG(NVIC_EN1) |= BIT28HI;
@@ -131,43 +166,55 @@ void InitUART(void) {
      UART_ISR
 
  Description
-     Responds to RXIM or TXIM interrupts
+     Responds to RXIM, RTIM or TXIM interrupts
 
  Author
      Sarah Cabreros
 ****************************************************************************/
 
  void UART_ISR(void) {
-	//printf("isr \r\n");
-	// read UARTMIS
-    // if RXMIS set:
- 	if ((HWREG(UART4_BASE+UART_O_MIS) & UART_MIS_RXMIS) == UART_MIS_RXMIS) {
-		//printf("r \r\n");
-		// save new data byte
-		DataByte = HWREG(UART4_BASE + UART_O_DR); 
-
-		// clear interrupt flag (set RXIC in UARTICR)
-		HWREG(UART4_BASE + UART_O_ICR) |= UART_ICR_RXIC;
-
-		/*
-		// post ByteReceived event to Receive_SM (event param is byte in UARTDR) 
-		ES_Event ThisEvent;
-		ThisEvent.EventType = ES_BYTE_RECEIVED;
-		ThisEvent.EventParam = DataByte;
-		PostReceive_SM(ThisEvent);*/
+	uint32_t Status;
+	
+	ES_TraceISR(INT_UART4);
+	Status = HWREG(UART4_BASE+UART_O_MIS);
+	
+	// if RXMIS or RTMIS set, take everything that is in the RX FIFO
+	if ((Status & (UART_MIS_RXMIS | UART_MIS_RTMIS)) != 0) {
+		HWREG(UART4_BASE + UART_O_ICR) = UART_ICR_RXIC | UART_ICR_RTIC;
+		while ((HWREG(UART4_BASE + UART_O_FR) & UART_FR_RXFE) == 0) {
+			DataByte = HWREG(UART4_BASE + UART_O_DR); 
+			ES_TraceInput(INT_UART4, DataByte);
+			ProcessByte(DataByte);
+		}
 		
-		ProcessByte(DataByte);
+		if ((Status & UART_MIS_RTMIS) != 0) {
+			// the line has gone quiet, so a frame still open has been cut short
+			ES_BufRelease(DropFrame());
+		} else if (XBeeParser_InFrame(&Parser)) {
+			// the rest of the frame is still to come, and if it doesn't the
+			// receive timeout can't tell, with nothing left in the FIFO
+			ES_Timer_InitTimer(RECEIVE_TIMER, ReceiveTimerLength);
+			TimerRunning = true;
+		}
+		if (!XBeeParser_InFrame(&Parser) && TimerRunning) {
+			ES_Timer_StopTimer(RECEIVE_TIMER);
+			TimerRunning = false;
+		}
+	}
+	
+	// else if TXMIS set, the TX FIFO has emptied
+	else if ((Status & UART_MIS_TXMIS) == UART_MIS_TXMIS) {
+		HWREG(UART4_BASE + UART_O_ICR) = UART_ICR_TXIC;
 		
- 	}
-
-	// else if TXMIS set (FIFO open): // where do we enable TXIM interrupts??? 
-	else if ((HWREG(UART4_BASE+UART_O_MIS) & UART_MIS_TXMIS) == UART_MIS_TXMIS) {
-		//printf("t \r\n");
-	// should get this interrupt for all bytes AFTER the start byte (0x7E) 
-		//printf("TXMIS INTERRUPT \n\r");
-		// clear interrupt flag 
-		HWREG(UART4_BASE + UART_O_ICR) |= UART_ICR_TXIC;
-
+#ifdef UART_WHOLE_FRAME_TX
+		// top it up from the frame, or say that the frame is out
+		if (RefillTxFIFO()) {
+			HWREG(UART4_BASE + UART_O_IM) &= ~UART_IM_TXIM;
+			ES_Event ThisEvent;
+			ThisEvent.EventType = ES_FRAME_SENT;
+			PostTransmit_SM(ThisEvent);
+		}
+#else
 		// post ByteSent event 
 		ES_Event ThisEvent;
 		ThisEvent.EventType = ES_BYTE_SENT;
@@ -178,135 +225,123 @@ void InitUART(void) {
 			// disable TXIM 
 			HWREG(UART4_BASE + UART_O_IM) &= ~UART_IM_TXIM;
 		}
-		
+#endif
 	}
 }
 
+// runs a byte through the frame parser, giving each frame a packet buffer
+// of its own as soon as its length is in
 static void ProcessByte(uint8_t DataByte) {
+	uint16_t FrameLength;
 	
-	switch (CurrentState) {
-	case Wait4Start: 
-				
-				// check if byte received is 0x7E 
-				if ( DataByte == START_DELIMITER ) {
-					//printf("-R- \r\n");
-					//printf("start byte received\r\n");
-					// start timer 
-					ES_Timer_InitTimer(RECEIVE_TIMER, RECEIVE_TIMER_LENGTH);
-					
-					// set current state to Wait4MSB
-					CurrentState = Wait4MSBLength;
-				}
-      
-    break;
-
-		case Wait4MSBLength:      
-			
-				// store MSB in data packet 
-				MSBLength = DataByte; 
-				// start receive timer
-				ES_Timer_InitTimer(RECEIVE_TIMER, RECEIVE_TIMER_LENGTH);
-				// set current state to Wait4LSB
-				CurrentState = Wait4LSBLength;
-			
-		
-    break;
+	switch (XBeeParser_Byte(&Parser, DataByte)) {
+	case XBEE_PARSE_LENGTH:
+		FrameLength = XBeeParser_Length(&Parser);
 		
-		case Wait4LSBLength: 
-
-				// store LSB in data packet 
-				LSBLength = DataByte; 
-				
-				// update FrameLength and BytesLeft
-				FrameLength = MSBLength + LSBLength;
-				BytesLeft = FrameLength;
-				
-				// start receive timer
-				ES_Timer_InitTimer(RECEIVE_TIMER, RECEIVE_TIMER_LENGTH);
-				
-				// set ArrayIndex to 0 
-				ArrayIndex_UART = 0;
-				
-				// initialize runningsum to 0
-				RunningSum = 0;
-				
-				// set current state to ReceivingData
-				CurrentState = ReceivingData;
-				
-      
-    break;
+		// the frame before it may have been cut short by this one's start
+		ES_BufRelease(RxBuffer);
+		RxBuffer = ES_NO_BUFFER;
 		
-		case ReceivingData: 
-
-				// if BytesLeft = 0, then we just received the checksum 
-				if (BytesLeft == 0) {
-
-					if (DataByte == (0xFF - RunningSum)) {
-						//printf("Checksum is good: ReceiveSM");
-						
-						/*
-						uint8_t Header = LocalPacket[INDEX];
-						if (Header == ENCRY) {
-							CopyDataPacketToEncryptionArray();
-						} else {
-							CopyDataPacket();
-						}
-						
-						
-						*/
-						// copy local data packet into ready data packet
-						//CopyDataPacket();
-						
-						// if good checksum, post PacketReceived event to FARMER_SM
-						ES_Event ThisEvent;         
-						ThisEvent.EventType = ES_DATAPACKET_RECEIVED;
-						ThisEvent.EventParam = FrameLength; 
-						PostComm_Service(ThisEvent);
-						//printf("event posted \n\r");
-					} else {
-						// if bad checksum, don't do anything
-					}
-					
-					// go back to Wait4Start
-					CurrentState = Wait4Start;
-				} else {
-
-					// else if BytesLeft > 0, then we're still receiving data bytes
-					// store current data byte 
-					//uint8_t CurrentByte = DataByte;
-					
-					// add byte to DataPacket
-					LocalDataPacket[ArrayIndex_UART] = DataByte;
-					
-					if (ArrayIndex_UART == 0) {
-						API_Identifier = DataByte;
-						printf("API_Ident: %i \n\r", API_Identifier);
-					}
-								//printf("%i: %i\r\n", ArrayIndex, DataByte);
-					//printf("LDP: %i \n\r", LocalDataPacket[0]);
-					//}
-					// increment ArrayIndex
-					ArrayIndex_UART++;
-					
-					// update check sum
-					RunningSum += DataByte;
-					
-					// decrement Bytes left 
-					BytesLeft--;
-					
-					//printf("bytes left: %i\r\n", BytesLeft);
-					
-					// start receive timer 
-					ES_Timer_InitTimer(RECEIVE_TIMER, RECEIVE_TIMER_LENGTH);
-				
-			}
-      
-    break;
+		// get a buffer to receive the frame into, if the frame is too long or
+		// there are none left (the frames before it are all still in use),
+		// the parser skips the frame
+		if (FrameLength != 0) {
+			RxBuffer = ES_BufAlloc(FrameLength);
 		}
+		if (RxBuffer == ES_NO_BUFFER) {
+			ES_TracePoint(TRACE_RX_DROPPED, FrameLength);
+			XBeeParser_SetBuffer(&Parser, NULL, 0);
+		} else {
+			XBeeParser_SetBuffer(&Parser, ES_BufData(RxBuffer), FrameLength);
+		}
+		break;
+	
+	case XBEE_PARSE_FRAME: {
+		ES_Event ThisEvent;
+		
+		API_Identifier = ES_BufData(RxBuffer)[API_IDENT_BYTE_INDEX_RX];
+#ifdef ES_TRACE_SIZE
+		ES_TracePoint(TRACE_API_IDENT, API_Identifier);
+#else
+		printf("API_Ident: %i \n\r", API_Identifier);
+#endif
+		// good checksum, post PacketReceived event to Comm_Service
+		ThisEvent.EventType = ES_DATAPACKET_RECEIVED;
+		ThisEvent.EventParam = XBeeParser_Length(&Parser);
+		ES_PostWithBuffer(PostComm_Service, ThisEvent, RxBuffer);
+		
+		// the queued event holds its own reference to the buffer
+		ES_BufRelease(RxBuffer);
+		RxBuffer = ES_NO_BUFFER;
+		break;
+	}
+	
+	case XBEE_PARSE_BAD_CHECKSUM:
+	case XBEE_PARSE_RESYNC:
+		// if bad checksum, or the frame was cut short, don't do anything
+		ES_BufRelease(RxBuffer);
+		RxBuffer = ES_NO_BUFFER;
+		break;
+	
+	default:
+		break;
+	}
 }
 
-uint8_t* GetDataPacket (void) {
-	return &LocalDataPacket[0];
+/****************************************************************************
+ Function
+     UART_SetBaud
+
+ Parameters
+     uint32_t : the new baud rate
+
+ Description
+     Changes UART4 to the new baud rate, with the divisors worked out from
+     the system clock
+ Notes
+     call with nothing being sent or received, whatever is part way through
+     is lost. The XBee has to be switched as well (Comm_Service)
+****************************************************************************/
+void UART_SetBaud(uint32_t Baud) {
+	HWREG(UART4_BASE + UART_O_CTL) &= ~UART_CTL_UARTEN;
+	SetDivisor(Baud);
+	// the divisors only take effect on a write to UARTLCRH
+	HWREG(UART4_BASE + UART_O_LCRH) = HWREG(UART4_BASE + UART_O_LCRH);
+	HWREG(UART4_BASE + UART_O_CTL) |= UART_CTL_UARTEN;
+	printf("UART4 at %u baud \r\n", (unsigned)Baud);
+}
+
+uint32_t UART_GetBaud(void) {
+	return CurrentBaud;
+}
+
+/****************************************************************************
+ Function
+     UART_BytesToMS
+
+ Parameters
+     uint16_t : a number of bytes
+
+ Returns
+     uint32_t, the time in ms that they take on the wire at the current
+     rate, rounded up
+
+ Description
+     for the timeouts of anything that waits on UART4
+****************************************************************************/
+uint32_t UART_BytesToMS(uint16_t NumBytes) {
+	return ((uint32_t)NumBytes * BITS_PER_CHAR * MS_PER_S + CurrentBaud - 1) / CurrentBaud;
+}
+
+// sets UARTIBRD and UARTFBRD for Baud, and the timeouts that depend on it
+static void SetDivisor(uint32_t Baud) {
+	// BRD = clock / (16 * Baud), in 64ths (the fractional part), rounded
+	uint32_t Divisor = (SysCtlClockGet() * 4 + Baud / 2) / Baud;
+	
+	HWREG(UART4_BASE + UART_O_IBRD) = Divisor >> 6;
+	HWREG(UART4_BASE + UART_O_FBRD) = Divisor & 0x3F;
+	CurrentBaud = Baud;
+	ReceiveTimerLength = UART_BytesToMS(RX_TIMEOUT_BYTES) + TIMEOUT_MARGIN_MS;
 }
 
 uint8_t GetAPIIdentifier(void) {
@@ -314,13 +349,25 @@ uint8_t GetAPIIdentifier(void) {
 }
 
 void SetUARTState(void) {
-	CurrentState = Wait4Start;
-}
-
-static void CopyDataPacket(void) {
-	for (int i = 0; i < MAX_PACKET_LENGTH; i++) {
-		ReadyDataPacket[i] = LocalDataPacket[i];
+	// called on the receive timeout, drop any partly received frame
+	ES_BufHandle_t Dropped = ES_NO_BUFFER;
+	
+	EnterCritical();
+	if (TimerRunning) {
+		Dropped = DropFrame();
+		TimerRunning = false;
 	}
-			printf("LocalDataPacket: %i      ReadyDataPacket: %i \n\r", LocalDataPacket[0], ReadyDataPacket[0]);
+	ExitCritical();
+	// outside of the critical section, ES_BufRelease makes its own
+	ES_BufRelease(Dropped);
+}
 
+// goes back to waiting for a start delimiter, and returns the buffer of the
+// frame that was being received, if there was one, for the caller to release
+static ES_BufHandle_t DropFrame(void) {
+	ES_BufHandle_t Dropped = RxBuffer;
+	
+	RxBuffer = ES_NO_BUFFER;
+	XBeeParser_Reset(&Parser);
+	return Dropped;
 }
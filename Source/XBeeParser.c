@@ -0,0 +1,569 @@
+/****************************************************************************
+ Module
+     XBeeParser.c
+
+ Description
+     This is a module that takes apart XBee API frames (start delimiter,
+     16 bit length, frame data, checksum) a byte at a time, in either of
+     the XBee's API modes.
+
+ Notes
+     All of the state of a parser is in its XBeeParser_t, so a parser may be
+     run from an interrupt response, and one parser per link needs nothing
+     more than another XBeeParser_t.
+     In API mode 2 (escaped) every byte after the start delimiter that is a
+     delimiter, escape, XON or XOFF byte is sent as XBEE_ESCAPE followed by
+     the byte XORed with XBEE_ESCAPE_XOR, so an unescaped start delimiter
+     always starts a frame, and one part way through a frame means that the
+     rest of that frame was lost. The parser drops the frame and starts on
+     the new one.
+     In API mode 1 a start delimiter may be a length, data or checksum byte,
+     so the parser can only find the next frame once it has counted its way
+     to the end of the one that it is in. A frame that has stopped part way
+     has to be dropped by the caller, with XBeeParser_Reset, when the line
+     goes quiet.
+     The length and checksum are checked on the unescaped bytes, the
+     checksum being 0xFF less the low byte of the sum of the frame data.
+     Define XBEE_PARSER_TEST for a host test of both API modes, built with
+       gcc -std=gnu99 -O2 -Dhost -DXBEE_PARSER_TEST -IHost -IHeaders
+           Source/XBeeParser.c
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26                added the XBEE_PARSER_TEST host test
+ 10/17/26                started coding
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stddef.h>
+
+#include "XBeeParser.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// a frame's data and checksum add up to this, in 8 bits
+#define GOOD_CHECKSUM_SUM 0xFF
+
+/*---------------------------- Module Functions ---------------------------*/
+static void StartFrame( XBeeParser_t *pParser );
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   XBeeParser_Init
+ Parameters
+   XBeeParser_t * : the parser
+   uint8_t : the API mode, XBEE_API_UNESCAPED or XBEE_API_ESCAPED
+   uint8_t * : where to put the frame data, may be NULL if every frame is
+     given a buffer of its own when its length is in
+   uint16_t : the size of that buffer
+ Returns
+   None
+ Description
+   sets a parser up to wait for a start delimiter
+****************************************************************************/
+void XBeeParser_Init( XBeeParser_t *pParser, uint8_t Mode,
+                      uint8_t *pBuffer, uint16_t BufferSize )
+{
+  pParser->Mode = Mode;
+  pParser->pBuffer = pBuffer;
+  pParser->BufferSize = ( pBuffer == NULL ) ? 0 : BufferSize;
+  pParser->pFrame = NULL;
+  pParser->Length = 0;
+  XBeeParser_Reset( pParser );
+}
+
+/****************************************************************************
+ Function
+   XBeeParser_SetBuffer
+ Parameters
+   XBeeParser_t * : the parser
+   uint8_t * : where to put the frame data, NULL to skip the frame
+   uint16_t : the size of that buffer
+ Returns
+   None
+ Description
+   changes the buffer that the frame data goes into
+ Notes
+   meant to be called when XBeeParser_Byte returns XBEE_PARSE_LENGTH, so
+   that each frame can go in a buffer of its own size. A frame that doesn't
+   fit the buffer is skipped and XBEE_PARSE_TOO_LONG returned at its end
+****************************************************************************/
+void XBeeParser_SetBuffer( XBeeParser_t *pParser, uint8_t *pBuffer,
+                           uint16_t BufferSize )
+{
+  pParser->pBuffer = pBuffer;
+  pParser->BufferSize = ( pBuffer == NULL ) ? 0 : BufferSize;
+  if ( (pParser->State == XBeeReceivingData) ||
+       (pParser->State == XBeeWait4Checksum) ){
+    pParser->pFrame = ( (pParser->Index == 0) &&
+                        (pParser->Length <= pParser->BufferSize) ) ?
+                      pParser->pBuffer : NULL;
+  }
+}
+
+/****************************************************************************
+ Function
+   XBeeParser_Reset
+ Parameters
+   XBeeParser_t * : the parser
+ Returns
+   None
+ Description
+   drops any frame that is part way through, and goes back to waiting for
+   a start delimiter
+****************************************************************************/
+void XBeeParser_Reset( XBeeParser_t *pParser )
+{
+  pParser->State = XBeeWait4Start;
+  pParser->Escaped = false;
+}
+
+/****************************************************************************
+ Function
+   XBeeParser_Byte
+ Parameters
+   XBeeParser_t * : the parser
+   uint8_t : the next byte from the line
+ Returns
+   XBeeParseResult_t : what the byte finished, if anything
+ Description
+   runs a byte through the parser
+ Notes
+   on XBEE_PARSE_FRAME the frame data is in the buffer, XBeeParser_Length
+   bytes of it, until the next byte is given to the parser
+****************************************************************************/
+XBeeParseResult_t XBeeParser_Byte( XBeeParser_t *pParser, uint8_t Byte )
+{
+  XBeeParseResult_t ReturnVal = XBEE_PARSE_BUSY;
+
+  if ( pParser->Mode == XBEE_API_ESCAPED ){
+    if ( Byte == XBEE_START_DELIMITER ){
+      // always the start of a frame, even part way through another one
+      if ( pParser->State != XBeeWait4Start )
+        ReturnVal = XBEE_PARSE_RESYNC;
+      pParser->State = XBeeWait4MSBLength;
+      pParser->Escaped = false;
+      return ReturnVal;
+    }
+    if ( pParser->State == XBeeWait4Start )
+      return XBEE_PARSE_BUSY;
+    if ( Byte == XBEE_ESCAPE ){
+      pParser->Escaped = true;
+      return XBEE_PARSE_BUSY;
+    }
+    if ( pParser->Escaped ){
+      Byte ^= XBEE_ESCAPE_XOR;
+      pParser->Escaped = false;
+    }
+  }
+
+  switch ( pParser->State ){
+    case XBeeWait4Start:
+      if ( Byte == XBEE_START_DELIMITER )
+        pParser->State = XBeeWait4MSBLength;
+      break;
+
+    case XBeeWait4MSBLength:
+      pParser->Length = (uint16_t)Byte << 8;
+      pParser->State = XBeeWait4LSBLength;
+      break;
+
+    case XBeeWait4LSBLength:
+      pParser->Length |= Byte;
+      StartFrame( pParser );
+      ReturnVal = XBEE_PARSE_LENGTH;
+      break;
+
+    case XBeeReceivingData:
+      if ( pParser->pFrame != NULL )
+        pParser->pFrame[pParser->Index] = Byte;
+      pParser->Index++;
+      pParser->Sum += Byte;
+      if ( pParser->Index == pParser->Length )
+        pParser->State = XBeeWait4Checksum;
+      break;
+
+    case XBeeWait4Checksum:
+      if ( pParser->pFrame == NULL )
+        ReturnVal = XBEE_PARSE_TOO_LONG;
+      else if ( (uint8_t)(pParser->Sum + Byte) == GOOD_CHECKSUM_SUM )
+        ReturnVal = XBEE_PARSE_FRAME;
+      else
+        ReturnVal = XBEE_PARSE_BAD_CHECKSUM;
+      pParser->State = XBeeWait4Start;
+      break;
+  }
+  return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+   XBeeParser_Length
+ Parameters
+   const XBeeParser_t * : the parser
+ Returns
+   uint16_t : the length of the frame data, once XBEE_PARSE_LENGTH has been
+   returned for the frame
+****************************************************************************/
+uint16_t XBeeParser_Length( const XBeeParser_t *pParser )
+{
+  return pParser->Length;
+}
+
+/****************************************************************************
+ Function
+   XBeeParser_InFrame
+ Parameters
+   const XBeeParser_t * : the parser
+ Returns
+   bool : true if a start delimiter has been seen and the frame that it
+   started has not yet ended
+****************************************************************************/
+bool XBeeParser_InFrame( const XBeeParser_t *pParser )
+{
+  return ( pParser->State != XBeeWait4Start );
+}
+
+/****************************************************************************
+ Function
+   XBee_NeedsEscape
+ Parameters
+   uint8_t : a byte of a frame to be sent
+ Returns
+   bool : true if, in API mode 2, the byte has to be sent as XBEE_ESCAPE and
+   the byte XORed with XBEE_ESCAPE_XOR
+ Notes
+   for every byte but the start delimiter that starts the frame
+****************************************************************************/
+bool XBee_NeedsEscape( uint8_t Byte )
+{
+  return ( (Byte == XBEE_START_DELIMITER) || (Byte == XBEE_ESCAPE) ||
+           (Byte == XBEE_XON) || (Byte == XBEE_XOFF) );
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+// the length is in, get ready for the frame data
+static void StartFrame( XBeeParser_t *pParser )
+{
+  pParser->Index = 0;
+  pParser->Sum = 0;
+  pParser->pFrame = ( pParser->Length <= pParser->BufferSize ) ?
+                    pParser->pBuffer : NULL;
+  pParser->State = ( pParser->Length == 0 ) ? XBeeWait4Checksum :
+                   XBeeReceivingData;
+}
+
+#ifdef XBEE_PARSER_TEST
+/****************************************************************************
+ Host test for the parser. Frames are built in both API modes, escaping
+ included, and fed through a parser a byte at a time, checking what it
+ returns and what lands in its buffer. Build with
+   gcc -std=gnu99 -O2 -Dhost -DXBEE_PARSER_TEST -IHost -IHeaders
+       Source/XBeeParser.c
+****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+// room for the longest frame here, every byte escaped
+#define TEST_STREAM_SIZE 1024
+#define TEST_LONG_LENGTH 0x0102
+
+static uint8_t Stream[TEST_STREAM_SIZE];
+static uint8_t Buffer[TEST_LONG_LENGTH];
+static uint8_t OtherBuffer[TEST_LONG_LENGTH];
+static uint8_t Data[TEST_LONG_LENGTH];
+static uint32_t Errors;
+
+static void Check( bool Passed, const char *What )
+{
+  if ( !Passed )
+  {
+    Errors++;
+    printf("FAIL: %s\n", What);
+  }
+}
+
+// puts a byte on the wire, escaping it in API mode 2 if it has to be
+static uint16_t PutByte( uint8_t APIMode, uint8_t Byte, uint16_t Length )
+{
+  if ( (APIMode == XBEE_API_ESCAPED) && XBee_NeedsEscape(Byte) )
+  {
+    Stream[Length++] = XBEE_ESCAPE;
+    Byte ^= XBEE_ESCAPE_XOR;
+  }
+  Stream[Length++] = Byte;
+  return Length;
+}
+
+// builds a frame of the data in Stream, returns the number of wire bytes
+static uint16_t BuildFrame( uint8_t APIMode, const uint8_t *pData,
+                            uint16_t DataLength, uint8_t ChecksumError )
+{
+  uint16_t Length = 0;
+  uint8_t Sum = 0;
+  uint16_t i;
+
+  Stream[Length++] = XBEE_START_DELIMITER;
+  Length = PutByte( APIMode, (uint8_t)(DataLength >> 8), Length );
+  Length = PutByte( APIMode, (uint8_t)DataLength, Length );
+  for ( i = 0; i < DataLength; i++ )
+  {
+    Length = PutByte( APIMode, pData[i], Length );
+    Sum += pData[i];
+  }
+  return PutByte( APIMode, (uint8_t)(0xFF - Sum) ^ ChecksumError, Length );
+}
+
+// counts the escapes in the stream, to check that a test escapes what it
+// means to
+static uint16_t CountEscapes( uint16_t Length )
+{
+  uint16_t Count = 0;
+  uint16_t i;
+
+  for ( i = 0; i < Length; i++ )
+  {
+    if ( Stream[i] == XBEE_ESCAPE )
+      Count++;
+  }
+  return Count;
+}
+
+// feeds the stream to the parser, returning the last result that wasn't
+// XBEE_PARSE_BUSY or XBEE_PARSE_LENGTH
+static XBeeParseResult_t Feed( XBeeParser_t *pParser, uint16_t Length )
+{
+  XBeeParseResult_t LastResult = XBEE_PARSE_BUSY;
+  XBeeParseResult_t Result;
+  uint16_t i;
+
+  for ( i = 0; i < Length; i++ )
+  {
+    Result = XBeeParser_Byte( pParser, Stream[i] );
+    if ( (Result != XBEE_PARSE_BUSY) && (Result != XBEE_PARSE_LENGTH) )
+      LastResult = Result;
+  }
+  return LastResult;
+}
+
+static bool GotFrame( XBeeParser_t *pParser, XBeeParseResult_t Result,
+                      const uint8_t *pData, uint16_t DataLength )
+{
+  return ( (Result == XBEE_PARSE_FRAME) &&
+           (XBeeParser_Length(pParser) == DataLength) &&
+           (memcmp( Buffer, pData, DataLength ) == 0) &&
+           !XBeeParser_InFrame(pParser) );
+}
+
+static void TestGoodFrames( uint8_t APIMode )
+{
+  static const uint8_t Command[] = { 0x01, 0x01, 0x21, 0x86, 0x00, 0x00,
+                                     0x01, 0x02, 0x03 };
+  XBeeParser_t Parser;
+  uint16_t Length;
+
+  XBeeParser_Init( &Parser, APIMode, Buffer, sizeof(Buffer) );
+  Length = BuildFrame( APIMode, Command, sizeof(Command), 0 );
+  Check( GotFrame( &Parser, Feed( &Parser, Length ), Command,
+                   sizeof(Command) ), "good frame" );
+  // and again, to see that the parser went back to the start
+  Check( GotFrame( &Parser, Feed( &Parser, Length ), Command,
+                   sizeof(Command) ), "second good frame" );
+}
+
+static void TestEscapes( void )
+{
+  XBeeParser_t Parser;
+  uint16_t Length;
+  uint8_t Sum = 0;
+  uint16_t i;
+
+  // 0x13 bytes of data so that the LSB of the length is escaped, with every
+  // special byte in the data, and the last byte chosen to make the
+  // checksum a start delimiter
+  for ( i = 0; i < XBEE_XOFF - 1; i++ )
+  {
+    Data[i] = (uint8_t)((i & 3) == 0 ? XBEE_START_DELIMITER :
+                        (i & 3) == 1 ? XBEE_ESCAPE :
+                        (i & 3) == 2 ? XBEE_XON : XBEE_XOFF);
+    Sum += Data[i];
+  }
+  Data[i] = (uint8_t)(0xFF - XBEE_START_DELIMITER - Sum);
+
+  XBeeParser_Init( &Parser, XBEE_API_ESCAPED, Buffer, sizeof(Buffer) );
+  Length = BuildFrame( XBEE_API_ESCAPED, Data, XBEE_XOFF, 0 );
+  Check( (Stream[Length - 2] == XBEE_ESCAPE) &&
+         (Stream[Length - 1] ==
+          (XBEE_START_DELIMITER ^ XBEE_ESCAPE_XOR)), "checksum escaped" );
+  // the LSB of the length, all of the data but the last byte, the checksum
+  Check( CountEscapes( Length ) == 1 + XBEE_XOFF - 1 + 1,
+         "escapes in the stream" );
+  Check( GotFrame( &Parser, Feed( &Parser, Length ), Data, XBEE_XOFF ),
+         "escaped frame" );
+
+  // in API mode 1 the same bytes go unescaped, and parse the same
+  XBeeParser_Init( &Parser, XBEE_API_UNESCAPED, Buffer, sizeof(Buffer) );
+  Length = BuildFrame( XBEE_API_UNESCAPED, Data, XBEE_XOFF, 0 );
+  Check( GotFrame( &Parser, Feed( &Parser, Length ), Data, XBEE_XOFF ),
+         "unescaped special bytes" );
+}
+
+static void TestLongLength( uint8_t APIMode )
+{
+  XBeeParser_t Parser;
+  uint16_t Length;
+  uint16_t i;
+
+  for ( i = 0; i < TEST_LONG_LENGTH; i++ )
+    Data[i] = (uint8_t)(i * 7);
+  XBeeParser_Init( &Parser, APIMode, Buffer, sizeof(Buffer) );
+  Length = BuildFrame( APIMode, Data, TEST_LONG_LENGTH, 0 );
+  Check( (Stream[1] == (TEST_LONG_LENGTH >> 8)) &&
+         (Stream[2] == (TEST_LONG_LENGTH & 0xFF)), "MSB of the length" );
+  Check( GotFrame( &Parser, Feed( &Parser, Length ), Data,
+                   TEST_LONG_LENGTH ), "frame with an MSB length" );
+}
+
+static void TestBadChecksum( uint8_t APIMode )
+{
+  static const uint8_t Status[] = { 0x89, 0x01, 0x00 };
+  XBeeParser_t Parser;
+  uint16_t Length;
+
+  XBeeParser_Init( &Parser, APIMode, Buffer, sizeof(Buffer) );
+  Length = BuildFrame( APIMode, Status, sizeof(Status), 0x01 );
+  Check( Feed( &Parser, Length ) == XBEE_PARSE_BAD_CHECKSUM,
+         "bad checksum" );
+  Length = BuildFrame( APIMode, Status, sizeof(Status), 0 );
+  Check( GotFrame( &Parser, Feed( &Parser, Length ), Status,
+                   sizeof(Status) ), "good frame after a bad checksum" );
+}
+
+static void TestResync( void )
+{
+  static const uint8_t Status[] = { 0x89, 0x01, 0x00 };
+  XBeeParser_t Parser;
+  XBeeParseResult_t Result = XBEE_PARSE_BUSY;
+  uint16_t Length;
+  uint16_t i;
+
+  XBeeParser_Init( &Parser, XBEE_API_ESCAPED, Buffer, sizeof(Buffer) );
+  // the start of a frame that stops after a byte of its data
+  Length = BuildFrame( XBEE_API_ESCAPED, Status, sizeof(Status), 0 );
+  Check( Feed( &Parser, 4 ) == XBEE_PARSE_BUSY, "cut short frame" );
+  Check( XBeeParser_InFrame(&Parser), "in the cut short frame" );
+  Result = XBeeParser_Byte( &Parser, Stream[0] );
+  Check( Result == XBEE_PARSE_RESYNC, "stray start delimiter" );
+  for ( i = 1; i < Length; i++ )
+    Result = XBeeParser_Byte( &Parser, Stream[i] );
+  Check( GotFrame( &Parser, Result, Status, sizeof(Status) ),
+         "frame after a resync" );
+}
+
+static void TestTooLong( uint8_t APIMode )
+{
+  static const uint8_t Command[] = { 0x01, 0x01, 0x21, 0x86, 0x00, 0x00,
+                                     0x01, 0x02, 0x03 };
+  static const uint8_t Status[] = { 0x89, 0x01, 0x00 };
+  XBeeParser_t Parser;
+  XBeeParseResult_t Result = XBEE_PARSE_BUSY;
+  uint16_t Length;
+  uint16_t i;
+
+  memset( Buffer, 0, sizeof(Buffer) );
+  XBeeParser_Init( &Parser, APIMode, Buffer, sizeof(Status) );
+  Length = BuildFrame( APIMode, Command, sizeof(Command), 0 );
+  Check( Feed( &Parser, Length ) == XBEE_PARSE_TOO_LONG, "too long" );
+  Check( Buffer[0] == 0, "too long frame left the buffer alone" );
+  Length = BuildFrame( APIMode, Status, sizeof(Status), 0 );
+  Check( GotFrame( &Parser, Feed( &Parser, Length ), Status,
+                   sizeof(Status) ), "frame that fits after one too long" );
+
+  // skip a frame by taking its buffer away when its length comes in
+  memset( Buffer, 0, sizeof(Buffer) );
+  XBeeParser_Init( &Parser, APIMode, Buffer, sizeof(Buffer) );
+  Length = BuildFrame( APIMode, Command, sizeof(Command), 0 );
+  for ( i = 0; i < Length; i++ )
+  {
+    Result = XBeeParser_Byte( &Parser, Stream[i] );
+    if ( Result == XBEE_PARSE_LENGTH )
+      XBeeParser_SetBuffer( &Parser, NULL, 0 );
+  }
+  Check( Result == XBEE_PARSE_TOO_LONG, "skipped frame" );
+  Check( Buffer[0] == 0, "skipped frame left the buffer alone" );
+  // and give the next one a buffer of its own size
+  for ( i = 0; i < Length; i++ )
+  {
+    Result = XBeeParser_Byte( &Parser, Stream[i] );
+    if ( Result == XBEE_PARSE_LENGTH )
+      XBeeParser_SetBuffer( &Parser, Buffer, XBeeParser_Length(&Parser) );
+  }
+  Check( GotFrame( &Parser, Result, Command, sizeof(Command) ),
+         "frame given a buffer at its length" );
+}
+
+static void TestInterleaved( void )
+{
+  static const uint8_t Command[] = { 0x01, 0x01, 0x21, 0x86, 0x7E, 0x7D,
+                                     0x11, 0x13, 0x03 };
+  static uint8_t OtherStream[TEST_STREAM_SIZE];
+  XBeeParser_t Parser;
+  XBeeParser_t OtherParser;
+  XBeeParseResult_t Result = XBEE_PARSE_BUSY;
+  XBeeParseResult_t OtherResult = XBEE_PARSE_BUSY;
+  uint16_t Length;
+  uint16_t OtherLength;
+  uint16_t i;
+  uint8_t Pass;
+
+  for ( i = 0; i < TEST_LONG_LENGTH; i++ )
+    Data[i] = (uint8_t)(0xFF - i);
+  OtherLength = BuildFrame( XBEE_API_UNESCAPED, Data, TEST_LONG_LENGTH, 0 );
+  memcpy( OtherStream, Stream, OtherLength );
+  Length = BuildFrame( XBEE_API_ESCAPED, Command, sizeof(Command), 0 );
+
+  XBeeParser_Init( &Parser, XBEE_API_ESCAPED, Buffer, sizeof(Buffer) );
+  XBeeParser_Init( &OtherParser, XBEE_API_UNESCAPED, OtherBuffer,
+                   sizeof(OtherBuffer) );
+  // a byte to each in turn, the short frame over and over
+  for ( i = 0, Pass = 0; i < OtherLength; i++ )
+  {
+    OtherResult = XBeeParser_Byte( &OtherParser, OtherStream[i] );
+    Result = XBeeParser_Byte( &Parser, Stream[i % Length] );
+    if ( (i % Length) == (uint16_t)(Length - 1) )
+    {
+      Check( GotFrame( &Parser, Result, Command, sizeof(Command) ),
+             "interleaved escaped frame" );
+      Pass++;
+    }
+  }
+  Check( Pass > 1, "interleaved passes" );
+  Check( (OtherResult == XBEE_PARSE_FRAME) &&
+         (XBeeParser_Length(&OtherParser) == TEST_LONG_LENGTH) &&
+         (memcmp( OtherBuffer, Data, TEST_LONG_LENGTH ) == 0),
+         "interleaved unescaped frame" );
+}
+
+int main(void)
+{
+  TestGoodFrames( XBEE_API_UNESCAPED );
+  TestGoodFrames( XBEE_API_ESCAPED );
+  TestEscapes();
+  TestLongLength( XBEE_API_UNESCAPED );
+  TestLongLength( XBEE_API_ESCAPED );
+  TestBadChecksum( XBEE_API_UNESCAPED );
+  TestBadChecksum( XBEE_API_ESCAPED );
+  TestResync();
+  TestTooLong( XBEE_API_UNESCAPED );
+  TestTooLong( XBEE_API_ESCAPED );
+  TestInterleaved();
+
+  printf("%s: %lu errors\n", (Errors == 0) ? "PASS" : "FAIL",
+         (unsigned long)Errors);
+  return (Errors == 0) ? 0 : 1;
+}
+#endif
@@ -40,6 +40,12 @@ int main(void)
 	printf("D: Send a DOG ACK \n\r");
 	printf("S: Unpair & Stop Hovering \n\r");
 	printf("P: PWM TEST \n\r");
+#ifdef ES_SERVICE_STATS
+	printf("I: Service stats, B: binary dump, R: reset stats \n\r");
+#endif
+#ifdef ES_TRACE_SIZE
+	printf("T: Event trace (binary, for TraceDecoder) \n\r");
+#endif
 	printf("---------------------------------------------------------------\n\r");
 	printf("\n\r");
 
@@ -53,6 +59,9 @@ int main(void)
 
 	}
 	//if we got to here, there was an error
+#ifdef ES_TRACE_SIZE
+	ES_TraceDump(); // what led up to it
+#endif
 	switch (ErrorType){
 	  case FailedPost:
 	    printf("Failed on attempt to Post\n");
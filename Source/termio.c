@@ -70,6 +70,14 @@ int kbhit(void) {
 		return 0;
 }
 
+int TERMIO_TxEmpty(void) {
+	/* checks that the transmit FIFO is empty */
+	if(HWREG(UART_BASE + UART_O_FR) & UART_FR_TXFE)
+		return 1;
+	else
+		return 0;
+}
+
 #if defined(ccs)
 
 #include <file.h>